@@ -0,0 +1,28 @@
+# Prints the size of the injector library and the example application and fails
+# when either exceeds its budget. Invoked by the size_report target:
+#
+#   cmake -DLIBRARY_FILE=... -DLIBRARY_BUDGET_KB=... -DAPP_FILE=... -DAPP_BUDGET_KB=...
+#         -P SizeReport.cmake
+#
+# A budget of 0 only reports the size.
+
+function(check_artifact_size label file budget_kb)
+  if (NOT EXISTS "${file}")
+    message(WARNING "${label}: ${file} does not exist, build it first")
+    return()
+  endif()
+  file(SIZE "${file}" _bytes)
+  math(EXPR _kb "(${_bytes} + 1023) / 1024")
+  if (budget_kb GREATER 0)
+    message(STATUS "${label}: ${_kb} KiB (budget ${budget_kb} KiB) ${file}")
+    if (_kb GREATER budget_kb)
+      math(EXPR _excess "${_kb} - ${budget_kb}")
+      message(SEND_ERROR "${label} exceeds its size budget by ${_excess} KiB")
+    endif()
+  else()
+    message(STATUS "${label}: ${_kb} KiB ${file}")
+  endif()
+endfunction()
+
+check_artifact_size("library" "${LIBRARY_FILE}" "${LIBRARY_BUDGET_KB}")
+check_artifact_size("application" "${APP_FILE}" "${APP_BUDGET_KB}")
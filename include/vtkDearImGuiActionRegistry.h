@@ -0,0 +1,98 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vtkDearImGuiTextIndex.h>
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+// Named actions shown in the main menu bar and in a command palette, with keyboard
+// shortcuts.
+//
+// Paths like "Tools/Outliner" give the menu an action sits in. Shortcuts like
+// "Ctrl+Shift+P" are parsed once into a map from key chords to actions, so a key press
+// costs one lookup whatever the number of actions. The palette matches queries as
+// subsequences of the paths (see vtkDearImGuiTextIndex) and lists the best matches.
+//
+// The injector owns one registry, see vtkDearImGuiInjector::AddAction().
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiActionRegistry : public vtkObject
+{
+public:
+  static vtkDearImGuiActionRegistry* New();
+  vtkTypeMacro(vtkDearImGuiActionRegistry, vtkObject);
+
+  struct Action
+  {
+    std::string Path;
+    std::string Shortcut;
+    std::function<void()> Callback;
+    std::function<bool()> Checked; // shows a check mark when set
+  };
+
+  // Add or replace the action at path. shortcut is a '+' separated list of Ctrl, Shift
+  // and Alt followed by a VTK key sym, e.g. "Ctrl+Shift+P" or "F5". Returns false if
+  // the shortcut is taken by another action, the action is added without it then.
+  bool AddAction(const char* path, std::function<void()> callback,
+    const char* shortcut = nullptr, std::function<bool()> checked = nullptr);
+  // An action flipping *value, checked while it is true.
+  bool AddToggle(const char* path, bool* value, const char* shortcut = nullptr);
+  bool RemoveAction(const char* path);
+
+  int GetNumberOfActions() const { return static_cast<int>(this->Actions.size()); }
+  const Action& GetAction(int index) const { return this->Actions[index]; }
+  // Run the action at path. Returns false if there is none.
+  bool Trigger(const char* path);
+  // Run the action bound to a key press. Returns false if there is none.
+  bool TriggerShortcut(const char* keySym, bool control, bool shift, bool alt);
+
+  // Indices of the actions matching query, best first.
+  void Find(const char* query, std::vector<int>& indices, int maximum = 50);
+
+  // ImGui main menu bar with every action, in the order they were added.
+  void DrawMenuBar();
+  // Command palette, opened by OpenPalette().
+  void OpenPalette() { this->PaletteRequested = true; }
+  void DrawPalette();
+
+protected:
+  vtkDearImGuiActionRegistry();
+  ~vtkDearImGuiActionRegistry() override;
+
+  struct Menu
+  {
+    std::string Label;
+    int Action = -1; // leaf when >= 0
+    std::vector<Menu> Items;
+  };
+
+  // Canonical form of a key chord, empty if keySym is empty.
+  static std::string Chord(const char* keySym, bool control, bool shift, bool alt);
+  static std::string ParseShortcut(const char* shortcut);
+  // Refresh the maps from paths and chords to actions.
+  void Invalidate();
+  // Rebuild the menu tree and the search index if the actions changed.
+  void Update();
+  // Index of the action chosen in menu, -1 if none.
+  int DrawMenu(const Menu& menu);
+
+  std::vector<Action> Actions;
+  std::unordered_map<std::string, int> Paths;
+  std::unordered_map<std::string, int> Chords;
+
+  // rebuilt after the actions change
+  bool UpToDate = false;
+  Menu MenuBar;
+  vtkDearImGuiTextIndex Index;
+
+  bool PaletteRequested = false;
+  char Query[128] = "";
+  std::vector<int> Results;
+  int Current = 0;
+
+private:
+  vtkDearImGuiActionRegistry(const vtkDearImGuiActionRegistry&) = delete;
+  void operator=(const vtkDearImGuiActionRegistry&) = delete;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <vtkdearimguiinjector_export.h>
+
+// Heap used by Dear ImGui, installed with ImGui::SetAllocatorFunctions.
+//
+// Blocks up to MaxPooledSize bytes come from per size-class free lists that are
+// refilled in large chunks and never handed back, so once the UI has reached its
+// working set a frame no longer calls into the system heap. Larger blocks go to
+// malloc. In addition, a bump arena provides temporaries for ImGuiDrawEvent
+// observers that live until the next frame begins.
+//
+// ImGui contexts are used from the UI thread only, and so is this class.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiAllocator
+{
+public:
+  // Process wide instance. ImGui's allocator functions are global too.
+  static vtkDearImGuiAllocator* GetInstance();
+  // Install the instance as ImGui's allocator. Must happen before any ImGui context
+  // exists; later calls are ignored.
+  static void Install();
+
+  static const std::size_t MaxPooledSize = 4096;
+
+  void* Allocate(std::size_t size);
+  void Free(void* ptr);
+
+  // Frame memory, valid until the next BeginFrame().
+  void* AllocateFrameMemory(std::size_t size);
+  // printf into frame memory.
+  const char* FormatFrameString(const char* format, ...);
+
+  struct Statistics
+  {
+    unsigned long Allocations = 0;       // Allocate() calls
+    unsigned long Frees = 0;             // Free() calls
+    std::size_t AllocatedBytes = 0;      // bytes requested through Allocate()
+    std::size_t LiveBytes = 0;           // bytes held by ImGui at the end of the frame
+    std::size_t PeakLiveBytes = 0;       // highest LiveBytes during the frame
+    std::size_t FrameBytes = 0;          // frame memory used
+    unsigned long SystemAllocations = 0; // calls into malloc
+  };
+
+  // Close the statistics of the previous frame and recycle frame memory.
+  void BeginFrame();
+  // Statistics of the last completed frame.
+  const Statistics& GetFrameStatistics() const { return this->LastFrame; }
+
+private:
+  vtkDearImGuiAllocator() = default; // never destroyed, ImGui may free at exit
+  vtkDearImGuiAllocator(const vtkDearImGuiAllocator&) = delete;
+  void operator=(const vtkDearImGuiAllocator&) = delete;
+
+  static void* ImGuiAlloc(std::size_t size, void* userData);
+  static void ImGuiFree(void* ptr, void* userData);
+
+  void* SystemAllocate(std::size_t size);
+  void Refill(int sizeClass);
+
+  struct FreeBlock
+  {
+    FreeBlock* Next;
+  };
+
+  static const int NumberOfSizeClasses = 9; // 16 .. 4096 bytes
+  FreeBlock* FreeLists[NumberOfSizeClasses] = {};
+  std::vector<void*> Chunks;
+
+  std::unique_ptr<char[]> Arena;
+  std::size_t ArenaSize = 0;
+  std::size_t ArenaOffset = 0;
+  std::vector<std::unique_ptr<char[]>> ArenaOverflow;
+  std::size_t ArenaOverflowBytes = 0;
+
+  Statistics Current;
+  Statistics LastFrame;
+};
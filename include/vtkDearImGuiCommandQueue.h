@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <vtkdearimguiinjector_export.h>
+
+// Bounded multi-producer, single-consumer queue of closures.
+//
+// Producers claim a cell with a single compare-and-swap on the enqueue position
+// and publish it through a per-cell sequence number (Vyukov's bounded queue), so
+// they never block each other nor the consumer. Push() may be called from any
+// thread, Pop() only from the consumer (UI) thread.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiCommandQueue
+{
+public:
+  using Command = std::function<void()>;
+
+  // capacity is rounded up to a power of two.
+  explicit vtkDearImGuiCommandQueue(std::size_t capacity = 1024);
+  ~vtkDearImGuiCommandQueue();
+
+  // Returns false if the queue is full. Thread safe.
+  bool Push(Command&& command);
+  // Returns false if the queue is empty. Consumer thread only.
+  bool Pop(Command& command);
+
+  std::size_t GetCapacity() const { return this->Mask + 1; }
+
+private:
+  vtkDearImGuiCommandQueue(const vtkDearImGuiCommandQueue&) = delete;
+  void operator=(const vtkDearImGuiCommandQueue&) = delete;
+
+  struct Cell
+  {
+    std::atomic<std::size_t> Sequence;
+    Command Value;
+  };
+
+  std::unique_ptr<Cell[]> Cells;
+  std::size_t Mask = 0;
+  alignas(64) std::atomic<std::size_t> EnqueuePos{ 0 };
+  alignas(64) std::size_t DequeuePos = 0; // consumer only
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+class vtkDataObject;
+
+// Loads datasets on worker threads so the event loop keeps running.
+//
+// Load() streams VTK XML files (.vtp, .vtu, .vti, ...) through their reader piece by
+// piece, every piece is delivered as soon as it is read, so the first ones can be
+// shown while the rest loads. LoadRawVolume() maps a raw volume file into memory,
+// delivers a coarse subsampled image first and then the full volume, whose scalars
+// point into the mapping: nothing is copied and the mapping is released with the
+// array.
+//
+// Results reach the callback on the UI thread through the post function, e.g.
+// vtkDearImGuiInjector::PostCommand(), as references to the data the worker read.
+// Each job runs on its own thread and may be cancelled, Draw() shows progress and
+// throughput. WebAssembly builds without threads run the job in Load(), which calls
+// the callback directly.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiDatasetLoader : public vtkObject
+{
+public:
+  static vtkDearImGuiDatasetLoader* New();
+  vtkTypeMacro(vtkDearImGuiDatasetLoader, vtkObject);
+
+  // Called on the UI thread for each result of job. last is true for the final one.
+  using Callback = std::function<void(int job, vtkDataObject* data, bool last)>;
+  // Runs a closure on the UI thread, returns false if it could not be queued.
+  using PostFunction = std::function<bool(std::function<void()>)>;
+  void SetPostFunction(PostFunction post);
+
+  // Layout of a raw volume file, scalars in native byte order after HeaderSize bytes,
+  // x varying fastest.
+  struct RawVolume
+  {
+    int Dimensions[3] = { 0, 0, 0 };
+    int ScalarType = 0; // VTK_UNSIGNED_CHAR, VTK_SHORT, VTK_FLOAT, ...
+    int NumberOfComponents = 1;
+    double Spacing[3] = { 1., 1., 1. };
+    double Origin[3] = { 0., 0., 0. };
+    std::size_t HeaderSize = 0;
+  };
+
+  // Returns the id of the job, 0 if it could not start.
+  int Load(const char* fileName, Callback callback, int numberOfPieces = 8);
+  int LoadRawVolume(const char* fileName, const RawVolume& layout, Callback callback);
+  void Cancel(int job);
+  void CancelAll();
+
+  enum States
+  {
+    Loading = 0,
+    Done,
+    Cancelled,
+    Failed
+  };
+
+  struct Status
+  {
+    int Job = 0;
+    std::string FileName;
+    int State = Loading;
+    double Progress = 0.; // [0, 1]
+    double BytesRead = 0.;
+    double Seconds = 0.;
+    std::string Error;
+  };
+  std::vector<Status> GetStatus() const;
+  bool IsLoading() const;
+  // Forget finished, cancelled and failed jobs.
+  void ClearFinished();
+
+  // Jobs with progress, throughput and cancel buttons in the current ImGui window.
+  void Draw();
+
+protected:
+  vtkDearImGuiDatasetLoader();
+  ~vtkDearImGuiDatasetLoader() override;
+
+  struct Job;
+  int Start(std::shared_ptr<Job> job);
+
+  PostFunction Post;
+  std::vector<std::shared_ptr<Job>> Jobs;
+  int NextJob = 1;
+
+private:
+  vtkDearImGuiDatasetLoader(const vtkDearImGuiDatasetLoader&) = delete;
+  void operator=(const vtkDearImGuiDatasetLoader&) = delete;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+struct ImDrawData;
+struct ImDrawList;
+
+// Rewrites ImGui draw data into fewer, larger draw calls before it reaches the OpenGL
+// backend.
+//
+// Draw lists are concatenated into a single vertex and index buffer. When the backend
+// can offset base vertices (ImGuiBackendFlags_RendererHasVtxOffset, i.e.
+// glDrawElementsBaseVertex) a single list results. Otherwise indices are rebased and
+// a new list starts every 64k vertices. Adjacent commands are merged when they use
+// the same texture and either share a clip rect or their geometry is not clipped by
+// either rect, in which case the union of both rects is used.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiDrawBatcher : public vtkObject
+{
+public:
+  static vtkDearImGuiDrawBatcher* New();
+  vtkTypeMacro(vtkDearImGuiDrawBatcher, vtkObject);
+
+  // Returns batched draw data owned by this object, valid until the next call.
+  // Callback commands are kept in order, but receive the merged list.
+  ImDrawData* Batch(ImDrawData* drawData, bool hasVtxOffset);
+
+  // Statistics of the last Batch() call.
+  int GetNumberOfInputCommands() const { return this->InputCommands; }
+  int GetNumberOfOutputCommands() const { return this->OutputCommands; }
+  int GetNumberOfInputLists() const { return this->InputLists; }
+  int GetNumberOfOutputLists() const { return this->OutputLists; }
+
+protected:
+  vtkDearImGuiDrawBatcher();
+  ~vtkDearImGuiDrawBatcher() override;
+
+  ImDrawList* NextList();
+
+  std::unique_ptr<ImDrawData> Output;
+  std::vector<std::unique_ptr<ImDrawList>> Lists; // reused across frames
+  std::vector<ImDrawList*> UsedLists;
+  std::vector<float> Bounds; // xmin, ymin, xmax, ymax per output command of a list
+
+  int InputCommands = 0;
+  int OutputCommands = 0;
+  int InputLists = 0;
+  int OutputLists = 0;
+
+private:
+  vtkDearImGuiDrawBatcher(const vtkDearImGuiDrawBatcher&) = delete;
+  void operator=(const vtkDearImGuiDrawBatcher&) = delete;
+};
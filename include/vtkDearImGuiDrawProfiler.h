@@ -0,0 +1,127 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <vtkCommand.h>
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+struct ImDrawData;
+
+// Attributes the cost of a frame to the ImGuiDrawEvent observers and to the windows.
+//
+// The injector times every observer added with AddDrawObserver(), time spent in
+// observers added with plain AddObserver() is reported together as unnamed. Vertices,
+// indices and draw commands of the draw data are counted per top-level window, child
+// windows count for their parent.
+//
+// Statistics cover the last NumberOfFrames frames. OverBudgetEvent fires for every frame
+// an observer exceeds its budget in. An observer whose mean exceeds its budget is
+// flagged, GetObserversOverBudget() lists them.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiDrawProfiler : public vtkObject
+{
+public:
+  static vtkDearImGuiDrawProfiler* New();
+  vtkTypeMacro(vtkDearImGuiDrawProfiler, vtkObject);
+
+  // callData: const char* name of the observer over its budget in this frame.
+  static const unsigned long OverBudgetEvent = vtkCommand::UserEvent + 1;
+
+  // Frames the rolling statistics cover.
+  vtkSetClampMacro(NumberOfFrames, int, 2, 1000);
+  vtkGetMacro(NumberOfFrames, int);
+
+  // Seconds an observer may take per frame, 0 disables the check.
+  vtkSetClampMacro(Budget, double, 0., 1.);
+  vtkGetMacro(Budget, double);
+  // Budget of the observer name only, negative returns it to Budget.
+  void SetObserverBudget(const char* name, double seconds);
+
+  struct Statistics
+  {
+    double Last = 0.;
+    double Mean = 0.;
+    double Maximum = 0.;
+  };
+
+  struct Observer
+  {
+    std::string Name;
+    Statistics Seconds;
+    double Budget = 0.;
+    int FramesOverBudget = 0; // of the rolling frames
+    bool OverBudget = false;  // the mean exceeds the budget
+  };
+
+  struct Window
+  {
+    std::string Name;
+    Statistics Vertices;
+    Statistics Indices;
+    Statistics Commands;
+  };
+
+  // Called by the injector around ImGuiDrawEvent, from its observers in between.
+  void BeginFrame();
+  void AddObserverTime(const char* name, double seconds);
+  void EndFrame(double seconds);
+  // Count the draw data per window, before it is batched.
+  void MeasureDrawData(const ImDrawData* drawData);
+
+  // By name.
+  std::vector<Observer> GetObservers() const;
+  std::vector<Window> GetWindows() const;
+  std::vector<std::string> GetObserversOverBudget() const;
+  // Statistics of the whole ImGuiDrawEvent.
+  Statistics GetDrawEventSeconds() const;
+  void Reset();
+
+  // Observers and windows in the current ImGui window.
+  void Draw();
+
+protected:
+  vtkDearImGuiDrawProfiler();
+  ~vtkDearImGuiDrawProfiler() override;
+
+  // Ring of the last NumberOfFrames samples.
+  struct Series
+  {
+    std::vector<double> Samples;
+    int Next = 0;
+    int Count = 0;
+    void Push(double sample, int capacity);
+    Statistics Get() const;
+    int CountAbove(double threshold) const;
+  };
+
+  struct ObserverSeries
+  {
+    Series Seconds;
+    double Frame = 0.; // this frame so far
+    int IdleFrames = 0;
+    bool OverBudget = false;
+  };
+
+  struct WindowSeries
+  {
+    Series Counts[3]; // vertices, indices, commands
+    double Frame[3] = { 0., 0., 0. };
+    int IdleFrames = 0;
+  };
+
+  double GetBudget(const std::string& name) const;
+
+  int NumberOfFrames = 120;
+  double Budget = 0.002;
+  std::map<std::string, double> ObserverBudgets;
+  std::map<std::string, ObserverSeries> Observers;
+  std::map<std::string, WindowSeries> Windows;
+  Series DrawEvent;
+  bool InFrame = false;
+
+private:
+  vtkDearImGuiDrawProfiler(const vtkDearImGuiDrawProfiler&) = delete;
+  void operator=(const vtkDearImGuiDrawProfiler&) = delete;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+class vtkImageData;
+class vtkScalarsToColors;
+
+// Texture for images that change every frame, e.g. live vtkImageData slices or
+// camera feeds, drawn with ImGui::Image.
+//
+// New images are handed over from the UI thread without GL calls. Scalars are mapped
+// to RGBA on a worker thread. Upload() then streams the newest RGBA image through a
+// ring of pixel unpack buffers: the copy into the texture is queued on the GPU and a
+// buffer is only written again once its fence has signalled, so the render thread
+// never waits for a transfer. When all buffers are in flight the image is kept for the
+// next frame.
+//
+// Create instances with vtkDearImGuiInjector::CreateDynamicTexture(), which uploads
+// them before the overlay is rendered.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiDynamicTexture : public vtkObject
+{
+public:
+  static vtkDearImGuiDynamicTexture* New();
+  vtkTypeMacro(vtkDearImGuiDynamicTexture, vtkObject);
+
+  // Post the first slice of image. Unsigned char RGB(A) scalars are used as colors when
+  // colors is null, other scalars are mapped through colors (a gray ramp over the data
+  // range when null). The scalars are copied, the image may change afterwards.
+  void SetImage(vtkImageData* image, vtkScalarsToColors* colors = nullptr, int component = 0);
+  // Post RGBA8 pixels, rows bottom to top like vtkImageData. Copied.
+  void SetPixels(const unsigned char* rgba, int width, int height);
+
+  // Draw with ImGui::Image. A size <= 0 uses the image size.
+  void Draw(float width = 0.f, float height = 0.f);
+  // OpenGL texture name, 0 before the first upload.
+  unsigned int GetTextureName() const { return this->Texture; }
+  int GetWidth() const { return this->TextureSize[0]; }
+  int GetHeight() const { return this->TextureSize[1]; }
+  // Bytes of the texture and its upload buffers.
+  std::size_t GetGraphicsMemorySize() const
+  {
+    const std::size_t texels =
+      static_cast<std::size_t>(this->TextureSize[0]) * this->TextureSize[1];
+    return this->Texture ? texels * 4 * (1 + NumberOfBuffers) : 0;
+  }
+
+  // Images replaced before they reached the texture.
+  unsigned long GetDroppedImages() const;
+
+  // Render thread, with the OpenGL context current.
+  void Upload();
+  void ReleaseGraphicsResources();
+
+  // Called from the worker thread when an image is ready to upload.
+  void SetReadyCallback(std::function<void()> callback);
+
+protected:
+  vtkDearImGuiDynamicTexture();
+  ~vtkDearImGuiDynamicTexture() override;
+
+  struct vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+
+  static const int NumberOfBuffers = 3;
+  unsigned int Texture = 0;
+  int TextureSize[2] = { 0, 0 };
+  unsigned int Buffers[NumberOfBuffers] = { 0, 0, 0 };
+  void* Fences[NumberOfBuffers] = { nullptr, nullptr, nullptr }; // GLsync
+  int NextBuffer = 0;
+
+private:
+  vtkDearImGuiDynamicTexture(const vtkDearImGuiDynamicTexture&) = delete;
+  void operator=(const vtkDearImGuiDynamicTexture&) = delete;
+};
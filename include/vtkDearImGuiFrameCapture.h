@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+// Captures rendered frames, overlay included, without stalling the render loop.
+//
+// Capture() starts an asynchronous readback of the bound framebuffer into one of a few
+// pixel pack buffers (through a resolve blit when it is multisampled). Collect() picks
+// up readbacks whose fence has signalled and queues the pixels for an encoder thread,
+// which writes PNG screenshots, recordings and calls the frame callback. A frame is
+// dropped instead of waiting when all pack buffers are in flight or MaximumQueuedFrames
+// frames wait for the encoder, so capture never changes the interactive frame time.
+//
+// vtkDearImGuiInjector drives Capture() and Collect(), see GetFrameCapture().
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiFrameCapture : public vtkObject
+{
+public:
+  static vtkDearImGuiFrameCapture* New();
+  vtkTypeMacro(vtkDearImGuiFrameCapture, vtkObject);
+
+  enum Formats
+  {
+    // one PNG per frame, "movie.png" becomes movie_000000.png, movie_000001.png, ...
+    PNG,
+    // RGBA8 frames, rows top to bottom, appended to one file
+    // (ffmpeg -f rawvideo -pix_fmt rgba -video_size WxH)
+    Raw,
+    // YUV4MPEG2 4:4:4 video
+    Y4M
+  };
+
+  // Write the next rendered frame to a PNG file.
+  void Screenshot(const char* fileName);
+  // Write every rendered frame until StopRecording(). Frames whose size differs from
+  // the first one are dropped for Raw and Y4M.
+  bool StartRecording(const char* fileName, int format = Y4M);
+  // Waits for the frames still being read back and queued frames to be written, needs
+  // the OpenGL context current while recorded frames are in flight.
+  void StopRecording();
+  bool IsRecording() const { return this->Recording; }
+
+  // Called on the encoder thread for every captured frame. RGBA8 pixels, rows bottom
+  // to top like vtkImageData, valid during the call. Setting a callback captures every
+  // rendered frame.
+  using FrameCallback = std::function<void(const unsigned char* rgba, int width, int height)>;
+  void SetFrameCallback(FrameCallback callback);
+
+  // Frame rate written to the Y4M header.
+  vtkSetClampMacro(FrameRate, int, 1, 1000);
+  vtkGetMacro(FrameRate, int);
+  // Frames waiting for the encoder before new frames are dropped.
+  vtkSetClampMacro(MaximumQueuedFrames, int, 1, 256);
+  vtkGetMacro(MaximumQueuedFrames, int);
+  vtkGetMacro(CapturedFrames, unsigned long);
+  vtkGetMacro(DroppedFrames, unsigned long);
+
+  // Whether the next frame should be captured.
+  bool IsCapturing() const;
+  // Render thread, with the OpenGL context current. Capture() reads the framebuffer
+  // bound for reading, whose color buffer is width x height.
+  void Capture(int width, int height);
+  void Collect();
+  bool HasPendingReadbacks() const;
+  // Bytes of the readback buffers and the multisample resolve target.
+  std::size_t GetGraphicsMemorySize() const;
+  void ReleaseGraphicsResources();
+
+protected:
+  vtkDearImGuiFrameCapture();
+  ~vtkDearImGuiFrameCapture() override;
+
+  // Hand finished readbacks to the encoder, wait blocks until all of them finished.
+  void CollectReadbacks(bool wait);
+
+  struct vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+
+  std::string PendingScreenshot;
+  bool Recording = false;
+  int FrameRate = 30;
+  int MaximumQueuedFrames = 4;
+  unsigned long CapturedFrames = 0;
+  unsigned long DroppedFrames = 0;
+
+private:
+  vtkDearImGuiFrameCapture(const vtkDearImGuiFrameCapture&) = delete;
+  void operator=(const vtkDearImGuiFrameCapture&) = delete;
+};
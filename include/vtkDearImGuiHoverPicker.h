@@ -0,0 +1,61 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkWeakPointer.h>
+#include <vtkdearimguiinjector_export.h>
+
+class vtkActor;
+class vtkRenderer;
+
+// Finds the cell under the cursor without stalling the UI thread.
+//
+// Visible, pickable actors are shallow copied when their input's MTime changes and a
+// worker thread builds a vtkStaticCellLocator for each of them. Update() is meant to
+// be called once per frame: it posts a ray for the latest cursor position, replacing
+// any query the worker did not start yet, and picks up the most recent answer.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiHoverPicker : public vtkObject
+{
+public:
+  static vtkDearImGuiHoverPicker* New();
+  vtkTypeMacro(vtkDearImGuiHoverPicker, vtkObject);
+
+  struct Result
+  {
+    bool Valid = false;
+    vtkWeakPointer<vtkActor> Actor;
+    vtkIdType CellId = -1;
+    double Position[3] = { 0., 0., 0. }; // world coordinates
+    // point data interpolated at Position, magnitude for multi-component arrays
+    std::vector<std::pair<std::string, double>> PointValues;
+  };
+
+  // Post a query for display position (x, y) of renderer. UI thread.
+  void Update(vtkRenderer* renderer, int x, int y);
+  // Latest answer. May lag the cursor by a frame or two.
+  const Result& GetResult() const { return this->LastResult; }
+  void Clear();
+
+  // Show the result in an ImGui tooltip.
+  void DrawTooltip();
+
+  // Called from the worker thread when a new result is ready.
+  void SetResultCallback(std::function<void()> callback);
+
+protected:
+  vtkDearImGuiHoverPicker();
+  ~vtkDearImGuiHoverPicker() override;
+
+  struct vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+  Result LastResult;
+
+private:
+  vtkDearImGuiHoverPicker(const vtkDearImGuiHoverPicker&) = delete;
+  void operator=(const vtkDearImGuiHoverPicker&) = delete;
+};
@@ -1,11 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
 #include <vtkCommand.h>
 #include <vtkNew.h>
 #include <vtkObject.h>
+#include <vtkSmartPointer.h>
 #include <vtkWeakPointer.h>
 #include <vtkdearimguiinjector_export.h>
 
+#include "vtkDearImGuiAllocator.h"
+#include "vtkDearImGuiCommandQueue.h"
+#include "vtkDearImGuiInputQueue.h"
+
 #if __has_include(<vtkXRenderWindowInteractor.h>)
 #define USES_X11 1
 #endif
@@ -27,6 +38,24 @@ class vtkRenderWindow;
 class vtkRenderWindowInteractor;
 class vtkCallbackCommand;
 class vtkInteractorStyle;
+class vtkDearImGuiActionRegistry;
+class vtkDearImGuiDatasetLoader;
+class vtkDearImGuiDrawBatcher;
+class vtkDearImGuiDrawProfiler;
+class vtkDearImGuiDynamicTexture;
+class vtkDearImGuiFrameCapture;
+class vtkDearImGuiHoverPicker;
+class vtkDearImGuiOcclusionCuller;
+class vtkDearImGuiOutliner;
+class vtkDearImGuiParameterCommitter;
+class vtkDearImGuiPropertyEditor;
+class vtkDearImGuiRemoteServer;
+class vtkDearImGuiResourceMonitor;
+class vtkDearImGuiSDFFont;
+class vtkDearImGuiSMPPanel;
+class vtkDearImGuiSharedMemoryPublisher;
+class vtkDearImGuiTracer;
+class vtkDearImGuiTransferFunctionEditor;
 
 class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiInjector : public vtkObject
 {
@@ -39,13 +68,217 @@ public:
 
   void InstallEventCallback(vtkRenderWindowInteractor* interactor);
   void UninstallEventCallback();
+  // Mouse and key events routed since the last frame, the next frame applies them.
+  vtkDearImGuiInputQueue* GetInputQueue();
 
   // Observe this event and draw application specific ImGui widgets
   static const unsigned long ImGuiDrawEvent = vtkCommand::UserEvent + 1;
   static const unsigned long ImGuiSetupEvent = vtkCommand::UserEvent + 2;
   static const unsigned long ImGuiTearDownEvent = vtkCommand::UserEvent + 3;
+  // Fired when a paced frame starts after its deadline. callData: double* lateness in seconds.
+  static const unsigned long FrameDeadlineMissedEvent = vtkCommand::UserEvent + 4;
   vtkWeakPointer<vtkRenderWindowInteractor> Interactor;
 
+  // Route mouse/keyboard to VTK even when ImGui wants them.
+  // Also toggled from the built-in menu bar, when it is compiled in.
+  vtkSetMacro(GrabMouse, bool);
+  vtkGetMacro(GrabMouse, bool);
+  vtkBooleanMacro(GrabMouse, bool);
+  vtkSetMacro(GrabKeyboard, bool);
+  vtkGetMacro(GrabKeyboard, bool);
+  vtkBooleanMacro(GrabKeyboard, bool);
+
+  // Decides whether ImGui keeps an input event from the interactor style, true keeps it.
+  // imguiWants is io.WantCaptureMouse or io.WantCaptureKeyboard, position the event
+  // position in pixels from the bottom left. GrabMouse and GrabKeyboard still pass every
+  // event on. Without a policy ImGui keeps the events it wants.
+  using CapturePolicy =
+    std::function<bool(unsigned long eventId, bool imguiWants, const int position[2])>;
+  void SetMouseCapturePolicy(CapturePolicy policy);
+  void SetKeyboardCapturePolicy(CapturePolicy policy);
+  // ImGui only keeps the mouse events it wants inside a rectangle, e.g. a tool panel along
+  // one side of the window.
+  static CapturePolicy CaptureInRegion(int xmin, int ymin, int xmax, int ymax);
+
+  // Built-in Dear ImGui windows. These are no-ops when the corresponding
+  // feature was stripped at compile time (see USE_IMGUI_DEMO, USE_IMGUI_DEBUG_TOOLS).
+  vtkSetMacro(ShowDemo, bool);
+  vtkGetMacro(ShowDemo, bool);
+  vtkSetMacro(ShowAppMetrics, bool);
+  vtkGetMacro(ShowAppMetrics, bool);
+
+  // Scene outliner window listing renderers and props, also in the Tools menu.
+  vtkSetMacro(ShowOutliner, bool);
+  vtkGetMacro(ShowOutliner, bool);
+  vtkBooleanMacro(ShowOutliner, bool);
+  vtkDearImGuiOutliner* GetOutliner();
+
+  // Named actions listed in the menu bar and the command palette (Ctrl+Shift+P), e.g.
+  // AddAction("View/Reset Camera", callback, "Ctrl+R"). Shortcuts run from key presses
+  // while no ImGui text field is active, and the key is then not passed on to VTK.
+  bool AddAction(const char* path, std::function<void()> callback,
+    const char* shortcut = nullptr, std::function<bool()> checked = nullptr);
+  bool RemoveAction(const char* path);
+  vtkDearImGuiActionRegistry* GetActionRegistry();
+
+  // Cross-thread communication with the UI thread.
+  // Commands may be posted from any thread. They run on the UI thread at the start of
+  // BeginDearImGuiOverlay, before ImGuiDrawEvent observers, where ImGui and VTK are
+  // safe to touch. Posting wakes an idle event loop. Returns false if the queue is full.
+  bool PostCommand(std::function<void()> command);
+  // Deliver a typed message as this->InvokeEvent(eventId, &message) on the UI thread.
+  template <typename T>
+  bool PostEvent(unsigned long eventId, T message)
+  {
+    return this->PostCommand(
+      [this, eventId, message]() mutable { this->InvokeEvent(eventId, &message); });
+  }
+  // Request a frame from any thread.
+  void WakeUp();
+
+  // Same as AddObserver(ImGuiDrawEvent, command, priority), with the observer shown
+  // under name in traces and timed by the draw profiler.
+  unsigned long AddDrawObserver(const char* name, vtkCommand* command, float priority = 0.0f);
+
+  // Write a Chrome trace-event JSON file with spans for event loop iterations,
+  // dispatched events, overlay phases, draw observers and VTK renders.
+  // User spans can be added with vtkDearImGuiTracer::Scope.
+  bool StartTrace(const char* fileName);
+  void StopTrace();
+
+  // Pick the cell under the cursor every frame (off the UI thread, see
+  // vtkDearImGuiHoverPicker) and optionally show it in a tooltip. Observers read the
+  // result with GetHoverPicker()->GetResult().
+  vtkSetMacro(HoverPicking, bool);
+  vtkGetMacro(HoverPicking, bool);
+  vtkBooleanMacro(HoverPicking, bool);
+  vtkSetMacro(ShowHoverTooltip, bool);
+  vtkGetMacro(ShowHoverTooltip, bool);
+  vtkBooleanMacro(ShowHoverTooltip, bool);
+  vtkDearImGuiHoverPicker* GetHoverPicker();
+
+  // Merge draw lists and compatible draw commands before rendering the overlay.
+  // See vtkDearImGuiDrawBatcher, which also reports the number of draw calls saved.
+  vtkSetMacro(BatchDrawCalls, bool);
+  vtkGetMacro(BatchDrawCalls, bool);
+  vtkBooleanMacro(BatchDrawCalls, bool);
+  vtkDearImGuiDrawBatcher* GetDrawBatcher();
+
+  // Generated property editors. Edits staged by GetPropertyEditor()->Draw(object) in
+  // ImGuiDrawEvent observers are committed once, after all observers ran.
+  vtkDearImGuiPropertyEditor* GetPropertyEditor();
+
+  // Parameters of expensive consumers, e.g. filters driven by sliders. Widgets write the
+  // latest value and the committer hands it on once per frame, after a debounce delay or
+  // when the widget is released. The Parameters window shows committed and dropped
+  // updates, also in the Tools menu.
+  vtkDearImGuiParameterCommitter* GetParameterCommitter();
+  vtkSetMacro(ShowParameters, bool);
+  vtkGetMacro(ShowParameters, bool);
+  vtkBooleanMacro(ShowParameters, bool);
+
+  // vtkSMPTools backend and thread count, switched at runtime, with timings of SMP
+  // filters under each configuration. Also in the Tools menu.
+  vtkSetMacro(ShowSMPPanel, bool);
+  vtkGetMacro(ShowSMPPanel, bool);
+  vtkBooleanMacro(ShowSMPPanel, bool);
+  vtkDearImGuiSMPPanel* GetSMPPanel();
+
+  // Memory of the datasets, buffers, textures, framebuffers and shader programs of the
+  // window, and of the overlay itself, per renderer and per prop. Measured after the
+  // overlay renders while the Resources window is shown, also in the Tools menu.
+  vtkSetMacro(ShowResources, bool);
+  vtkGetMacro(ShowResources, bool);
+  vtkBooleanMacro(ShowResources, bool);
+  vtkDearImGuiResourceMonitor* GetResourceMonitor();
+
+  // Loads datasets on worker threads and hands the pieces to callbacks on the UI thread
+  // through PostCommand(). The Loads window shows progress, throughput and cancel
+  // buttons, also in the Tools menu.
+  vtkSetMacro(ShowLoads, bool);
+  vtkGetMacro(ShowLoads, bool);
+  vtkBooleanMacro(ShowLoads, bool);
+  vtkDearImGuiDatasetLoader* GetDatasetLoader();
+
+  // Distance field fonts, add them from ImGuiSetupEvent observers. The atlas is built
+  // after the event and text from it stays sharp at every size set with SetSize().
+  vtkDearImGuiSDFFont* GetSDFFont();
+
+  // Time of every draw observer and draw data of every window over the last frames,
+  // with observers over their budget flagged. The Draw Profile window shows them, also
+  // in the Tools menu.
+  vtkSetMacro(ShowDrawProfile, bool);
+  vtkGetMacro(ShowDrawProfile, bool);
+  vtkBooleanMacro(ShowDrawProfile, bool);
+  vtkDearImGuiDrawProfiler* GetDrawProfiler();
+
+  // Keep the scene from shading pixels behind opaque overlay windows, through the stencil
+  // buffer. Turn on before Inject(), which makes the render window stencil capable.
+  vtkSetMacro(OcclusionCulling, bool);
+  vtkGetMacro(OcclusionCulling, bool);
+  vtkBooleanMacro(OcclusionCulling, bool);
+  vtkDearImGuiOcclusionCuller* GetOcclusionCuller();
+
+  // Textures for images that change every frame. They are uploaded right before the
+  // overlay renders, observers post images with SetImage() and draw them with Draw().
+  vtkDearImGuiDynamicTexture* CreateDynamicTexture();
+  void RemoveDynamicTexture(vtkDearImGuiDynamicTexture* texture);
+
+  // Transfer function editors. Edits made in ImGuiDrawEvent observers are committed once
+  // per frame and their lookup textures updated before the overlay renders.
+  vtkDearImGuiTransferFunctionEditor* CreateTransferFunctionEditor();
+  void RemoveTransferFunctionEditor(vtkDearImGuiTransferFunctionEditor* editor);
+
+  // Screenshots and recordings of the composed frame, read back asynchronously after
+  // the overlay is rendered. See vtkDearImGuiFrameCapture.
+  vtkDearImGuiFrameCapture* GetFrameCapture();
+  // Write the next frame to a PNG file and make sure that frame gets rendered.
+  void SaveScreenshot(const char* fileName);
+
+  // Serve the overlay to a vtkDearImGuiRemoteClient on "tcp://host:port" or
+  // "unix:///path", "tcp://:port" listens on loopback only. Remote input takes the same
+  // route as local input.
+  bool StartRemoteUI(const char* address);
+  void StopRemoteUI();
+  vtkDearImGuiRemoteServer* GetRemoteServer();
+
+  // Headless servers: publish every composed frame to the shared memory ring `name`
+  // (see vtkDearImGuiSharedMemoryPublisher) and replay the input its reader posts.
+  // A maximum size of 0 uses the render window size.
+  bool StartPublishing(const char* name, int maximumWidth = 0, int maximumHeight = 0);
+  void StopPublishing();
+  vtkDearImGuiSharedMemoryPublisher* GetPublisher();
+
+  // ImGui allocates through vtkDearImGuiAllocator. Observers can take temporaries that
+  // live until the next frame from it, e.g. GetAllocator()->FormatFrameString(...).
+  vtkDearImGuiAllocator* GetAllocator() { return vtkDearImGuiAllocator::GetInstance(); }
+  // Allocation counts, bytes and peak usage of the last frame.
+  const vtkDearImGuiAllocator::Statistics& GetAllocationStatistics() const
+  {
+    return vtkDearImGuiAllocator::GetInstance()->GetFrameStatistics();
+  }
+
+  // Frame pacing, in frames per second.
+  // When either rate is non-zero, render requests from the interactor are coalesced and
+  // the event loop renders at most once per frame interval: TargetFrameRate while the
+  // user interacts (or ImGui animates), IdleFrameRate otherwise. A rate of 0 leaves that
+  // state uncapped. Both 0 (the default) renders on every request, as VTK does.
+  vtkSetClampMacro(TargetFrameRate, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(TargetFrameRate, double);
+  vtkSetClampMacro(IdleFrameRate, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(IdleFrameRate, double);
+  // The loop sleeps until SpinTime seconds before a deadline, then busy-waits for a
+  // precise frame start.
+  vtkSetClampMacro(SpinTime, double, 0.0, 1.0);
+  vtkGetMacro(SpinTime, double);
+  // Seconds after the last input event during which the loop uses TargetFrameRate.
+  vtkSetClampMacro(InteractionTimeout, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(InteractionTimeout, double);
+  // Number of paced frames that started later than deadline + SpinTime.
+  vtkGetMacro(MissedFrames, unsigned long);
+  // Distance of the last paced frame start from its deadline, in seconds.
+  vtkGetMacro(FrameJitter, double);
+
 protected:
   vtkDearImGuiInjector();
   ~vtkDearImGuiInjector() override;
@@ -57,38 +290,134 @@ protected:
   // hooks into vtkRenderWindow
   void BeginDearImGuiOverlay(vtkObject* caller, unsigned long eid, void* callData);
   void RenderDearImGuiOverlay(vtkObject* caller, unsigned long eid, void* callData);
+  // Report the overlay's resources and update the resource monitor, context current.
+  void MeasureResources(vtkRenderWindow* renWin);
 
-  // Mouse will be set here.
-  void UpdateMousePosAndButtons(vtkRenderWindowInteractor* interactor);
+  // Mouse cursor shape will be set here.
   void UpdateMouseCursor(vtkRenderWindow* renWin);
 
   // Run the event loop.
   void PumpEv(vtkObject* caller, unsigned long eid, void* callData);
+  static void MainLoopCallback(void* arg);
+
+  // Run commands posted from other threads.
+  void DrainPostedCommands();
+  // Block the event loop for at most timeout seconds or until WakeUp().
+  void WaitForWakeUp(double timeout);
+
+  // Frame pacing
+  bool IsPacing() const { return this->TargetFrameRate > 0 || this->IdleFrameRate > 0; }
+  void UpdatePacingState(vtkRenderWindowInteractor* interactor);
+  void RequestRender();
+  void OnRenderRequest(vtkObject* caller, unsigned long eid, void* callData);
+  double GetFrameInterval() const;
+  double GetTimeToNextFrame() const;
+  void RenderPacedFrame();
+
+  // closes the VTK render span opened in BeginDearImGuiOverlay
+  void EndRenderTrace(vtkObject* caller, unsigned long eid, void* callData);
 
   // routes events:
   // VTK[X,Win32,Cocoa]Interactor >>>> DearImGui >>>> VTK[...]InteractorStyle
+  // Each observed event has a route in a table generated at compile time, see
+  // vtkDearImGuiEventRouting in the implementation.
   static void DispatchEv(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+  friend class vtkDearImGuiEventRouting;
+  CapturePolicy MouseCapturePolicy;
+  CapturePolicy KeyboardCapturePolicy;
 
   vtkNew<vtkCallbackCommand> EventCallbackCommand;
   vtkWeakPointer<vtkInteractorStyle> currentIStyle;
 
   double Time = 0;
-  bool MouseJustPressed[3] = { false, false, false };
+  // mouse and key events for the next frames
+  vtkDearImGuiInputQueue InputQueue;
   bool FinishedSetup = false;
-  bool Focused = true;
   bool GrabMouse = false;    // true: pass mouse to vtk, false: imgui accepts mouse
                              // and doesn't give it to VTK (when ui is focused)
   bool GrabKeyboard = false; // true: pass keys to vtk, false: imgui accepts
                              // keys and doesn't give it to VTK (when ui is focused)
 
+#ifndef IMGUI_DISABLE_DEMO_WINDOWS
   bool ShowDemo = true;
+#else
+  bool ShowDemo = false;
+#endif
   bool ShowAppMetrics = false;
   bool ShowAppStyleEditor = false;
   bool ShowAppAbout = false;
+  bool ShowOutliner = false;
+  vtkNew<vtkDearImGuiOutliner> Outliner;
+  vtkNew<vtkDearImGuiActionRegistry> Actions;
 
   int ImGuiForceUpdateTimer = -1;
   int ImGuiFrameCntsRemained = 0;
 
+  vtkDearImGuiCommandQueue PostedCommands;
+  std::atomic<bool> WakeUpRequested{ false };
+  std::atomic<bool> Sleeping{ false };
+  std::mutex WakeUpMutex;
+  std::condition_variable WakeUpCondition;
+
+  double TargetFrameRate = 0;
+  double IdleFrameRate = 0;
+  double SpinTime = 0.002;
+  double InteractionTimeout = 0.25;
+  unsigned long MissedFrames = 0;
+  double FrameJitter = 0;
+  bool RenderRequested = false;
+  bool PacingDisabledRender = false; // we turned interactor rendering off
+  double RenderRequestTime = 0;
+  double LastFrameDeadline = 0;
+  double LastInteractionTime = 0;
+
+  vtkNew<vtkDearImGuiTracer> Tracer;
+
+  bool HoverPicking = false;
+  bool ShowHoverTooltip = true;
+  vtkNew<vtkDearImGuiHoverPicker> HoverPicker;
+
+  vtkNew<vtkDearImGuiPropertyEditor> PropertyEditor;
+
+  bool ShowParameters = false;
+  vtkNew<vtkDearImGuiParameterCommitter> ParameterCommitter;
+  // one-shot timer for the frame of the next debounced commit
+  int ParameterTimer = -1;
+  double ParameterTimerDue = 0;
+
+  bool ShowSMPPanel = false;
+  vtkNew<vtkDearImGuiSMPPanel> SMPPanel;
+
+  bool ShowResources = false;
+  vtkNew<vtkDearImGuiResourceMonitor> ResourceMonitor;
+
+  // joins its workers before PostedCommands goes away
+  bool ShowLoads = false;
+  vtkNew<vtkDearImGuiDatasetLoader> DatasetLoader;
+
+  vtkNew<vtkDearImGuiSDFFont> SDFFont;
+
+  bool ShowDrawProfile = false;
+  vtkNew<vtkDearImGuiDrawProfiler> DrawProfiler;
+
+  bool OcclusionCulling = false;
+  vtkNew<vtkDearImGuiOcclusionCuller> OcclusionCuller;
+
+  bool BatchDrawCalls = true;
+  vtkNew<vtkDearImGuiDrawBatcher> DrawBatcher;
+  std::vector<vtkSmartPointer<vtkDearImGuiDynamicTexture>> DynamicTextures;
+  std::vector<vtkSmartPointer<vtkDearImGuiDynamicTexture>> RetiredDynamicTextures;
+  std::vector<vtkSmartPointer<vtkDearImGuiTransferFunctionEditor>> TransferFunctionEditors;
+  std::vector<vtkSmartPointer<vtkDearImGuiTransferFunctionEditor>>
+    RetiredTransferFunctionEditors;
+
+  // outlives FrameCapture, whose encoder thread publishes into it
+  vtkNew<vtkDearImGuiSharedMemoryPublisher> Publisher;
+  vtkNew<vtkDearImGuiFrameCapture> FrameCapture;
+
+  vtkNew<vtkDearImGuiRemoteServer> RemoteServer;
+  double RenderStartTime = -1; // trace clock, -1 when not tracing
+
 private:
   vtkDearImGuiInjector(const vtkDearImGuiInjector&) = delete;
   void operator=(const vtkDearImGuiInjector&) = delete;
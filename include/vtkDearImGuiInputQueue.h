@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <vtkdearimguiinjector_export.h>
+
+// Mouse, keyboard and text events waiting for the next ImGui frame, with the time they
+// arrived.
+//
+// ImGui only sees one transition per button or key per frame. Apply() feeds the
+// events of one frame and stops at the second transition of a button or key, so a
+// click whose press and release fall between two frames still shows up as a click
+// and Apply() reports that another frame is needed. With ImGui 1.87 and later the
+// events go through io.AddMousePosEvent() and friends, older versions get their io
+// mouse and key state set directly.
+//
+// When a trace is running, every applied event adds an "input" span from its arrival
+// to the frame that applies it.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiInputQueue
+{
+public:
+  // Position in ImGui coordinates, origin at the top left.
+  void AddMousePos(float x, float y);
+  // The mouse left the window.
+  void AddMouseLeave();
+  void AddMouseButton(int button, bool down);
+  void AddMouseWheel(float horizontal, float vertical);
+  // key is an ImGuiKey with ImGui 1.87 and later (see ToImGuiKey()), an index into
+  // io.KeysDown before.
+  void AddKey(int key, bool down);
+  void AddModifiers(bool control, bool shift, bool alt, bool super);
+  // Text input, applied in order with the key events.
+  void AddCharacters(const char* utf8);
+  void AddCharacter(unsigned int codepoint);
+
+  // Feed the events of one frame to ImGui. Returns true if events are left for the
+  // next frame.
+  bool Apply();
+  bool IsEmpty() const { return this->Events.empty(); }
+  void Clear()
+  {
+    this->Events.clear();
+    this->Text.clear();
+  }
+
+  // ImGuiKey of a VTK key sym, ImGuiKey_None if there is none. ImGui 1.87 and later.
+  static int ToImGuiKey(const char* keySym);
+
+protected:
+  enum EventType
+  {
+    MousePos = 0,
+    MouseButton,
+    MouseWheel,
+    Key,
+    Modifiers,
+    Char
+  };
+
+  struct Event
+  {
+    int Type;
+    double Time; // arrival on the trace clock
+    int Code;    // button, key, modifier bits or offset of the characters in Text
+    bool Down;
+    float X;
+    float Y;
+  };
+
+  void Push(int type, int code, bool down, float x, float y);
+
+  std::vector<Event> Events;
+  // nul-terminated UTF-8 of the Char events
+  std::string Text;
+};
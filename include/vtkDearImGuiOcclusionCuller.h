@@ -0,0 +1,77 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkWeakPointer.h>
+#include <vtkdearimguiinjector_export.h>
+
+struct ImDrawData;
+class vtkRenderWindow;
+class vtkRenderer;
+
+// Keeps the scene from shading pixels hidden behind opaque overlay windows.
+//
+// Update() finds the opaque backgrounds of the windows in the draw data of a frame,
+// windows whose background uses the style's WindowBg, ChildBg or PopupBg at full alpha.
+// Rectangles unchanged over the last two frames are written into a bit of the stencil
+// buffer when the first renderer of the next frame starts, and the stencil test keeps
+// the renderers from touching them until EndFrame(). Moving windows are never culled,
+// a window that moves or closes after resting leaves one frame of background behind,
+// Update() then asks for another frame.
+//
+// Needs a stencil capable window, see vtkRenderWindow::SetStencilCapable(). Passes
+// rendering into their own framebuffers, e.g. depth peeling, are only culled when their
+// result is composited into the window.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiOcclusionCuller : public vtkObject
+{
+public:
+  static vtkDearImGuiOcclusionCuller* New();
+  vtkTypeMacro(vtkDearImGuiOcclusionCuller, vtkObject);
+
+  // Framebuffer pixels, from the bottom left, X1 and Y1 excluded.
+  struct Rect
+  {
+    int X0 = 0;
+    int Y0 = 0;
+    int X1 = 0;
+    int Y1 = 0;
+  };
+
+  // Take the opaque windows of a frame, for the next frame. Returns true if pixels
+  // culled in this frame are no longer covered and the scene needs another frame.
+  bool Update(const ImDrawData* drawData);
+  // Arm culling for the frame renderWindow starts to render.
+  void BeginFrame(vtkRenderWindow* renderWindow);
+  // Stop culling, before the overlay renders.
+  void EndFrame();
+  // Forget the windows, e.g. when culling is turned off.
+  void Reset();
+
+  // Rectangles the next frame culls.
+  const std::vector<Rect>& GetRects() const { return this->Next; }
+  // Share of the framebuffer culled in the last frame.
+  double GetCulledFraction() const { return this->CulledFraction; }
+
+protected:
+  vtkDearImGuiOcclusionCuller();
+  ~vtkDearImGuiOcclusionCuller() override;
+
+  // vtkRenderer StartEvent.
+  void Cull(vtkObject* caller, unsigned long eid, void* callData);
+
+  std::vector<Rect> Previous; // opaque in the last frame
+  std::vector<Rect> Next;     // opaque in the last two frames
+  std::vector<Rect> Culled;   // written in this frame
+  int FramebufferSize[2] = { 0, 0 };
+  double CulledFraction = 0.;
+  bool Armed = false;
+  bool Applied = false;
+  vtkWeakPointer<vtkRenderWindow> Window;
+  std::vector<std::pair<vtkWeakPointer<vtkRenderer>, unsigned long>> Observed;
+
+private:
+  vtkDearImGuiOcclusionCuller(const vtkDearImGuiOcclusionCuller&) = delete;
+  void operator=(const vtkDearImGuiOcclusionCuller&) = delete;
+};
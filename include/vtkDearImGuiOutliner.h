@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <vtkDearImGuiTextIndex.h>
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+class vtkProp;
+class vtkRenderWindow;
+class vtkRenderer;
+
+// Lists the renderers of a render window and their props, with visibility, opacity
+// and selection toggles, for scenes with hundreds of thousands of props.
+//
+// The props are flattened into rows once per change of the renderer or prop
+// collections, the filter goes through a vtkDearImGuiTextIndex over the row names and
+// types, and only the rows in view are submitted to ImGui.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiOutliner : public vtkObject
+{
+public:
+  static vtkDearImGuiOutliner* New();
+  vtkTypeMacro(vtkDearImGuiOutliner, vtkObject);
+
+  enum RowTypes
+  {
+    RendererRow = 0,
+    ActorRow,
+    VolumeRow,
+    Actor2DRow,
+    OtherRow
+  };
+
+  // Draw in the current ImGui window.
+  void Draw(vtkRenderWindow* renderWindow);
+
+  // Selected props, in selection order. Changes fire vtkCommand::SelectionChangedEvent.
+  const std::vector<vtkProp*>& GetSelection() const { return this->Selection; }
+  void ClearSelection();
+
+  int GetNumberOfRows() const { return static_cast<int>(this->Rows.size()); }
+  int GetNumberOfVisibleRows() const { return static_cast<int>(this->VisibleRows.size()); }
+
+protected:
+  vtkDearImGuiOutliner();
+  ~vtkDearImGuiOutliner() override;
+
+  struct Row
+  {
+    vtkRenderer* Renderer;
+    vtkProp* Prop; // null for renderer rows
+    int Type;
+    std::string Label;
+  };
+
+  // Flatten the scene again if a collection changed.
+  void Update(vtkRenderWindow* renderWindow);
+  // Rows to show for the filter, type and collapsed renderers.
+  void UpdateVisibleRows();
+  void DrawRow(const Row& row);
+  void Select(vtkProp* prop, bool toggle);
+
+  std::vector<Row> Rows;
+  vtkRenderWindow* RenderWindow = nullptr;
+  vtkMTimeType SceneTime = 0;
+  vtkDearImGuiTextIndex Index;
+  char Filter[128] = "";
+  std::string LastFilter;
+  std::vector<int> Matches; // row ids matching LastFilter
+  int TypeFilter = -1;      // a RowTypes, -1 for all
+  std::vector<vtkRenderer*> Collapsed;
+  std::vector<int> VisibleRows;
+  bool VisibleRowsValid = false;
+  std::vector<vtkProp*> Selection;
+
+private:
+  vtkDearImGuiOutliner(const vtkDearImGuiOutliner&) = delete;
+  void operator=(const vtkDearImGuiOutliner&) = delete;
+};
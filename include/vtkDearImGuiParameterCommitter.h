@@ -0,0 +1,109 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+// Named parameters between widgets and expensive consumers such as filter
+// parameters.
+//
+// Widgets write every value they produce, the latest value wins. A cheap preview
+// callback sees it once per frame while it changes, the commit callback only when the
+// parameter's policy says so:
+//   Immediate     every frame the value changed.
+//   Debounce      once no value was written for Delay seconds.
+//   TrailingEdge  once the widget is released, see Write().
+// Values overwritten before they were committed are counted as dropped, the overlay
+// shows the counts per parameter in the Parameters window.
+//
+// The injector owns one committer and calls Update() once per frame, after the
+// ImGuiDrawEvent observers, see vtkDearImGuiInjector::GetParameterCommitter().
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiParameterCommitter : public vtkObject
+{
+public:
+  static vtkDearImGuiParameterCommitter* New();
+  vtkTypeMacro(vtkDearImGuiParameterCommitter, vtkObject);
+
+  enum Policies
+  {
+    Immediate = 0,
+    Debounce,
+    TrailingEdge
+  };
+
+  // Receives the NumberOfComponents values of a parameter.
+  using Callback = std::function<void(const double* value)>;
+
+  struct Metrics
+  {
+    unsigned long Writes = 0;
+    unsigned long Previews = 0;
+    unsigned long Commits = 0;
+    unsigned long Dropped = 0; // writes overwritten before they were committed
+    double LastCommitDuration = 0.; // seconds spent in the commit callback
+    double TotalCommitDuration = 0.;
+  };
+
+  // Add or replace the parameter name with up to 4 components, starting at value.
+  void AddParameter(const char* name, int numberOfComponents, const double* value,
+    Callback commit, Callback preview = nullptr, int policy = TrailingEdge, double delay = 0.25);
+  bool RemoveParameter(const char* name);
+  bool SetPolicy(const char* name, int policy, double delay = 0.25);
+
+  // Widgets write here. active tells that the widget is still held, e.g.
+  // ImGui::IsItemActive(), which delays TrailingEdge commits. Returns false if there is
+  // no such parameter.
+  bool Write(const char* name, const double* value, bool active = false);
+  // Latest written value, nullptr if there is no such parameter.
+  const double* GetValue(const char* name) const;
+
+  // Slider and drag widgets bound to a parameter, labeled with its name. Return true
+  // when the value changed.
+  bool SliderParameter(const char* name, double minimum, double maximum,
+    const char* format = "%.3f");
+  bool DragParameter(const char* name, float speed = 0.01f, const char* format = "%.3f");
+
+  // Run the previews and the commits that are due. Returns the seconds until the next
+  // Debounce commit is due, -1 if none is waiting.
+  double Update();
+  // Commit every pending value now.
+  void Flush();
+
+  const Metrics* GetMetrics(const char* name) const;
+  void ResetMetrics();
+  // Table of the parameters and their metrics in the current ImGui window.
+  void DrawMetrics();
+
+protected:
+  vtkDearImGuiParameterCommitter();
+  ~vtkDearImGuiParameterCommitter() override;
+
+  struct Parameter
+  {
+    int NumberOfComponents = 1;
+    double Value[4] = { 0., 0., 0., 0. };
+    Callback Commit;
+    Callback Preview;
+    int Policy = TrailingEdge;
+    double Delay = 0.25;
+    // written, previewed and committed versions of Value
+    unsigned long Version = 0;
+    unsigned long PreviewedVersion = 0;
+    unsigned long CommittedVersion = 0;
+    double LastWriteTime = 0.;
+    bool Active = false;
+    Metrics Statistics;
+  };
+
+  void CommitParameter(const std::string& name, Parameter& parameter);
+
+  // sorted by name for the metrics table
+  std::map<std::string, Parameter> Parameters;
+
+private:
+  vtkDearImGuiParameterCommitter(const vtkDearImGuiParameterCommitter&) = delete;
+  void operator=(const vtkDearImGuiParameterCommitter&) = delete;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkWeakPointer.h>
+#include <vtkdearimguiinjector_export.h>
+
+// Generates ImGui editors for vtkObject properties from a registry of descriptors.
+//
+// Widgets never call the setters. Edits are staged and applied by Commit(), which the
+// injector calls once per frame after the ImGuiDrawEvent observers. Every property is
+// set at most once per frame, and only if its value changed, so a drag that moves a
+// slider many times triggers a single Modified() and one pipeline update at the next
+// render.
+//
+// Descriptors for common actor, property, mapper and source parameters are
+// registered by default. Objects get the descriptors of every registered class they
+// are a kind of.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiPropertyEditor : public vtkObject
+{
+public:
+  static vtkDearImGuiPropertyEditor* New();
+  vtkTypeMacro(vtkDearImGuiPropertyEditor, vtkObject);
+
+  enum PropertyTypes
+  {
+    Boolean = 0,
+    Integer,
+    Double,
+    Color,      // three doubles in [0, 1]
+    Enumeration // integer index into EnumerationNames
+  };
+
+  struct PropertyDescriptor
+  {
+    std::string Name;
+    int Type = Double;
+    double Range[2] = { 0., 0. }; // slider range, a drag widget when Range[0] >= Range[1]
+    std::vector<std::string> EnumerationNames;
+    std::function<void(vtkObject*, double*)> Get;
+    std::function<void(vtkObject*, const double*)> Set;
+  };
+
+  // Add a descriptor for objects of class className (or subclasses).
+  void RegisterProperty(const char* className, const PropertyDescriptor& descriptor);
+
+  // Draw editors for object in the current ImGui window. Returns true if an edit was
+  // staged this call.
+  bool Draw(vtkObject* object);
+
+  // Apply staged edits. Returns the number of properties that were set.
+  int Commit();
+  // Drop staged edits.
+  void Discard();
+  int GetNumberOfStagedEdits() const { return static_cast<int>(this->Staged.size()); }
+
+protected:
+  vtkDearImGuiPropertyEditor();
+  ~vtkDearImGuiPropertyEditor() override;
+
+  using DescriptorPointer = std::shared_ptr<const PropertyDescriptor>;
+
+  struct StagedEdit
+  {
+    vtkWeakPointer<vtkObject> Object;
+    DescriptorPointer Descriptor;
+    double Value[4];
+  };
+
+  // registration order, base classes should come first
+  std::vector<std::pair<std::string, std::vector<DescriptorPointer>>> Registry;
+  std::map<std::pair<vtkObject*, const PropertyDescriptor*>, StagedEdit> Staged;
+
+private:
+  vtkDearImGuiPropertyEditor(const vtkDearImGuiPropertyEditor&) = delete;
+  void operator=(const vtkDearImGuiPropertyEditor&) = delete;
+};
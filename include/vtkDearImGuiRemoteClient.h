@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+#include <vtkNew.h>
+#include <vtkObject.h>
+#include <vtkWeakPointer.h>
+#include <vtkdearimguiinjector_export.h>
+
+#include "vtkDearImGuiRemoteProtocol.h"
+
+class vtkCallbackCommand;
+class vtkRenderWindowInteractor;
+struct ImGuiContext;
+
+// Shows the overlay of a vtkDearImGuiRemoteServer in a local render window and sends
+// the window's mouse and keyboard events back. Only the overlay is streamed, images
+// drawn with textures other than the font atlas are left out.
+//
+// The client owns its own ImGui context and renders with the OpenGL3 backend, it does
+// not need a vtkDearImGuiInjector. See src/imgui_vtk_remote_client.cxx.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiRemoteClient : public vtkObject
+{
+public:
+  static vtkDearImGuiRemoteClient* New();
+  vtkTypeMacro(vtkDearImGuiRemoteClient, vtkObject);
+
+  bool Connect(const char* address);
+  bool IsConnected() const { return this->Server.IsOpen(); }
+  // Observe the interactor and its render window. Events are forwarded instead of
+  // reaching the interactor style.
+  void Attach(vtkRenderWindowInteractor* interactor);
+
+  vtkGetMacro(ReceivedBytes, unsigned long long);
+
+protected:
+  vtkDearImGuiRemoteClient();
+  ~vtkDearImGuiRemoteClient() override;
+
+  void Poll();
+  void RenderOverlay(vtkObject* caller, unsigned long eid, void* callData);
+  void TearDown(vtkObject* caller, unsigned long eid, void* callData);
+  static void ForwardEvent(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+
+  ImGuiContext* Context = nullptr;
+  vtkWeakPointer<vtkRenderWindowInteractor> Interactor;
+  vtkNew<vtkCallbackCommand> EventCallbackCommand;
+  vtkDearImGuiRemoteProtocol::Connection Server;
+  std::vector<unsigned char> Payload;
+  std::vector<unsigned char> Previous;
+  std::vector<unsigned char> Current;
+  bool HasFrame = false;
+
+  std::vector<unsigned char> FontPixels;
+  int FontSize[2] = { 0, 0 };
+  bool FontModified = false;
+  unsigned int FontTexture = 0;
+  bool BackendReady = false;
+  std::vector<ImDrawList*> Lists;
+  ImDrawData DrawData;
+
+  unsigned long long ReceivedBytes = 0;
+
+private:
+  vtkDearImGuiRemoteClient(const vtkDearImGuiRemoteClient&) = delete;
+  void operator=(const vtkDearImGuiRemoteClient&) = delete;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <vtkdearimguiinjector_export.h>
+
+#include "imgui.h"
+
+class vtkRenderWindowInteractor;
+
+// Wire format shared by vtkDearImGuiRemoteServer and vtkDearImGuiRemoteClient.
+//
+// Every message is a MessageHeader followed by Size bytes. The server sends a Hello and
+// the font atlas once per connection, then one Frame message per rendered frame whose
+// draw data changed. A frame is the serialized ImDrawData diffed per draw list: each list
+// is paired with the previous frame's list of the same window, and its commands, vertices
+// and indices are XORed with the matching buffer and zero-run-length encoded, so the size
+// follows what changed on screen rather than the screen resolution. The client sends
+// Input messages back, the server replays those carrying an input event.
+//
+// Sockets are POSIX only. Addresses are "tcp://host:port" or "unix:///path". Servers
+// without a host, "tcp://:port", listen on 127.0.0.1 only, "tcp://*:port" on every interface.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiRemoteProtocol
+{
+public:
+  enum MessageTypes : std::uint32_t
+  {
+    HelloMessage = 1,
+    FontAtlasMessage,
+    FrameMessage,
+    InputMessage
+  };
+
+  struct MessageHeader
+  {
+    std::uint32_t Type;
+    std::uint32_t Size;
+  };
+
+  struct Hello
+  {
+    std::uint32_t Magic;
+    std::uint32_t Version;
+    std::uint32_t VertexSize; // sizeof(ImDrawVert)
+    std::uint32_t IndexSize;  // sizeof(ImDrawIdx)
+  };
+  static Hello MakeHello();
+  static bool IsCompatible(const Hello& hello);
+
+  // An interactor event, replayed with SetEventInformation() and InvokeEvent().
+  struct InputEvent
+  {
+    std::int32_t EventId;
+    std::int32_t Position[2];
+    std::int32_t ControlKey;
+    std::int32_t ShiftKey;
+    std::int32_t AltKey;
+    std::int32_t KeyCode;
+    std::int32_t RepeatCount;
+    char KeySym[32];
+  };
+
+  // Interactor events a client forwards, the ones vtkDearImGuiInjector::DispatchEv handles.
+  static bool IsInputEvent(unsigned long eventId);
+  static const unsigned long* GetInputEvents(int& count);
+
+  // Invoke event on interactor with its position, modifiers and key, the route local
+  // events take to vtkDearImGuiInjector::DispatchEv and the interactor style. Events
+  // other than input events are dropped and return false.
+  static bool ReplayInputEvent(const InputEvent& event, vtkRenderWindowInteractor* interactor);
+
+  // Texture ids do not cross processes. Commands drawing with the font atlas are tagged,
+  // commands drawing other textures are sent without texture.
+  enum TextureTokens : std::uint32_t
+  {
+    NoTexture = 0,
+    FontTexture = 1
+  };
+
+  // Draw data without callbacks, into out.
+  static void SerializeDrawData(
+    const ImDrawData* drawData, ImTextureID fontTexture, std::vector<unsigned char>& out);
+  // Rebuild draw data from a serialized frame. lists are reused across calls and need a
+  // current ImGui context. fontTexture replaces FontTexture tokens.
+  static bool DeserializeDrawData(const std::vector<unsigned char>& in, ImTextureID fontTexture,
+    std::vector<ImDrawList*>& lists, ImDrawData& drawData);
+
+  // Serialized frame current as a delta of previous, appended to out. previous may be
+  // empty, false if current is not a serialized frame.
+  static bool EncodeDelta(const std::vector<unsigned char>& previous,
+    const std::vector<unsigned char>& current, std::vector<unsigned char>& out);
+  // Inverse of EncodeDelta, replaces current.
+  static bool DecodeDelta(const std::vector<unsigned char>& previous, const unsigned char* data,
+    std::size_t size, std::vector<unsigned char>& current);
+
+  // A non-blocking socket with buffered, framed messages.
+  class VTKDEARIMGUIINJECTOR_EXPORT Connection
+  {
+  public:
+    Connection() = default;
+    ~Connection();
+    Connection(const Connection&) = delete;
+    void operator=(const Connection&) = delete;
+
+    bool Connect(const std::string& address);
+    void Adopt(int socket);
+    void Close();
+    bool IsOpen() const { return this->Socket >= 0; }
+
+    // Queue a message, sent by Flush(). Flush() and Receive() return false once the
+    // connection is closed.
+    void Queue(std::uint32_t type, const void* data, std::size_t size);
+    void Queue(std::uint32_t type, const std::vector<unsigned char>& payload)
+    {
+      this->Queue(type, payload.data(), payload.size());
+    }
+    bool Flush();
+    // Bytes waiting to be sent.
+    std::size_t GetPendingBytes() const { return this->Out.size() - this->OutOffset; }
+
+    // Read what arrived, a few MiB at most per call, then take complete messages one by
+    // one. A message larger than the protocol allows closes the connection.
+    bool Receive();
+    bool NextMessage(MessageHeader& header, std::vector<unsigned char>& payload);
+
+  private:
+    int Socket = -1;
+    std::vector<unsigned char> In;
+    std::size_t InOffset = 0;
+    std::vector<unsigned char> Out;
+    std::size_t OutOffset = 0;
+  };
+
+  // Non-blocking listening socket, -1 on failure.
+  static int Listen(const std::string& address);
+  // A connected socket or -1.
+  static int Accept(int listener);
+  static void CloseSocket(int socket, const std::string& address = std::string());
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+#include "vtkDearImGuiRemoteProtocol.h"
+
+class vtkRenderWindowInteractor;
+
+// Serves the overlay to one vtkDearImGuiRemoteClient at a time, see
+// vtkDearImGuiRemoteProtocol for the wire format.
+//
+// Everything runs on the UI thread without blocking: SendDrawData() queues the delta of
+// a frame, Poll() accepts clients, flushes what the socket takes and replays received
+// input on the interactor, where vtkDearImGuiInjector::DispatchEv picks it up like local
+// input. While the socket is backed up only the newest frame is kept.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiRemoteServer : public vtkObject
+{
+public:
+  static vtkDearImGuiRemoteServer* New();
+  vtkTypeMacro(vtkDearImGuiRemoteServer, vtkObject);
+
+  bool Listen(const char* address);
+  void Close();
+  bool IsListening() const { return this->Listener >= 0; }
+  bool IsConnected() const { return this->Client.IsOpen(); }
+
+  // Returns true when input was replayed.
+  bool Poll(vtkRenderWindowInteractor* interactor);
+  // With a current ImGui context, after ImGui::Render().
+  void SendDrawData(ImDrawData* drawData);
+
+  // Bytes of the last frame, serialized and as sent.
+  vtkGetMacro(LastFrameSize, unsigned long);
+  vtkGetMacro(LastEncodedFrameSize, unsigned long);
+  vtkGetMacro(SentBytes, unsigned long long);
+
+protected:
+  vtkDearImGuiRemoteServer();
+  ~vtkDearImGuiRemoteServer() override;
+
+  void Accept();
+  void SendPendingFrame();
+
+  std::string Address;
+  int Listener = -1;
+  vtkDearImGuiRemoteProtocol::Connection Client;
+  std::vector<unsigned char> Previous; // last frame sent to the client
+  std::vector<unsigned char> Current;
+  std::vector<unsigned char> Encoded;
+  std::vector<unsigned char> Payload;
+  bool FramePending = false; // Current waits for the socket
+  bool FontAtlasSent = false;
+
+  unsigned long LastFrameSize = 0;
+  unsigned long LastEncodedFrameSize = 0;
+  unsigned long long SentBytes = 0;
+
+private:
+  vtkDearImGuiRemoteServer(const vtkDearImGuiRemoteServer&) = delete;
+  void operator=(const vtkDearImGuiRemoteServer&) = delete;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkWeakPointer.h>
+#include <vtkdearimguiinjector_export.h>
+
+class vtkProp;
+class vtkRenderWindow;
+class vtkRenderer;
+
+// Accounts for the memory held by the props of a render window and by the overlay.
+//
+// Per prop, the monitor adds up the CPU memory of the mapper inputs, as reported by
+// vtkDataObject::GetActualMemorySize(), and estimates the vertex and index buffers the
+// OpenGL mappers build from them and the textures bound to the prop. Props are only
+// measured again when the prop, its mapper or its input changed, and the list of props
+// is only rebuilt when the renderers or their props were added or removed. Per window, it
+// estimates the render and display framebuffers and counts the shader programs alive
+// in the context. The injector reports the overlay's own resources, e.g. the font
+// atlas, with SetOverlayResource().
+//
+// VTK does not expose its buffer objects, so buffer and framebuffer sizes are
+// estimates from the data and the window size, not queried from the driver. Inputs
+// shared by several props count once in the totals.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiResourceMonitor : public vtkObject
+{
+public:
+  static vtkDearImGuiResourceMonitor* New();
+  vtkTypeMacro(vtkDearImGuiResourceMonitor, vtkObject);
+
+  enum Categories
+  {
+    Datasets = 0, // CPU memory of the mapper inputs
+    Buffers,      // vertex and index buffers
+    Textures,
+    Framebuffers,
+    Programs,
+    Overlay, // resources of the ImGui backend and the injector
+    NumberOfCategories
+  };
+  static const char* GetCategoryName(int category);
+
+  struct Usage
+  {
+    std::string Label;
+    std::size_t Bytes[NumberOfCategories] = { 0, 0, 0, 0, 0, 0 };
+    std::size_t GetGraphicsBytes() const;
+    std::size_t GetTotal() const { return this->Bytes[Datasets] + this->GetGraphicsBytes(); }
+  };
+
+  struct PropUsage : Usage
+  {
+    vtkWeakPointer<vtkProp> Prop;
+    vtkWeakPointer<vtkRenderer> Renderer;
+    std::string RendererLabel;
+    const void* Data = nullptr; // input counted in Bytes[Datasets]
+    vtkMTimeType Time = 0;      // newest time of the prop, its mapper and input
+  };
+
+  struct RendererUsage : Usage
+  {
+    vtkWeakPointer<vtkRenderer> Renderer;
+    int NumberOfProps = 0;
+  };
+
+  // Measure the props that changed since the last update. Render thread, with the
+  // OpenGL context of the window current.
+  void Update(vtkRenderWindow* renderWindow);
+  // Measure everything again in the next Update().
+  void Refresh();
+
+  // Bytes held by a named overlay resource, 0 removes it.
+  void SetOverlayResource(const char* name, std::size_t bytes);
+
+  std::size_t GetTotal(int category) const;
+  std::size_t GetGraphicsTotal() const;
+  const std::vector<PropUsage>& GetProps() const { return this->Props; }
+  const std::vector<RendererUsage>& GetRenderers() const { return this->Renderers; }
+  // The count props holding the most memory, largest first.
+  std::vector<const PropUsage*> GetTopProps(int count) const;
+  int GetNumberOfPrograms() const { return this->NumberOfPrograms; }
+  // Props measured in the last Update(), the others kept their figures.
+  int GetNumberOfMeasuredProps() const { return this->NumberOfMeasuredProps; }
+
+  vtkSetClampMacro(NumberOfTopProps, int, 1, 100);
+  vtkGetMacro(NumberOfTopProps, int);
+
+  // Totals, renderers and top props in the current ImGui window.
+  void Draw();
+
+protected:
+  vtkDearImGuiResourceMonitor();
+  ~vtkDearImGuiResourceMonitor() override;
+
+  void Rebuild(vtkRenderWindow* renderWindow, bool refresh);
+  void MeasureProp(PropUsage& usage);
+  void MeasureWindow(vtkRenderWindow* renderWindow);
+  void SumRenderers();
+  void Total();
+
+  vtkWeakPointer<vtkRenderWindow> RenderWindow;
+  vtkMTimeType WindowTime = 0;
+  int WindowSize[2] = { 0, 0 };
+  bool RefreshRequested = true;
+  bool OverlayModified = true;
+  vtkMTimeType PropsTime = 0; // newest time of the renderer and prop collections
+
+  // props of the renderers in order, each renderer's NumberOfProps at a time
+  std::vector<PropUsage> Props;
+  // index in Props, by prop
+  std::unordered_map<const vtkProp*, std::size_t> Cache;
+  std::vector<RendererUsage> Renderers;
+  std::map<std::string, std::size_t> OverlayResources;
+  std::size_t WindowBytes[NumberOfCategories] = { 0, 0, 0, 0, 0, 0 };
+  std::size_t Totals[NumberOfCategories] = { 0, 0, 0, 0, 0, 0 };
+  int NumberOfPrograms = 0;
+  int NumberOfMeasuredProps = 0;
+  int NumberOfTopProps = 10;
+
+private:
+  vtkDearImGuiResourceMonitor(const vtkDearImGuiResourceMonitor&) = delete;
+  void operator=(const vtkDearImGuiResourceMonitor&) = delete;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+struct ImDrawCmd;
+struct ImDrawData;
+struct ImDrawList;
+struct ImFont;
+struct ImFontAtlas;
+
+// Signed distance field fonts, one atlas for every size and display scale.
+//
+// Glyphs are rasterized once as distance fields at BaseSize pixels, Spread pixels of
+// distance around the outline, into custom rects of the ImGui font atlas. Prepare()
+// switches the OpenGL backend to a shader that thresholds the field for commands
+// drawing from the atlas and back for the others, so text stays sharp at any size.
+// SetSize() only changes the scale of the fonts: neither font size nor DPI changes
+// rebuild or upload the atlas again.
+//
+// The injector builds the atlas after ImGuiSetupEvent and prepares every frame, add
+// fonts from ImGuiSetupEvent observers, see vtkDearImGuiInjector::GetSDFFont().
+// Raster fonts may share the atlas, they look slightly bolder through the shader.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiSDFFont : public vtkObject
+{
+public:
+  static vtkDearImGuiSDFFont* New();
+  vtkTypeMacro(vtkDearImGuiSDFFont, vtkObject);
+
+  // Pixel height glyphs are rasterized at and distance range around the outline. Set
+  // before adding fonts.
+  vtkSetClampMacro(BaseSize, float, 8.f, 128.f);
+  vtkGetMacro(BaseSize, float);
+  vtkSetClampMacro(Spread, int, 1, 16);
+  vtkGetMacro(Spread, int);
+
+  // Add a font to atlas from TTF data, which is copied. ranges lists inclusive pairs of
+  // code points ending with 0, Basic Latin and Latin-1 when null. Returns nullptr if the
+  // data is not a font.
+  ImFont* AddFontFromMemoryTTF(
+    ImFontAtlas* atlas, const void* data, int size, const unsigned int* ranges = nullptr);
+  ImFont* AddFontFromFileTTF(
+    ImFontAtlas* atlas, const char* fileName, const unsigned int* ranges = nullptr);
+  bool HasFonts() const { return !this->Fonts.empty(); }
+
+  // Build the atlas and write the distance fields into it, before the backend creates
+  // the font texture. Build again after the atlas changed.
+  bool Build(ImFontAtlas* atlas);
+
+  // Display height of the fonts in pixels, takes effect on the next frame.
+  void SetSize(float pixels);
+  float GetSize() const { return this->Size; }
+
+  // Insert shader switches around the commands drawing from the font atlas. Right
+  // before the draw data is rendered.
+  void Prepare(ImDrawData* drawData);
+  void ReleaseGraphicsResources();
+
+protected:
+  vtkDearImGuiSDFFont();
+  ~vtkDearImGuiSDFFont() override;
+
+  // ImDrawCallback binding the distance field program.
+  static void UseProgram(const ImDrawList* list, const ImDrawCmd* cmd);
+  bool CreateProgram();
+
+  struct Glyph
+  {
+    int Rect = -1; // custom rect of the atlas
+    int Width = 0;
+    int Height = 0;
+    std::vector<unsigned char> Distances;
+  };
+  struct Font
+  {
+    ImFont* Handle = nullptr;
+    std::vector<unsigned char> Data; // TTF, the atlas reads it while building
+    std::vector<Glyph> Glyphs;
+  };
+  std::vector<Font> Fonts;
+
+  float BaseSize = 32.f;
+  int Spread = 4;
+  float Size = 16.f;
+
+  unsigned int Program = 0;
+  bool ProgramFailed = false;
+  int ProjectionLocation = -1;
+  int TextureLocation = -1;
+  float Projection[16];
+
+private:
+  vtkDearImGuiSDFFont(const vtkDearImGuiSDFFont&) = delete;
+  void operator=(const vtkDearImGuiSDFFont&) = delete;
+};
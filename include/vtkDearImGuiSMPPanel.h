@@ -0,0 +1,113 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+// Switches the vtkSMPTools backend and thread count at runtime and times a suite of
+// SMP filters under each configuration.
+//
+// The suite contours, cuts and colors by elevation a wavelet image with Resolution^3
+// points, and computes normals of the contour. Every filter runs Repetitions times
+// and the best time is kept. Each configuration is timed on a worker thread so the
+// overlay stays responsive. Step(), which the injector calls once per frame on the UI
+// thread, collects the timings and changes the backend between configurations, while
+// the worker is idle. The configuration in effect before a run is restored after it.
+//
+// Changing the backend needs VTK 9.1 or later, older versions only change the number
+// of threads.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiSMPPanel : public vtkObject
+{
+public:
+  static vtkDearImGuiSMPPanel* New();
+  vtkTypeMacro(vtkDearImGuiSMPPanel, vtkObject);
+
+  enum Filters
+  {
+    Contour = 0,
+    Cut,
+    Elevation,
+    Normals,
+    NumberOfFilters
+  };
+  static const char* GetFilterName(int filter);
+
+  struct Configuration
+  {
+    std::string Backend;
+    int NumberOfThreads = 0; // 0 uses every core
+  };
+
+  struct Timing
+  {
+    Configuration Setup;
+    int Resolution = 0;
+    double Seconds[NumberOfFilters] = { 0., 0., 0., 0. };
+    double Total = 0.;
+  };
+
+  // Backends compiled into VTK, among "Sequential", "STDThread", "TBB" and "OpenMP".
+  static std::vector<std::string> GetAvailableBackends();
+  static std::string GetBackend();
+  // Returns false if the backend is not available.
+  bool SetBackend(const char* name);
+  // 0 uses every core.
+  void SetNumberOfThreads(int numberOfThreads);
+  int GetNumberOfThreads() const { return this->NumberOfThreads; }
+  static int GetEstimatedNumberOfThreads();
+
+  vtkSetClampMacro(Resolution, int, 16, 512);
+  vtkGetMacro(Resolution, int);
+  vtkSetClampMacro(Repetitions, int, 1, 100);
+  vtkGetMacro(Repetitions, int);
+
+  // Runs a closure on the UI thread, returns false if it could not be queued. The
+  // worker posts empty closures to wake the event loop, e.g. with
+  // vtkDearImGuiInjector::PostCommand(). Without one Step() asks for every frame.
+  using PostFunction = std::function<bool(std::function<void()>)>;
+  void SetPostFunction(PostFunction post);
+
+  // Queue the suite for each configuration. Returns false while a run is going on.
+  bool Run(const std::vector<Configuration>& configurations);
+  // Every available backend with 1, 2, 4, ... threads up to the number of cores.
+  bool RunSweep();
+  // The filter being timed finishes first.
+  void Cancel();
+  bool IsRunning() const;
+  // Fraction of the queued filters that ran, 1 when idle.
+  double GetProgress() const;
+
+  // Collect the timings of the worker and start the next configuration. Returns true
+  // when the overlay should be redrawn.
+  bool Step();
+
+  const std::vector<Timing>& GetTimings() const { return this->Timings; }
+  void ClearTimings() { this->Timings.clear(); }
+
+  // Controls and timings in the current ImGui window.
+  void Draw();
+
+protected:
+  vtkDearImGuiSMPPanel();
+  ~vtkDearImGuiSMPPanel() override;
+
+  void Apply(const Configuration& configuration);
+  // End the run and restore the saved configuration.
+  void Finish();
+
+  int NumberOfThreads = 0;
+  int Resolution = 128;
+  int Repetitions = 3;
+  std::vector<Timing> Timings;
+
+  struct vtkInternals;
+  std::unique_ptr<vtkInternals> Internals;
+
+private:
+  vtkDearImGuiSMPPanel(const vtkDearImGuiSMPPanel&) = delete;
+  void operator=(const vtkDearImGuiSMPPanel&) = delete;
+};
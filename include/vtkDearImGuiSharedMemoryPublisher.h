@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+#include "vtkDearImGuiRemoteProtocol.h"
+
+class vtkRenderWindowInteractor;
+
+// Publishes composed frames (scene and overlay) to a POSIX shared memory ring and
+// takes input from a queue in the same segment, for headless servers feeding another
+// local process such as a streaming gateway.
+//
+// The segment starts with a RingHeader, followed by InputCapacity InputEvents and
+// NumberOfSlots frame slots of SlotSize bytes. Each slot is a SlotHeader with RGBA8
+// pixels (rows bottom to top) at PixelOffset. Frames get increasing sequence numbers,
+// frame n goes to slot n % NumberOfSlots. A slot's Sequence is 0 while it is written.
+// Readers map the segment and use the pixels in place, see Reader.
+//
+// vtkDearImGuiInjector::StartPublishing() feeds the ring from vtkDearImGuiFrameCapture
+// and replays the input queue on the interactor.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiSharedMemoryPublisher : public vtkObject
+{
+public:
+  static vtkDearImGuiSharedMemoryPublisher* New();
+  vtkTypeMacro(vtkDearImGuiSharedMemoryPublisher, vtkObject);
+
+  static const std::uint32_t Magic = 0x56464d52; // "RMFV"
+  static const std::uint32_t Version = 1;
+  static const std::uint64_t PixelOffset = 64;
+
+  struct RingHeader
+  {
+    std::uint32_t Magic;
+    std::uint32_t Version;
+    std::uint32_t NumberOfSlots;
+    std::uint32_t InputCapacity;
+    std::uint32_t MaximumSize[2];
+    std::uint64_t SlotSize;
+    std::uint64_t SlotsOffset;
+    std::atomic<std::uint64_t> Published; // newest complete frame, 0 before the first
+    std::atomic<std::uint32_t> InputWrite; // advanced by the reader process
+    std::atomic<std::uint32_t> InputRead;  // advanced by the publisher
+  };
+
+  // Addressing fields of a RingHeader, copied when the segment is opened. The mapping
+  // is writable by every reader, so the copies are used instead of the header.
+  struct Layout
+  {
+    std::uint32_t NumberOfSlots = 0;
+    std::uint32_t InputCapacity = 0;
+    std::uint64_t SlotSize = 0;
+    std::uint64_t SlotsOffset = 0;
+  };
+
+  struct SlotHeader
+  {
+    std::atomic<std::uint64_t> Sequence;
+    std::uint32_t Width;
+    std::uint32_t Height;
+    std::uint64_t Time; // microseconds, steady clock
+  };
+
+  // name as for shm_open, e.g. "/vtk_frames". Frames larger than the maximum size
+  // are dropped.
+  bool Open(const char* name, int maximumWidth, int maximumHeight, int numberOfSlots = 3);
+  void Close();
+  bool IsOpen() const { return this->Header != nullptr; }
+
+  // Copy a frame into the next slot. One thread at a time.
+  void Publish(const unsigned char* rgba, int width, int height);
+  // UI thread. Replays queued input, returns true when there was some.
+  bool PollInput(vtkRenderWindowInteractor* interactor);
+
+  unsigned long GetPublishedFrames() const { return this->PublishedFrames.load(); }
+  unsigned long GetDroppedFrames() const { return this->DroppedFrames.load(); }
+
+  // Maps a published ring in another process.
+  class VTKDEARIMGUIINJECTOR_EXPORT Reader
+  {
+  public:
+    struct Frame
+    {
+      const unsigned char* Pixels = nullptr; // in the shared segment
+      int Width = 0;
+      int Height = 0;
+      std::uint64_t Sequence = 0;
+      std::uint64_t Time = 0;
+    };
+
+    Reader() = default;
+    ~Reader();
+    Reader(const Reader&) = delete;
+    void operator=(const Reader&) = delete;
+
+    bool Open(const char* name);
+    void Close();
+
+    // The newest frame if it is newer than the frame passed in.
+    bool Acquire(Frame& frame);
+    // Whether the frame's slot still holds it, i.e. what was read from Pixels is intact.
+    bool IsValid(const Frame& frame) const;
+    // Queue an event for the publisher. Returns false when the queue is full.
+    bool PostInput(const vtkDearImGuiRemoteProtocol::InputEvent& event);
+
+  private:
+    RingHeader* Header = nullptr;
+    std::size_t Size = 0;
+    Layout Addressing;
+  };
+
+protected:
+  vtkDearImGuiSharedMemoryPublisher();
+  ~vtkDearImGuiSharedMemoryPublisher() override;
+
+  std::mutex Mutex; // Publish() against Close()
+  std::string Name;
+  RingHeader* Header = nullptr;
+  std::size_t Size = 0;
+  Layout Addressing;
+  std::uint32_t MaximumSize[2] = { 0, 0 };
+  std::uint32_t InputRead = 0;
+  std::uint64_t Sequence = 0;
+  std::atomic<unsigned long> PublishedFrames{ 0 };
+  std::atomic<unsigned long> DroppedFrames{ 0 };
+
+private:
+  vtkDearImGuiSharedMemoryPublisher(const vtkDearImGuiSharedMemoryPublisher&) = delete;
+  void operator=(const vtkDearImGuiSharedMemoryPublisher&) = delete;
+};
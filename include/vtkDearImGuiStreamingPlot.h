@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+// Live time-series plot for ImGuiDrawEvent observers.
+//
+// Every channel stores its samples in a ring buffer that a producer thread appends to
+// without locks. At draw time the visible samples are reduced to one bucket per pixel
+// column, so the number of vertices handed to ImGui depends on the plot width and not
+// on the number of samples.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiStreamingPlot : public vtkObject
+{
+public:
+  static vtkDearImGuiStreamingPlot* New();
+  vtkTypeMacro(vtkDearImGuiStreamingPlot, vtkObject);
+
+  // Add a channel that keeps the last capacity samples (rounded up to a power of two).
+  // color is an ImU32, 0 picks one from a palette. Returns the channel index.
+  // Channels must be added before producers start appending.
+  int AddChannel(const char* name, vtkIdType capacity, unsigned int color = 0);
+  int GetNumberOfChannels() const { return static_cast<int>(this->Channels.size()); }
+  // Total number of samples ever appended to a channel.
+  vtkIdType GetNumberOfSamples(int channel) const;
+
+  // Append samples. Each channel supports one producer thread at a time; distinct
+  // channels may be fed from distinct threads. Never blocks, the oldest samples are
+  // overwritten.
+  void Append(int channel, float value);
+  void Append(int channel, const float* values, vtkIdType count);
+
+  enum DecimationModes
+  {
+    MinMax = 0,                 // min/max envelope per pixel column, keeps spikes
+    LargestTriangleThreeBuckets // one point per column, keeps the visual shape
+  };
+  vtkSetClampMacro(DecimationMode, int, MinMax, LargestTriangleThreeBuckets);
+  vtkGetMacro(DecimationMode, int);
+
+  // Number of most recent samples shown, 0 shows everything the rings hold.
+  vtkSetClampMacro(VisibleSamples, vtkIdType, 0, VTK_ID_MAX);
+  vtkGetMacro(VisibleSamples, vtkIdType);
+
+  // Fixed vertical range. The range follows the data when YRange[0] >= YRange[1].
+  vtkSetVector2Macro(YRange, float);
+  vtkGetVector2Macro(YRange, float);
+
+  // Draw in the current ImGui window. width <= 0 fills the available width.
+  void Draw(const char* label, float width = 0.f, float height = 150.f);
+
+  // Decimation kernels.
+  // Reduce n values to columns (min, max) pairs.
+  static void DecimateMinMax(
+    const float* values, vtkIdType n, int columns, float* outMin, float* outMax);
+  // Pick threshold representative points of n values, x being the sample index.
+  // Returns the number of points written.
+  static vtkIdType DecimateLTTB(
+    const float* values, vtkIdType n, vtkIdType threshold, float* outX, float* outY);
+
+protected:
+  vtkDearImGuiStreamingPlot();
+  ~vtkDearImGuiStreamingPlot() override;
+
+  struct Channel
+  {
+    std::string Name;
+    unsigned int Color = 0;
+    std::unique_ptr<float[]> Data;
+    vtkIdType Mask = 0;
+    std::atomic<vtkIdType> Head{ 0 };    // written by the producer only
+    std::atomic<vtkIdType> Writing{ 0 }; // Head once the running Append() completes
+  };
+
+  // Copy the most recent samples of a channel into Scratch. Returns the count.
+  vtkIdType Snapshot(const Channel& channel, vtkIdType count);
+
+  std::vector<std::unique_ptr<Channel>> Channels;
+  int DecimationMode = MinMax;
+  vtkIdType VisibleSamples = 0;
+  float YRange[2] = { 0.f, 0.f };
+
+  // draw-time buffers, reused across frames
+  std::vector<float> Scratch;
+  std::vector<std::vector<float>> ColumnsA;
+  std::vector<std::vector<float>> ColumnsB;
+  std::vector<vtkIdType> Counts;
+
+private:
+  vtkDearImGuiStreamingPlot(const vtkDearImGuiStreamingPlot&) = delete;
+  void operator=(const vtkDearImGuiStreamingPlot&) = delete;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vtkdearimguiinjector_export.h>
+
+// Resizable tables with stretched columns for the overlay panels.
+//
+// ImGui 1.80 and later draw them with ImGui tables. Older versions, such as the Adobe
+// Spectrum fork, lay the rows out with the legacy columns API: the header row scrolls
+// with the others and rows have no alternating background.
+//
+// Calls follow the ImGui tables API, one table at a time on the UI thread:
+//   if (vtkDearImGuiTable::Begin("##rows", 2))
+//   {
+//     vtkDearImGuiTable::SetupColumn("Name", 1.f);
+//     vtkDearImGuiTable::SetupColumn("Size", 0.4f);
+//     vtkDearImGuiTable::HeadersRow();
+//     vtkDearImGuiTable::NextRow();
+//     vtkDearImGuiTable::NextColumn();
+//     ...
+//     vtkDearImGuiTable::End();
+//   }
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiTable
+{
+public:
+  enum Flags
+  {
+    RowBackground = 1,
+    // Scroll inside the available height, the header row stays in view with tables.
+    ScrollY = 2
+  };
+
+  // Call End() only if this returns true.
+  static bool Begin(const char* id, int columns, int flags = RowBackground);
+  // weight is the share of the width the column gets.
+  static void SetupColumn(const char* label, float weight);
+  static void HeadersRow();
+  static void NextRow();
+  static void NextColumn();
+  // Tint the current row, color is an ImU32.
+  static void SetRowColor(unsigned int color);
+  static void End();
+};
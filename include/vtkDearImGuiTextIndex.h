@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vtkdearimguiinjector_export.h>
+
+// Case-insensitive substring and subsequence search over a set of strings, for filter
+// boxes over large lists and fuzzy pickers.
+//
+// Every entry is split into trigrams when it is added. A query of three or more
+// characters only verifies the entries of its rarest trigram instead of scanning them
+// all. Refine() narrows down earlier results when a query grows while typing.
+// Subsequence queries skip entries lacking one of the query's characters with a
+// per-entry character mask before matching.
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiTextIndex
+{
+public:
+  void Clear();
+  // Ids are consecutive, starting at 0.
+  int Add(const std::string& text);
+  int GetNumberOfEntries() const { return static_cast<int>(this->Texts.size()); }
+  // Lower case copy of an entry.
+  const std::string& GetText(int id) const { return this->Texts[id]; }
+
+  // Ids of the entries containing query, ascending. An empty query matches everything.
+  void Find(const char* query, std::vector<int>& ids) const;
+  // Ids among candidates (ascending) of the entries containing query. Results of a
+  // query are the candidates of any query containing it.
+  void Refine(const char* query, const std::vector<int>& candidates, std::vector<int>& ids) const;
+  // Ids of the entries containing the characters of query in order, ascending.
+  void FindSubsequence(const char* query, std::vector<int>& ids) const;
+
+  // Subsequence match quality of a lower case query in a lower case text, higher is
+  // better, -1 when it does not match. Runs of characters and word starts score more.
+  static int Score(const std::string& text, const std::string& query);
+
+  static std::string ToLower(const char* text);
+
+protected:
+  static std::uint32_t Trigram(const char* text)
+  {
+    return static_cast<std::uint32_t>(static_cast<unsigned char>(text[0])) |
+      static_cast<std::uint32_t>(static_cast<unsigned char>(text[1])) << 8 |
+      static_cast<std::uint32_t>(static_cast<unsigned char>(text[2])) << 16;
+  }
+
+  static std::uint64_t CharacterMask(const std::string& text);
+
+  std::vector<std::string> Texts;
+  std::vector<std::uint64_t> Masks;
+  // entries containing each trigram, ascending
+  std::unordered_map<std::uint32_t, std::vector<int>> Postings;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkdearimguiinjector_export.h>
+
+// Records spans into per-thread lock-free buffers and writes them to a Chrome
+// trace-event JSON file from a background thread. Open the file in
+// https://ui.perfetto.dev or chrome://tracing.
+//
+// Spans can be recorded from any thread while a tracer is active:
+//   vtkDearImGuiTracer::Scope scope("Rebuild LUT");
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiTracer : public vtkObject
+{
+public:
+  static vtkDearImGuiTracer* New();
+  vtkTypeMacro(vtkDearImGuiTracer, vtkObject);
+
+  // Start writing a trace to fileName and make this the active tracer.
+  bool Start(const char* fileName);
+  // Flush remaining events and close the file.
+  void Stop();
+  bool IsTracing() const { return this->File != nullptr; }
+  // Write buffered events from the calling thread. Only needed on builds without
+  // thread support, where there is no background writer.
+  void Poll();
+
+  // Events dropped because a thread buffer was full.
+  unsigned long GetNumberOfDroppedEvents() const { return this->DroppedEvents.load(); }
+
+  // The tracer spans are recorded to, nullptr when none is active.
+  static vtkDearImGuiTracer* GetActive() { return ActiveTracer.load(std::memory_order_acquire); }
+
+  // Microseconds on the trace clock.
+  static double Now();
+
+  // Record a span of the calling thread. name is copied, category must be a literal.
+  static void AddSpan(const char* name, const char* category, double begin, double end);
+
+  // Label the calling thread in the trace viewer.
+  static void SetThreadName(const char* name);
+
+  // Records a span from construction to destruction.
+  class Scope
+  {
+  public:
+    Scope(const char* name, const char* category = "user")
+      : Name(name)
+      , Category(category)
+      , Begin(GetActive() ? Now() : -1.)
+    {
+    }
+    ~Scope()
+    {
+      if (this->Begin >= 0.)
+      {
+        AddSpan(this->Name, this->Category, this->Begin, Now());
+      }
+    }
+
+  private:
+    Scope(const Scope&) = delete;
+    void operator=(const Scope&) = delete;
+    const char* Name;
+    const char* Category;
+    double Begin;
+  };
+
+  struct Event;
+  struct ThreadBuffer;
+  struct ProducerGuard;
+
+protected:
+  vtkDearImGuiTracer();
+  ~vtkDearImGuiTracer() override;
+
+  ThreadBuffer* GetThreadBuffer();
+  void FlushLoop();
+  void Flush();
+
+  static std::atomic<vtkDearImGuiTracer*> ActiveTracer;
+  static std::atomic<unsigned int> Generation;
+  // Threads between loading ActiveTracer and their last use of it, Stop() waits for them.
+  static std::atomic<int> Producers;
+
+  std::FILE* File = nullptr;
+  unsigned int TraceGeneration = 0;
+  std::atomic<unsigned long> DroppedEvents{ 0 };
+
+  std::mutex BuffersMutex; // guards Buffers registration
+  std::vector<std::shared_ptr<ThreadBuffer>> Buffers;
+
+  std::thread Flusher;
+  std::mutex FlusherMutex;
+  std::condition_variable FlusherCondition;
+  bool StopFlusher = false;
+
+private:
+  vtkDearImGuiTracer(const vtkDearImGuiTracer&) = delete;
+  void operator=(const vtkDearImGuiTracer&) = delete;
+};
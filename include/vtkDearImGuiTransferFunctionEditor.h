@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+#include <vtkdearimguiinjector_export.h>
+
+class vtkColorTransferFunction;
+class vtkDataArray;
+class vtkPiecewiseFunction;
+
+// Editor for the color and opacity transfer functions of a volume, drawn over a
+// histogram of the data.
+//
+// Widgets edit a copy of the nodes. Commit(), called by the injector once per frame,
+// writes the edited node into the functions with a single SetNodeValue() (the
+// functions are not pipeline inputs, nothing re-executes) and re-samples only the part
+// of the lookup table between the node's neighbors. Upload() patches that range of the
+// lookup texture with glTexSubImage2D, and the color strip of the editor draws that
+// texture.
+//
+// The histogram is computed with vtkSMPTools, once per array MTime.
+//
+// Create instances with vtkDearImGuiInjector::CreateTransferFunctionEditor().
+class VTKDEARIMGUIINJECTOR_EXPORT vtkDearImGuiTransferFunctionEditor : public vtkObject
+{
+public:
+  static vtkDearImGuiTransferFunctionEditor* New();
+  vtkTypeMacro(vtkDearImGuiTransferFunctionEditor, vtkObject);
+
+  void SetColorTransferFunction(vtkColorTransferFunction* function);
+  vtkColorTransferFunction* GetColorTransferFunction() const;
+  void SetScalarOpacity(vtkPiecewiseFunction* function);
+  vtkPiecewiseFunction* GetScalarOpacity() const;
+
+  // Histogram source, usually the volume scalars. Its range is the editor range,
+  // otherwise the range of the functions is used.
+  void SetHistogramArray(vtkDataArray* array, int component = 0);
+  vtkSetClampMacro(NumberOfBins, int, 8, 4096);
+  vtkGetMacro(NumberOfBins, int);
+  const std::vector<vtkIdType>& GetHistogram() const { return this->Histogram; }
+
+  // Draw in the current ImGui window. width <= 0 fills the available width. Drag points
+  // to edit, double-click to add one, right-click to remove one. Returns true if an edit
+  // was staged.
+  bool Draw(const char* label, float width = 0.f, float height = 150.f);
+
+  // Write staged edits into the functions. Returns the number of functions modified.
+  int Commit();
+
+  // RGBA lookup texture of TableSize texels over the editor range.
+  static const int TableSize = 256;
+  unsigned int GetLookupTexture() const { return this->Texture; }
+  std::size_t GetGraphicsMemorySize() const { return this->Texture ? TableSize * 4 : 0; }
+  // Render thread, with the OpenGL context current.
+  void Upload();
+  void ReleaseGraphicsResources();
+
+protected:
+  vtkDearImGuiTransferFunctionEditor();
+  ~vtkDearImGuiTransferFunctionEditor() override;
+
+  enum Functions
+  {
+    OpacityFunction = 0,
+    ColorFunction,
+    NumberOfFunctions
+  };
+
+  // Node values as in GetNodeValue(): x, y, midpoint, sharpness for opacity and
+  // x, r, g, b, midpoint, sharpness for colors.
+  struct Node
+  {
+    double Value[6];
+  };
+
+  // Copy the nodes of functions modified outside the editor.
+  void Synchronize();
+  void UpdateHistogram();
+  // Re-sample table entries [begin, end) and mark them for upload.
+  void UpdateTable(int begin, int end);
+  int TableIndex(double x) const;
+  // Interaction with the nodes of function in the last item, whose screen rectangle is
+  // x0, y0, x1, y1. Returns true if an edit was staged.
+  bool EditNodes(int function, const float rect[4]);
+  void StageEdit(int function, int node);
+
+  vtkSmartPointer<vtkColorTransferFunction> Color;
+  vtkSmartPointer<vtkPiecewiseFunction> Opacity;
+  std::vector<Node> Nodes[NumberOfFunctions];
+  vtkMTimeType SynchronizedTime[NumberOfFunctions] = { 0, 0 };
+  // edited node per function, -1 for none, -2 when nodes were added or removed
+  int EditedNode[NumberOfFunctions] = { -1, -1 };
+  int ActiveNode[NumberOfFunctions] = { -1, -1 };
+  int SelectedColorNode = -1;
+
+  vtkSmartPointer<vtkDataArray> HistogramArray;
+  int HistogramComponent = 0;
+  int NumberOfBins = 256;
+  std::vector<vtkIdType> Histogram;
+  vtkMTimeType HistogramTime = 0;
+  int HistogramBins = 0;
+  double Range[2] = { 0., 1. };
+
+  std::vector<unsigned char> Table;
+  double TableRange[2] = { 0., 0. };
+  int DirtyBegin = 0;
+  int DirtyEnd = 0;
+  unsigned int Texture = 0;
+
+private:
+  vtkDearImGuiTransferFunctionEditor(const vtkDearImGuiTransferFunctionEditor&) = delete;
+  void operator=(const vtkDearImGuiTransferFunctionEditor&) = delete;
+};
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "vtkDearImGuiInjector.h"
+
+#include "vtkCommand.h"
+#include "vtkGenericOpenGLRenderWindow.h"
+#include "vtkGenericRenderWindowInteractor.h"
+#include "vtkInteractorStyleTrackballCamera.h"
+#include "vtkNew.h"
+#include "vtkRenderer.h"
+
+//------------------------------------------------------------------------------
+// Cost of routing interactor events through vtkDearImGuiInjector.
+// Usage: imgui_vtk_dispatch_benchmark [events per measurement]
+// Needs no display: the render window is never rendered. Each event is invoked on the
+// interactor with and without the injector's observers, the difference is the cost of
+// the injector's dispatch.
+//------------------------------------------------------------------------------
+
+namespace
+{
+struct BenchmarkEvent
+{
+  unsigned long Id;
+  int Control;
+  int Shift;
+  const char* KeySym;
+};
+
+// Best time per event of a few rounds, in nanoseconds. Nothing renders the frames that
+// would apply the routed events, the queue is emptied before each round instead.
+double Measure(vtkRenderWindowInteractor* interactor, const BenchmarkEvent& event, int count,
+  vtkDearImGuiInputQueue* queue)
+{
+  using namespace std::chrono;
+  interactor->SetEventInformation(200, 150, event.Control, event.Shift, 0, 0, event.KeySym);
+  double best = -1.;
+  for (int round = 0; round < 5; ++round)
+  {
+    queue->Clear();
+    const auto start = steady_clock::now();
+    for (int i = 0; i < count; ++i)
+    {
+      interactor->InvokeEvent(event.Id, nullptr);
+    }
+    const double time = duration<double, std::nano>(steady_clock::now() - start).count() / count;
+    best = best < 0. ? time : std::min(best, time);
+  }
+  return best;
+}
+}
+
+int main(int argc, char* argv[])
+{
+  const int count = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100000;
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkGenericOpenGLRenderWindow> renderWindow;
+  vtkNew<vtkGenericRenderWindowInteractor> iren;
+  vtkNew<vtkInteractorStyleTrackballCamera> style;
+  renderWindow->AddRenderer(renderer);
+  renderWindow->SetSize(400, 300);
+  iren->SetRenderWindow(renderWindow);
+  iren->SetInteractorStyle(style);
+  // camera interaction must not render without a context
+  iren->EnableRenderOff();
+
+  vtkNew<vtkDearImGuiInjector> dearImGuiOverlay;
+
+  const BenchmarkEvent events[] = {
+    { vtkCommand::MouseMoveEvent, 0, 0, nullptr },
+    { vtkCommand::LeftButtonPressEvent, 0, 0, nullptr },
+    { vtkCommand::LeftButtonReleaseEvent, 0, 0, nullptr },
+    { vtkCommand::MouseWheelForwardEvent, 0, 0, nullptr },
+    { vtkCommand::KeyPressEvent, 0, 0, "F7" },
+    { vtkCommand::KeyReleaseEvent, 0, 0, "F7" },
+    // a registered shortcut, which is not passed on
+    { vtkCommand::KeyPressEvent, 1, 1, "F8" },
+    { vtkCommand::CharEvent, 0, 0, "" },
+    { vtkCommand::TimerEvent, 0, 0, nullptr },
+    { vtkCommand::ExposeEvent, 0, 0, nullptr },
+  };
+  dearImGuiOverlay->AddAction("Benchmark/Shortcut", []() {}, "Ctrl+Shift+F8");
+
+  std::printf("%d events per measurement, best of 5\n", count);
+  std::printf("%-28s %10s %10s %10s\n", "event", "style ns", "routed ns", "added ns");
+  for (const BenchmarkEvent& event : events)
+  {
+    const double styleOnly = Measure(iren, event, count, dearImGuiOverlay->GetInputQueue());
+    dearImGuiOverlay->InstallEventCallback(iren);
+    const double routed = Measure(iren, event, count, dearImGuiOverlay->GetInputQueue());
+    dearImGuiOverlay->UninstallEventCallback();
+    std::string name = vtkCommand::GetStringFromEventId(event.Id);
+    if (event.Control)
+    {
+      name += " (shortcut)";
+    }
+    std::printf("%-28s %10.1f %10.1f %10.1f\n", name.c_str(), styleOnly, routed,
+      routed - styleOnly);
+  }
+  return EXIT_SUCCESS;
+}
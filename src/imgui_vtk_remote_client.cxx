@@ -0,0 +1,40 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "vtkDearImGuiRemoteClient.h"
+
+#include "vtkNew.h"
+#include "vtkRenderWindow.h"
+#include "vtkRenderWindowInteractor.h"
+#include "vtkRenderer.h"
+
+//------------------------------------------------------------------------------
+// Thin client for the remote UI of vtkDearImGuiInjector.
+// Usage: imgui_vtk_remote_client [tcp://host:port | unix:///path]
+// Start the server with: test_imgui_vtk --remote-ui tcp://127.0.0.1:5600
+//------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+  const char* address = argc > 1 ? argv[1] : "tcp://127.0.0.1:5600";
+
+  vtkNew<vtkRenderer> renderer;
+  vtkNew<vtkRenderWindow> renderWindow;
+  vtkNew<vtkRenderWindowInteractor> iren;
+  renderer->SetBackground(0.1, 0.1, 0.1);
+  renderWindow->AddRenderer(renderer);
+  renderWindow->SetWindowName("vtkDearImGuiInjector remote UI");
+  iren->SetRenderWindow(renderWindow);
+
+  vtkNew<vtkDearImGuiRemoteClient> client;
+  if (!client->Connect(address))
+  {
+    std::cerr << "Cannot connect to " << address << std::endl;
+    return EXIT_FAILURE;
+  }
+  client->Attach(iren);
+
+  renderWindow->Render();
+  iren->Start();
+  return EXIT_SUCCESS;
+}
@@ -1,7 +1,11 @@
+#include <iostream>
 #include <sstream>
 #include <string>
 
 #include "vtkDearImGuiInjector.h"
+#ifdef IMGUI_INJECTOR_SDF_FONTS
+#include "vtkDearImGuiSDFFont.h"
+#endif
 
 #include "vtkActor.h"
 #include "vtkCallbackCommand.h"
@@ -9,6 +13,7 @@
 #include "vtkCameraOrientationRepresentation.h"
 #include "vtkCameraOrientationWidget.h"
 #include "vtkConeSource.h"
+#include "vtkGenericRenderWindowInteractor.h"
 #include "vtkInteractorStyle.h"
 #include "vtkInteractorStyleSwitch.h"
 #include "vtkNew.h"
@@ -17,6 +22,7 @@
 #include "vtkRenderer.h"
 #include "vtkRenderWindow.h"
 #include "vtkRenderWindowInteractor.h"
+#include "vtkSmartPointer.h"
 #include <vtkProperty.h>
 
 #ifdef ADOBE_IMGUI_SPECTRUM
@@ -26,7 +32,7 @@
 #include "vtkOpenGLRenderWindow.h" // needed to check if opengl is supported.
 
 // Listens to vtkDearImGuiInjector::ImGuiSetupEvent
-static void SetupUI(vtkDearImGuiInjector*);
+static void SetupUI(vtkDearImGuiInjector*, const char* fontFile);
 // Listens to vtkDearImGuiInjector::ImGuiDrawEvent
 static void DrawUI(vtkDearImGuiInjector*);
 static void HelpMarker(const char* desc);
@@ -37,10 +43,44 @@ static void HelpMarker(const char* desc);
 
 int main(int argc, char* argv[])
 {
+  // Publish frames to a shared memory ring instead of showing a window,
+  // e.g. --headless /vtk_frames
+  const char* headless = nullptr;
+  // Load a TTF font from disk, e.g. --font Karla-Regular.ttf
+  const char* fontFile = nullptr;
+  for (int i = 1; i + 1 < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--headless")
+    {
+      headless = argv[i + 1];
+    }
+    else if (std::string(argv[i]) == "--font")
+    {
+      fontFile = argv[i + 1];
+    }
+  }
+#if defined(IMGUI_INJECTOR_DISABLE_EMBEDDED_FONTS) && defined(IMGUI_DISABLE_DEFAULT_FONT)
+  // this build embeds no font at all
+  if (!fontFile)
+  {
+    std::cerr << "Built without embedded fonts, pass --font file.ttf" << std::endl;
+    return 1;
+  }
+#endif
+
   // Create a renderer, render window, and interactor
   vtkNew<vtkRenderer> renderer;
   vtkNew<vtkRenderWindow> renderWindow;
-  vtkNew<vtkRenderWindowInteractor> iren;
+  vtkSmartPointer<vtkRenderWindowInteractor> iren;
+  if (headless)
+  {
+    renderWindow->SetOffScreenRendering(1);
+    iren = vtkSmartPointer<vtkGenericRenderWindowInteractor>::New();
+  }
+  else
+  {
+    iren = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+  }
   renderWindow->SetMultiSamples(8);
   renderWindow->AddRenderer(renderer);
   iren->SetRenderWindow(renderWindow);
@@ -81,7 +121,7 @@ int main(int argc, char* argv[])
   // 💉 the overlay.
   dearImGuiOverlay->Inject(iren);
   // These functions add callbacks to ImGuiSetupEvent and ImGuiDrawEvents.
-  SetupUI(dearImGuiOverlay);
+  SetupUI(dearImGuiOverlay, fontFile);
   // You can draw custom user interface elements using ImGui:: namespace.
   DrawUI(dearImGuiOverlay);
   /// Change to your code ends here. ///
@@ -98,6 +138,18 @@ int main(int argc, char* argv[])
   renderWindow->SetSize(1920, 1000);
   vtkInteractorStyleSwitch::SafeDownCast(iren->GetInteractorStyle())->SetCurrentStyleToTrackballCamera();
   // iren->EnableRenderOff();
+  // Serve the overlay to imgui_vtk_remote_client, e.g. --remote-ui tcp://127.0.0.1:5600
+  for (int i = 1; i + 1 < argc; ++i)
+  {
+    if (std::string(argv[i]) == "--remote-ui")
+    {
+      dearImGuiOverlay->StartRemoteUI(argv[i + 1]);
+    }
+  }
+  if (headless)
+  {
+    dearImGuiOverlay->StartPublishing(headless);
+  }
   iren->Start();
 
   return 0;
@@ -108,7 +160,7 @@ int main(int argc, char* argv[])
 //------------------------------------------------------------------------------
 // File: 'Karla-Regular.ttf' (16848 bytes)
 // Exported using binary_to_compressed_c.cpp
-#ifndef ADOBE_IMGUI_SPECTRUM
+#if !defined(ADOBE_IMGUI_SPECTRUM) && !defined(IMGUI_INJECTOR_DISABLE_EMBEDDED_FONTS)
 static const char Karla_Regular_compressed_data_base85[15900 + 1] =
   "7])#######5Z9sf'/###I),##bw9hLQXH##j$1S:'>pgLZvaAd668X%QUQl;*31Qg3R9s/N@4',:a`T9n&)Seo$,p8ZW%q/"
   "^6se=K9C[HP>JeE';G##Uu/>8i1i86<CDmLg@AS@'Tx-3"
@@ -365,13 +417,14 @@ static const char Karla_Regular_compressed_data_base85[15900 + 1] =
   "Ud'B#g+BP8'@AaFum].#UgUx$0BAqDBG$T.-/5##$;ClLS?TG2&),##Rww%######$####WDK[k^=91#";
 #endif
 
-static void SetupUI(vtkDearImGuiInjector* overlay)
+static void SetupUI(vtkDearImGuiInjector* overlay, const char* fontFile)
 {
   vtkNew<vtkCallbackCommand> uiSetup;
   auto uiSetupFunction =
     [](vtkObject* caller, long unsigned int vtkNotUsed(eventId), void* clientData, void* callData)
   {
     vtkDearImGuiInjector* overlay_ = reinterpret_cast<vtkDearImGuiInjector*>(caller);
+    const char* fontFile_ = reinterpret_cast<const char*>(clientData);
     if (!callData)
     {
       return;
@@ -380,12 +433,33 @@ static void SetupUI(vtkDearImGuiInjector* overlay)
     if (imguiInitStatus)
     {
       auto io = ImGui::GetIO();
+      if (fontFile_ && !io.Fonts->AddFontFromFileTTF(fontFile_, 16))
+      {
+        std::cerr << "Cannot load font " << fontFile_ << std::endl;
+      }
 #ifndef ADOBE_IMGUI_SPECTRUM
+#ifndef IMGUI_INJECTOR_DISABLE_EMBEDDED_FONTS
+#ifdef IMGUI_INJECTOR_SDF_FONTS
+      {
+        // decompress through a scratch atlas, the distance field font copies the TTF
+        ImFontAtlas scratch;
+        scratch.AddFontFromMemoryCompressedBase85TTF(Karla_Regular_compressed_data_base85, 16);
+        const ImFontConfig& config = scratch.ConfigData.back();
+        overlay_->GetSDFFont()->AddFontFromMemoryTTF(
+          io.Fonts, config.FontData, config.FontDataSize);
+      }
+#else
       io.Fonts->AddFontFromMemoryCompressedBase85TTF(Karla_Regular_compressed_data_base85, 16);
+#endif
+#endif
+#ifndef IMGUI_DISABLE_DEFAULT_FONT
       io.Fonts->AddFontDefault();
+#endif
 #else
+#ifndef IMGUI_INJECTOR_DISABLE_EMBEDDED_FONTS
       // get framebuffer size
       ImGui::Spectrum::LoadFont(32.0f);
+#endif
       ImGui::Spectrum::StyleColorsSpectrum();
 #endif
       auto& style = ImGui::GetStyle();
@@ -400,6 +474,7 @@ static void SetupUI(vtkDearImGuiInjector* overlay)
     }
   };
   uiSetup->SetCallback(uiSetupFunction);
+  uiSetup->SetClientData(const_cast<char*>(fontFile));
   overlay->AddObserver(vtkDearImGuiInjector::ImGuiSetupEvent, uiSetup);
 }
 
@@ -481,7 +556,8 @@ static void DrawUI(vtkDearImGuiInjector* overlay)
     }// if (windowIsOpen)
   };
   uiDraw->SetCallback(uiDrawFunction);
-  overlay->AddObserver(vtkDearImGuiInjector::ImGuiDrawEvent, uiDraw);
+  // named, so traces and the Draw Profile window attribute its time
+  overlay->AddDrawObserver("Example UI", uiDraw);
 }
 
 static void HelpMarker(const char* desc)
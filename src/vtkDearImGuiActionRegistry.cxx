@@ -0,0 +1,377 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <vtkDearImGuiActionRegistry.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkObjectFactory.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiActionRegistry);
+
+namespace
+{
+const char* PaletteName = "##CommandPalette";
+
+bool KeyPressed(ImGuiKey key)
+{
+#if IMGUI_VERSION_NUM >= 18700
+  return ImGui::IsKeyPressed(key);
+#else
+  return ImGui::IsKeyPressed(ImGui::GetKeyIndex(key));
+#endif
+}
+}
+
+vtkDearImGuiActionRegistry::vtkDearImGuiActionRegistry() = default;
+
+vtkDearImGuiActionRegistry::~vtkDearImGuiActionRegistry() = default;
+
+std::string vtkDearImGuiActionRegistry::Chord(
+  const char* keySym, bool control, bool shift, bool alt)
+{
+  if (!keySym || !keySym[0])
+  {
+    return std::string();
+  }
+  // modifiers in the first character, VTK sends "P" or "p" depending on shift
+  const int modifiers = (control ? 1 : 0) | (shift ? 2 : 0) | (alt ? 4 : 0);
+  return static_cast<char>('0' + modifiers) + vtkDearImGuiTextIndex::ToLower(keySym);
+}
+
+std::string vtkDearImGuiActionRegistry::ParseShortcut(const char* shortcut)
+{
+  bool control = false, shift = false, alt = false;
+  std::string key;
+  const char* begin = shortcut ? shortcut : "";
+  while (*begin)
+  {
+    const char* end = std::strchr(begin, '+');
+    if (end == begin)
+    {
+      // "Ctrl++" binds the plus key
+      end = begin + 1;
+    }
+    const std::string text(begin, end ? end : begin + std::strlen(begin));
+    const std::string token = vtkDearImGuiTextIndex::ToLower(text.c_str());
+    if (!end || !*end)
+    {
+      key = token;
+      break;
+    }
+    if (token == "ctrl" || token == "control")
+    {
+      control = true;
+    }
+    else if (token == "shift")
+    {
+      shift = true;
+    }
+    else if (token == "alt")
+    {
+      alt = true;
+    }
+    begin = end + 1;
+  }
+  return Chord(key.c_str(), control, shift, alt);
+}
+
+void vtkDearImGuiActionRegistry::Invalidate()
+{
+  this->Paths.clear();
+  this->Chords.clear();
+  for (int i = 0; i < static_cast<int>(this->Actions.size()); ++i)
+  {
+    this->Paths[this->Actions[i].Path] = i;
+    const std::string chord = ParseShortcut(this->Actions[i].Shortcut.c_str());
+    if (!chord.empty())
+    {
+      this->Chords[chord] = i;
+    }
+  }
+  this->UpToDate = false;
+  this->Modified();
+}
+
+bool vtkDearImGuiActionRegistry::AddAction(const char* path, std::function<void()> callback,
+  const char* shortcut, std::function<bool()> checked)
+{
+  if (!path || !path[0])
+  {
+    return false;
+  }
+  Action action;
+  action.Path = path;
+  action.Callback = std::move(callback);
+  action.Checked = std::move(checked);
+  bool bound = true;
+  const std::string chord = ParseShortcut(shortcut);
+  if (!chord.empty())
+  {
+    auto taken = this->Chords.find(chord);
+    if (taken != this->Chords.end() && this->Actions[taken->second].Path != action.Path)
+    {
+      vtkWarningMacro(<< "Shortcut " << shortcut << " of " << path << " is taken by "
+                      << this->Actions[taken->second].Path);
+      bound = false;
+    }
+    else
+    {
+      action.Shortcut = shortcut;
+    }
+  }
+  auto existing = this->Paths.find(action.Path);
+  if (existing != this->Paths.end())
+  {
+    this->Actions[existing->second] = std::move(action);
+  }
+  else
+  {
+    this->Actions.push_back(std::move(action));
+  }
+  this->Invalidate();
+  return bound;
+}
+
+bool vtkDearImGuiActionRegistry::AddToggle(const char* path, bool* value, const char* shortcut)
+{
+  return this->AddAction(
+    path, [value]() { *value = !*value; }, shortcut, [value]() { return *value; });
+}
+
+bool vtkDearImGuiActionRegistry::RemoveAction(const char* path)
+{
+  auto it = this->Paths.find(path ? path : "");
+  if (it == this->Paths.end())
+  {
+    return false;
+  }
+  this->Actions.erase(this->Actions.begin() + it->second);
+  this->Invalidate();
+  return true;
+}
+
+bool vtkDearImGuiActionRegistry::Trigger(const char* path)
+{
+  auto it = this->Paths.find(path ? path : "");
+  if (it == this->Paths.end())
+  {
+    return false;
+  }
+  // the callback may remove its own action
+  const std::function<void()> callback = this->Actions[it->second].Callback;
+  if (callback)
+  {
+    callback();
+  }
+  return true;
+}
+
+bool vtkDearImGuiActionRegistry::TriggerShortcut(
+  const char* keySym, bool control, bool shift, bool alt)
+{
+  if (this->Chords.empty())
+  {
+    return false;
+  }
+  auto it = this->Chords.find(Chord(keySym, control, shift, alt));
+  if (it == this->Chords.end())
+  {
+    return false;
+  }
+  const std::function<void()> callback = this->Actions[it->second].Callback;
+  if (callback)
+  {
+    callback();
+  }
+  return true;
+}
+
+void vtkDearImGuiActionRegistry::Update()
+{
+  if (this->UpToDate)
+  {
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope("UpdateActions", "editor");
+  this->MenuBar.Items.clear();
+  this->Index.Clear();
+  for (int i = 0; i < static_cast<int>(this->Actions.size()); ++i)
+  {
+    const std::string& path = this->Actions[i].Path;
+    this->Index.Add(path);
+    Menu* menu = &this->MenuBar;
+    std::size_t begin = 0;
+    for (std::size_t end = path.find('/'); end != std::string::npos; end = path.find('/', begin))
+    {
+      const std::string label = path.substr(begin, end - begin);
+      auto sub = std::find_if(menu->Items.begin(), menu->Items.end(),
+        [&label](const Menu& item) { return item.Action < 0 && item.Label == label; });
+      if (sub == menu->Items.end())
+      {
+        menu->Items.push_back(Menu());
+        menu->Items.back().Label = label;
+        sub = menu->Items.end() - 1;
+      }
+      menu = &*sub;
+      begin = end + 1;
+    }
+    menu->Items.push_back(Menu());
+    menu->Items.back().Label = path.substr(begin);
+    menu->Items.back().Action = i;
+  }
+  this->UpToDate = true;
+}
+
+void vtkDearImGuiActionRegistry::Find(const char* query, std::vector<int>& indices, int maximum)
+{
+  this->Update();
+  indices.clear();
+  const std::string lower = vtkDearImGuiTextIndex::ToLower(query);
+  if (lower.empty())
+  {
+    for (int i = 0; i < static_cast<int>(this->Actions.size()) && i < maximum; ++i)
+    {
+      indices.push_back(i);
+    }
+    return;
+  }
+  this->Index.FindSubsequence(lower.c_str(), indices);
+  std::vector<std::pair<int, int>> scored;
+  scored.reserve(indices.size());
+  for (int id : indices)
+  {
+    scored.emplace_back(-vtkDearImGuiTextIndex::Score(this->Index.GetText(id), lower), id);
+  }
+  const std::size_t count = std::min(scored.size(), static_cast<std::size_t>(maximum));
+  std::partial_sort(scored.begin(), scored.begin() + count, scored.end());
+  indices.resize(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    indices[i] = scored[i].second;
+  }
+}
+
+int vtkDearImGuiActionRegistry::DrawMenu(const Menu& menu)
+{
+  int chosen = -1;
+  for (const Menu& item : menu.Items)
+  {
+    if (item.Action >= 0)
+    {
+      const Action& action = this->Actions[item.Action];
+      const bool checked = action.Checked && action.Checked();
+      if (ImGui::MenuItem(item.Label.c_str(),
+            action.Shortcut.empty() ? nullptr : action.Shortcut.c_str(), checked))
+      {
+        chosen = item.Action;
+      }
+    }
+    else if (ImGui::BeginMenu(item.Label.c_str()))
+    {
+      const int sub = this->DrawMenu(item);
+      chosen = sub >= 0 ? sub : chosen;
+      ImGui::EndMenu();
+    }
+  }
+  return chosen;
+}
+
+void vtkDearImGuiActionRegistry::DrawMenuBar()
+{
+  this->Update();
+  int chosen = -1;
+  if (ImGui::BeginMainMenuBar())
+  {
+    chosen = this->DrawMenu(this->MenuBar);
+    ImGui::EndMainMenuBar();
+  }
+  // after drawing, the callback may change the actions
+  if (chosen >= 0)
+  {
+    this->Trigger(this->Actions[chosen].Path.c_str());
+  }
+}
+
+void vtkDearImGuiActionRegistry::DrawPalette()
+{
+  const ImGuiIO& io = ImGui::GetIO();
+  if (this->PaletteRequested)
+  {
+    this->PaletteRequested = false;
+    this->Query[0] = '\0';
+    ImGui::OpenPopup(PaletteName);
+  }
+  ImGui::SetNextWindowPos(
+    ImVec2(io.DisplaySize.x * 0.5f, io.DisplaySize.y * 0.1f), ImGuiCond_Always, ImVec2(0.5f, 0.f));
+  ImGui::SetNextWindowSize(ImVec2(std::min(600.f, io.DisplaySize.x * 0.8f), 0.f));
+  if (!ImGui::BeginPopup(PaletteName))
+  {
+    return;
+  }
+  const bool appearing = ImGui::IsWindowAppearing();
+  if (appearing)
+  {
+    ImGui::SetKeyboardFocusHere();
+  }
+  ImGui::SetNextItemWidth(-1.f);
+  const bool edited =
+    ImGui::InputTextWithHint("##query", "Type a command", this->Query, sizeof(this->Query));
+  // results index Actions, search again when actions were added or removed meanwhile
+  if (edited || appearing || !this->UpToDate)
+  {
+    vtkDearImGuiTracer::Scope scope("FindActions", "editor");
+    this->Find(this->Query, this->Results, 20);
+    if (edited || appearing)
+    {
+      this->Current = 0;
+    }
+  }
+  const int count = static_cast<int>(this->Results.size());
+  this->Current = std::min(this->Current, std::max(count - 1, 0));
+  if (count > 0 && KeyPressed(ImGuiKey_DownArrow))
+  {
+    this->Current = (this->Current + 1) % count;
+  }
+  if (count > 0 && KeyPressed(ImGuiKey_UpArrow))
+  {
+    this->Current = (this->Current + count - 1) % count;
+  }
+  int chosen = -1;
+  if (count > 0 && KeyPressed(ImGuiKey_Enter))
+  {
+    chosen = this->Results[this->Current];
+  }
+  for (int i = 0; i < count; ++i)
+  {
+    const Action& action = this->Actions[this->Results[i]];
+    ImGui::PushID(i);
+    const float right = ImGui::GetCursorPosX() + ImGui::GetContentRegionAvail().x;
+    if (ImGui::Selectable(action.Path.c_str(), i == this->Current))
+    {
+      chosen = this->Results[i];
+    }
+    if (!action.Shortcut.empty())
+    {
+      const float width = ImGui::CalcTextSize(action.Shortcut.c_str()).x;
+      ImGui::SameLine(right - width);
+      ImGui::TextDisabled("%s", action.Shortcut.c_str());
+    }
+    ImGui::PopID();
+  }
+  if (count == 0)
+  {
+    ImGui::TextDisabled("No matching command");
+  }
+  if (chosen >= 0 || KeyPressed(ImGuiKey_Escape))
+  {
+    ImGui::CloseCurrentPopup();
+  }
+  ImGui::EndPopup();
+  if (chosen >= 0 && chosen < static_cast<int>(this->Actions.size()))
+  {
+    this->Trigger(this->Actions[chosen].Path.c_str());
+  }
+}
@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+#include <vtkDearImGuiAllocator.h>
+
+#include "imgui.h"
+
+namespace
+{
+// Precedes every block. Size is the requested size.
+struct BlockHeader
+{
+  std::size_t Size;
+  std::size_t SizeClass;
+};
+const std::size_t Alignment = alignof(std::max_align_t);
+const std::size_t HeaderSize = (sizeof(BlockHeader) + Alignment - 1) / Alignment * Alignment;
+const std::size_t LargeBlock = ~std::size_t(0);
+const std::size_t MinChunkSize = 64 * 1024;
+
+std::size_t AlignUp(std::size_t size)
+{
+  return (size + Alignment - 1) / Alignment * Alignment;
+}
+
+std::size_t ClassSize(int sizeClass)
+{
+  return std::size_t(16) << sizeClass;
+}
+
+int SizeClassFor(std::size_t size)
+{
+  int sizeClass = 0;
+  while (ClassSize(sizeClass) < size)
+  {
+    ++sizeClass;
+  }
+  return sizeClass;
+}
+}
+
+vtkDearImGuiAllocator* vtkDearImGuiAllocator::GetInstance()
+{
+  static vtkDearImGuiAllocator* instance = new vtkDearImGuiAllocator;
+  return instance;
+}
+
+void vtkDearImGuiAllocator::Install()
+{
+  static bool installed = false;
+  if (installed || ImGui::GetCurrentContext())
+  {
+    // memory of an existing context must be freed by the allocator that made it.
+    return;
+  }
+  ImGui::SetAllocatorFunctions(&vtkDearImGuiAllocator::ImGuiAlloc,
+    &vtkDearImGuiAllocator::ImGuiFree, vtkDearImGuiAllocator::GetInstance());
+  installed = true;
+}
+
+void* vtkDearImGuiAllocator::ImGuiAlloc(std::size_t size, void* userData)
+{
+  return static_cast<vtkDearImGuiAllocator*>(userData)->Allocate(size);
+}
+
+void vtkDearImGuiAllocator::ImGuiFree(void* ptr, void* userData)
+{
+  static_cast<vtkDearImGuiAllocator*>(userData)->Free(ptr);
+}
+
+void* vtkDearImGuiAllocator::SystemAllocate(std::size_t size)
+{
+  ++this->Current.SystemAllocations;
+  return std::malloc(size);
+}
+
+void vtkDearImGuiAllocator::Refill(int sizeClass)
+{
+  const std::size_t blockSize = HeaderSize + ClassSize(sizeClass);
+  const std::size_t chunkSize = std::max(MinChunkSize, 4 * blockSize);
+  char* chunk = static_cast<char*>(this->SystemAllocate(chunkSize));
+  if (!chunk)
+  {
+    return;
+  }
+  this->Chunks.push_back(chunk);
+  for (std::size_t offset = 0; offset + blockSize <= chunkSize; offset += blockSize)
+  {
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + offset);
+    block->Next = this->FreeLists[sizeClass];
+    this->FreeLists[sizeClass] = block;
+  }
+}
+
+void* vtkDearImGuiAllocator::Allocate(std::size_t size)
+{
+  char* block = nullptr;
+  std::size_t sizeClass = LargeBlock;
+  if (size <= MaxPooledSize)
+  {
+    const int pooledClass = SizeClassFor(size);
+    if (!this->FreeLists[pooledClass])
+    {
+      this->Refill(pooledClass);
+    }
+    FreeBlock* head = this->FreeLists[pooledClass];
+    if (head)
+    {
+      this->FreeLists[pooledClass] = head->Next;
+      block = reinterpret_cast<char*>(head);
+      sizeClass = static_cast<std::size_t>(pooledClass);
+    }
+  }
+  else
+  {
+    block = static_cast<char*>(this->SystemAllocate(HeaderSize + size));
+  }
+  if (!block)
+  {
+    return nullptr;
+  }
+  BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+  header->Size = size;
+  header->SizeClass = sizeClass;
+
+  Statistics& stats = this->Current;
+  ++stats.Allocations;
+  stats.AllocatedBytes += size;
+  stats.LiveBytes += size;
+  stats.PeakLiveBytes = std::max(stats.PeakLiveBytes, stats.LiveBytes);
+  return block + HeaderSize;
+}
+
+void vtkDearImGuiAllocator::Free(void* ptr)
+{
+  if (!ptr)
+  {
+    return;
+  }
+  char* block = static_cast<char*>(ptr) - HeaderSize;
+  const BlockHeader* header = reinterpret_cast<const BlockHeader*>(block);
+  ++this->Current.Frees;
+  this->Current.LiveBytes -= header->Size;
+  if (header->SizeClass == LargeBlock)
+  {
+    std::free(block);
+    return;
+  }
+  FreeBlock* freed = reinterpret_cast<FreeBlock*>(block);
+  freed->Next = this->FreeLists[header->SizeClass];
+  this->FreeLists[header->SizeClass] = freed;
+}
+
+void* vtkDearImGuiAllocator::AllocateFrameMemory(std::size_t size)
+{
+  size = AlignUp(std::max<std::size_t>(size, 1));
+  this->Current.FrameBytes += size;
+  if (this->ArenaOffset + size <= this->ArenaSize)
+  {
+    void* memory = this->Arena.get() + this->ArenaOffset;
+    this->ArenaOffset += size;
+    return memory;
+  }
+  // The arena grows to fit at the next BeginFrame().
+  ++this->Current.SystemAllocations;
+  this->ArenaOverflow.emplace_back(new char[size]);
+  this->ArenaOverflowBytes += size;
+  return this->ArenaOverflow.back().get();
+}
+
+const char* vtkDearImGuiAllocator::FormatFrameString(const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  va_list argsCopy;
+  va_copy(argsCopy, args);
+  const int length = std::vsnprintf(nullptr, 0, format, args);
+  va_end(args);
+  if (length < 0)
+  {
+    va_end(argsCopy);
+    return "";
+  }
+  char* text = static_cast<char*>(this->AllocateFrameMemory(static_cast<std::size_t>(length) + 1));
+  std::vsnprintf(text, static_cast<std::size_t>(length) + 1, format, argsCopy);
+  va_end(argsCopy);
+  return text;
+}
+
+void vtkDearImGuiAllocator::BeginFrame()
+{
+  this->LastFrame = this->Current;
+
+  const std::size_t liveBytes = this->Current.LiveBytes;
+  this->Current = Statistics();
+  this->Current.LiveBytes = liveBytes;
+  this->Current.PeakLiveBytes = liveBytes;
+
+  if (this->ArenaOverflowBytes > 0)
+  {
+    // Replace the arena by one that holds a whole frame like the last one.
+    std::size_t size = std::max<std::size_t>(this->ArenaSize, 4096);
+    while (size < this->ArenaOffset + this->ArenaOverflowBytes)
+    {
+      size *= 2;
+    }
+    this->ArenaOverflow.clear();
+    this->ArenaOverflowBytes = 0;
+    this->Arena.reset(new char[size]);
+    this->ArenaSize = size;
+    ++this->Current.SystemAllocations;
+  }
+  this->ArenaOffset = 0;
+}
@@ -0,0 +1,65 @@
+#include <vtkDearImGuiCommandQueue.h>
+
+vtkDearImGuiCommandQueue::vtkDearImGuiCommandQueue(std::size_t capacity)
+{
+  std::size_t size = 2;
+  while (size < capacity)
+  {
+    size <<= 1;
+  }
+  this->Cells.reset(new Cell[size]);
+  this->Mask = size - 1;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    this->Cells[i].Sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+vtkDearImGuiCommandQueue::~vtkDearImGuiCommandQueue() = default;
+
+bool vtkDearImGuiCommandQueue::Push(Command&& command)
+{
+  Cell* cell = nullptr;
+  std::size_t pos = this->EnqueuePos.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    cell = &this->Cells[pos & this->Mask];
+    const std::size_t seq = cell->Sequence.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0)
+    {
+      // cell is free, try to claim it.
+      if (this->EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+      {
+        break;
+      }
+    }
+    else if (diff < 0)
+    {
+      return false; // full
+    }
+    else
+    {
+      pos = this->EnqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+  cell->Value = std::move(command);
+  cell->Sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool vtkDearImGuiCommandQueue::Pop(Command& command)
+{
+  const std::size_t pos = this->DequeuePos;
+  Cell& cell = this->Cells[pos & this->Mask];
+  const std::size_t seq = cell.Sequence.load(std::memory_order_acquire);
+  if (seq != pos + 1)
+  {
+    return false; // empty, or the producer has not finished writing yet
+  }
+  command = std::move(cell.Value);
+  cell.Value = nullptr;
+  cell.Sequence.store(pos + this->Mask + 1, std::memory_order_release);
+  this->DequeuePos = pos + 1;
+  return true;
+}
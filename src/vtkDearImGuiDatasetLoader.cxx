@@ -0,0 +1,668 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <vtkDearImGuiDatasetLoader.h>
+#include <vtkDearImGuiTable.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkCommand.h>
+#include <vtkDataArray.h>
+#include <vtkErrorCode.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+#include <vtkVersionMacros.h>
+#include <vtkXMLGenericDataObjectReader.h>
+#include <vtkXMLImageDataReader.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkXMLReader.h>
+#include <vtkXMLUnstructuredDataReader.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "imgui.h"
+
+// Without threads (WebAssembly built with USE_PTHREADS=0) jobs run in Load().
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define DATASET_LOADER_NO_THREADS 1
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiDatasetLoader);
+
+namespace
+{
+const char* StateNames[] = { "Loading", "Done", "Cancelled", "Failed" };
+
+// pages are faulted in by chunks of this size, between progress reports
+const std::size_t PrefetchChunk = std::size_t(8) << 20;
+// voxels of the coarse image delivered ahead of a raw volume
+const double CoarseVoxels = 128. * 128. * 128.;
+// progress wakes the UI at most this often, in seconds
+const double ProgressInterval = 0.1;
+
+double Now()
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+
+bool EndsWith(const std::string& text, const char* suffix)
+{
+  const std::size_t length = std::strlen(suffix);
+  return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+vtkSmartPointer<vtkXMLReader> CreateReader(const std::string& fileName)
+{
+  if (EndsWith(fileName, ".vtp"))
+  {
+    return vtkSmartPointer<vtkXMLPolyDataReader>::New();
+  }
+  if (EndsWith(fileName, ".vtu"))
+  {
+    return vtkSmartPointer<vtkXMLUnstructuredGridReader>::New();
+  }
+  if (EndsWith(fileName, ".vti"))
+  {
+    return vtkSmartPointer<vtkXMLImageDataReader>::New();
+  }
+  // reads the whole file at once
+  return vtkSmartPointer<vtkXMLGenericDataObjectReader>::New();
+}
+
+void Unmap(void* data, std::size_t length)
+{
+#ifdef _WIN32
+  (void)length;
+  UnmapViewOfFile(data);
+#else
+  munmap(data, length);
+#endif
+}
+
+// arrays adopting a mapping, by the pointer the array frees, to the mapping
+std::mutex MappingsMutex;
+std::map<void*, std::pair<void*, std::size_t>> Mappings;
+
+void ReleaseMapping(void* pointer)
+{
+  std::pair<void*, std::size_t> mapping(nullptr, 0);
+  {
+    std::lock_guard<std::mutex> lock(MappingsMutex);
+    auto it = Mappings.find(pointer);
+    if (it == Mappings.end())
+    {
+      return;
+    }
+    mapping = it->second;
+    Mappings.erase(it);
+  }
+  Unmap(mapping.first, mapping.second);
+}
+
+// A private, copy-on-write view of a whole file.
+struct MappedFile
+{
+  unsigned char* Data = nullptr;
+  std::size_t Length = 0;
+
+  ~MappedFile()
+  {
+    if (this->Data)
+    {
+      Unmap(this->Data, this->Length);
+    }
+  }
+
+  bool Open(const std::string& fileName)
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+      return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+      mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    }
+    if (mapping)
+    {
+      this->Data = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+      this->Length = static_cast<std::size_t>(size.QuadPart);
+      // the view keeps the file mapped
+      CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else
+    const int file = open(fileName.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+      return false;
+    }
+    struct stat status;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+    {
+      // private and writable, so VTK may modify the scalars without touching the file
+      void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size),
+        PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+      if (data != MAP_FAILED)
+      {
+        this->Data = static_cast<unsigned char*>(data);
+        this->Length = static_cast<std::size_t>(status.st_size);
+      }
+    }
+    close(file);
+#endif
+    return this->Data != nullptr;
+  }
+
+  // Fault in length bytes from offset.
+  void Prefetch(std::size_t offset, std::size_t length)
+  {
+    unsigned char* begin = this->Data + offset;
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    unsigned char* aligned = this->Data + offset / page * page;
+    madvise(aligned, static_cast<std::size_t>(begin - aligned) + length, MADV_WILLNEED);
+#endif
+    // volatile keeps the reads
+    const volatile unsigned char* pages = begin;
+    for (std::size_t i = 0; i < length; i += 4096)
+    {
+      (void)pages[i];
+    }
+  }
+
+  // Point array at numberOfValues values from offset. The array unmaps the file when it
+  // is freed.
+  void Adopt(vtkDataArray* array, std::size_t offset, vtkIdType numberOfValues)
+  {
+    void* values = this->Data + offset;
+#if VTK_MAJOR_VERSION >= 9
+    {
+      std::lock_guard<std::mutex> lock(MappingsMutex);
+      Mappings[values] = std::make_pair(static_cast<void*>(this->Data), this->Length);
+    }
+    array->SetVoidArray(values, numberOfValues, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+    array->SetArrayFreeFunction(ReleaseMapping);
+    this->Data = nullptr;
+#else
+    // no free callbacks, copy and let the mapping go
+    array->SetNumberOfTuples(numberOfValues / array->GetNumberOfComponents());
+    std::memcpy(array->GetVoidPointer(0), values,
+      static_cast<std::size_t>(numberOfValues) * array->GetDataTypeSize());
+#endif
+  }
+};
+
+// Forwards reader progress and aborts the reader once the job is cancelled.
+class vtkLoaderProgressCommand : public vtkCommand
+{
+public:
+  static vtkLoaderProgressCommand* New() { return new vtkLoaderProgressCommand; }
+  vtkTypeMacro(vtkLoaderProgressCommand, vtkCommand);
+
+  void Execute(vtkObject* caller, unsigned long eid, void* callData) override
+  {
+    this->Progress(*static_cast<double*>(callData), vtkAlgorithm::SafeDownCast(caller));
+  }
+
+  std::function<void(double, vtkAlgorithm*)> Progress;
+};
+}
+
+struct vtkDearImGuiDatasetLoader::Job
+{
+  int Id = 0;
+  std::string FileName;
+  Callback ResultCallback;
+  PostFunction Post;
+  std::function<void(Job&)> Run;
+  double StartTime = 0.;
+  std::thread Thread;
+
+  // written by the worker, read by the UI thread
+  std::atomic<int> State{ Loading };
+  std::atomic<double> Progress{ 0. };
+  std::atomic<double> BytesRead{ 0. };
+  std::atomic<double> EndTime{ -1. };
+  std::string Error; // set before State turns Failed
+
+  std::atomic<bool> CancelRequested{ false };
+  double LastReport = 0.; // worker
+
+  void Report(double progress, double bytes);
+  // Hand data over to the callback, returns false if the job was cancelled meanwhile.
+  bool Deliver(vtkDataObject* data, bool last);
+  void Finish(int state, const char* error = nullptr);
+
+  void ReadXML(int numberOfPieces);
+  void ReadRawVolume(const RawVolume& layout);
+};
+
+void vtkDearImGuiDatasetLoader::Job::Report(double progress, double bytes)
+{
+  this->Progress.store(progress);
+  this->BytesRead.store(bytes);
+  const double now = Now();
+  if (now - this->LastReport >= ProgressInterval)
+  {
+    // an empty command wakes the event loop to redraw the progress
+    this->LastReport = now;
+    this->Post([]() {});
+  }
+}
+
+bool vtkDearImGuiDatasetLoader::Job::Deliver(vtkDataObject* data, bool last)
+{
+#ifdef DATASET_LOADER_NO_THREADS
+  // the job runs on the UI thread, nothing would drain a full queue while it waits
+  this->ResultCallback(this->Id, data, last);
+  return !this->CancelRequested.load();
+#else
+  vtkSmartPointer<vtkDataObject> result = data;
+  const Callback callback = this->ResultCallback;
+  const int id = this->Id;
+  const std::function<void()> command = [callback, id, result, last]()
+  { callback(id, result, last); };
+  // results are not dropped, wait for room in the queue
+  while (!this->Post(command))
+  {
+    if (this->CancelRequested.load())
+    {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+#endif
+}
+
+void vtkDearImGuiDatasetLoader::Job::Finish(int state, const char* error)
+{
+  if (error)
+  {
+    this->Error = error;
+  }
+  this->EndTime.store(Now());
+  this->State.store(state);
+  this->Post([]() {});
+}
+
+void vtkDearImGuiDatasetLoader::Job::ReadXML(int numberOfPieces)
+{
+  vtkSmartPointer<vtkXMLReader> reader = CreateReader(this->FileName);
+  if (!reader->CanReadFile(this->FileName.c_str()))
+  {
+    this->Finish(Failed, "Not a VTK XML file");
+    return;
+  }
+  reader->SetFileName(this->FileName.c_str());
+  reader->UpdateInformation();
+  int pieces = std::max(1, numberOfPieces);
+  if (vtkXMLUnstructuredDataReader* unstructured =
+        vtkXMLUnstructuredDataReader::SafeDownCast(reader))
+  {
+    // more pieces than the file has are empty
+    pieces = std::max(1, std::min(pieces, static_cast<int>(unstructured->GetNumberOfPieces())));
+  }
+  else if (!vtkXMLImageDataReader::SafeDownCast(reader))
+  {
+    pieces = 1;
+  }
+
+  std::ifstream stream(this->FileName, std::ios::binary | std::ios::ate);
+  const double fileSize = stream ? static_cast<double>(stream.tellg()) : 0.;
+  stream.close();
+  int piece = 0;
+  vtkNew<vtkLoaderProgressCommand> progress;
+  progress->Progress = [this, &piece, pieces, fileSize](double value, vtkAlgorithm* algorithm)
+  {
+    if (this->CancelRequested.load())
+    {
+      algorithm->SetAbortExecute(1);
+    }
+    const double total = (piece + value) / pieces;
+    this->Report(total, total * fileSize);
+  };
+  reader->AddObserver(vtkCommand::ProgressEvent, progress);
+
+  for (; piece < pieces; ++piece)
+  {
+    {
+      vtkDearImGuiTracer::Scope scope("ReadPiece", "loader");
+      reader->UpdatePiece(piece, pieces, 0);
+    }
+    if (this->CancelRequested.load())
+    {
+      this->Finish(Cancelled);
+      return;
+    }
+    if (reader->GetErrorCode() != vtkErrorCode::NoError)
+    {
+      this->Finish(Failed, vtkErrorCode::GetStringFromErrorCode(reader->GetErrorCode()));
+      return;
+    }
+    // the reader builds new arrays for the next piece, sharing these is safe
+    vtkDataObject* output = reader->GetOutputDataObject(0);
+    vtkSmartPointer<vtkDataObject> result;
+    result.TakeReference(output->NewInstance());
+    result->ShallowCopy(output);
+    this->Report((piece + 1.) / pieces, fileSize * (piece + 1.) / pieces);
+    if (!this->Deliver(result, piece + 1 == pieces))
+    {
+      this->Finish(Cancelled);
+      return;
+    }
+  }
+  this->Finish(Done);
+}
+
+void vtkDearImGuiDatasetLoader::Job::ReadRawVolume(const RawVolume& layout)
+{
+  const int* dimensions = layout.Dimensions;
+  const std::size_t voxels = static_cast<std::size_t>(std::max(0, dimensions[0])) *
+    std::max(0, dimensions[1]) * std::max(0, dimensions[2]);
+  const int typeSize = vtkAbstractArray::GetDataTypeSize(layout.ScalarType);
+  const std::size_t valueSize = static_cast<std::size_t>(typeSize) * layout.NumberOfComponents;
+  if (!voxels || !typeSize || layout.NumberOfComponents < 1)
+  {
+    this->Finish(Failed, "Invalid volume layout");
+    return;
+  }
+  MappedFile file;
+  if (!file.Open(this->FileName))
+  {
+    this->Finish(Failed, "Cannot map the file");
+    return;
+  }
+  const std::size_t size = voxels * valueSize;
+  if (file.Length < layout.HeaderSize + size)
+  {
+    this->Finish(Failed, "File smaller than the volume layout");
+    return;
+  }
+  const unsigned char* values = file.Data + layout.HeaderSize;
+
+  // every stride-th voxel, for display while the rest is read
+  const int stride = static_cast<int>(std::ceil(std::cbrt(voxels / CoarseVoxels)));
+  if (stride > 1)
+  {
+    vtkDearImGuiTracer::Scope scope("CoarseVolume", "loader");
+    int coarse[3];
+    double spacing[3];
+    for (int i = 0; i < 3; ++i)
+    {
+      coarse[i] = (dimensions[i] + stride - 1) / stride;
+      spacing[i] = layout.Spacing[i] * stride;
+    }
+    vtkSmartPointer<vtkDataArray> scalars;
+    scalars.TakeReference(vtkDataArray::CreateDataArray(layout.ScalarType));
+    scalars->SetNumberOfComponents(layout.NumberOfComponents);
+    scalars->SetNumberOfTuples(static_cast<vtkIdType>(coarse[0]) * coarse[1] * coarse[2]);
+    unsigned char* target = static_cast<unsigned char*>(scalars->GetVoidPointer(0));
+    for (int z = 0; z < coarse[2]; ++z)
+    {
+      for (int y = 0; y < coarse[1]; ++y)
+      {
+        const std::size_t row = (static_cast<std::size_t>(z) * stride * dimensions[1] +
+                                  static_cast<std::size_t>(y) * stride) *
+          dimensions[0];
+        for (int x = 0; x < coarse[0]; ++x)
+        {
+          std::memcpy(target, values + (row + static_cast<std::size_t>(x) * stride) * valueSize,
+            valueSize);
+          target += valueSize;
+        }
+      }
+      if (this->CancelRequested.load())
+      {
+        this->Finish(Cancelled);
+        return;
+      }
+    }
+    vtkNew<vtkImageData> image;
+    image->SetDimensions(coarse);
+    image->SetSpacing(spacing);
+    image->SetOrigin(layout.Origin[0], layout.Origin[1], layout.Origin[2]);
+    image->GetPointData()->SetScalars(scalars);
+    if (!this->Deliver(image, false))
+    {
+      this->Finish(Cancelled);
+      return;
+    }
+  }
+
+  {
+    // fault the pages in here rather than in the first render
+    vtkDearImGuiTracer::Scope scope("MapVolume", "loader");
+    for (std::size_t offset = 0; offset < size; offset += PrefetchChunk)
+    {
+      if (this->CancelRequested.load())
+      {
+        this->Finish(Cancelled);
+        return;
+      }
+      const std::size_t length = std::min(PrefetchChunk, size - offset);
+      file.Prefetch(layout.HeaderSize + offset, length);
+      const double read = static_cast<double>(offset + length);
+      this->Report(read / size, read);
+    }
+  }
+
+  vtkSmartPointer<vtkDataArray> scalars;
+  scalars.TakeReference(vtkDataArray::CreateDataArray(layout.ScalarType));
+  scalars->SetNumberOfComponents(layout.NumberOfComponents);
+  file.Adopt(
+    scalars, layout.HeaderSize, static_cast<vtkIdType>(voxels) * layout.NumberOfComponents);
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(dimensions[0], dimensions[1], dimensions[2]);
+  image->SetSpacing(layout.Spacing[0], layout.Spacing[1], layout.Spacing[2]);
+  image->SetOrigin(layout.Origin[0], layout.Origin[1], layout.Origin[2]);
+  image->GetPointData()->SetScalars(scalars);
+  this->Finish(this->Deliver(image, true) ? Done : Cancelled);
+}
+
+vtkDearImGuiDatasetLoader::vtkDearImGuiDatasetLoader() = default;
+
+vtkDearImGuiDatasetLoader::~vtkDearImGuiDatasetLoader()
+{
+  this->CancelAll();
+  for (auto& job : this->Jobs)
+  {
+    if (job->Thread.joinable())
+    {
+      job->Thread.join();
+    }
+  }
+}
+
+void vtkDearImGuiDatasetLoader::SetPostFunction(PostFunction post)
+{
+  this->Post = std::move(post);
+}
+
+int vtkDearImGuiDatasetLoader::Load(const char* fileName, Callback callback, int numberOfPieces)
+{
+  auto job = std::make_shared<Job>();
+  job->FileName = fileName ? fileName : "";
+  job->ResultCallback = std::move(callback);
+  job->Run = [numberOfPieces](Job& self) { self.ReadXML(numberOfPieces); };
+  return this->Start(job);
+}
+
+int vtkDearImGuiDatasetLoader::LoadRawVolume(
+  const char* fileName, const RawVolume& layout, Callback callback)
+{
+  auto job = std::make_shared<Job>();
+  job->FileName = fileName ? fileName : "";
+  job->ResultCallback = std::move(callback);
+  job->Run = [layout](Job& self) { self.ReadRawVolume(layout); };
+  return this->Start(job);
+}
+
+int vtkDearImGuiDatasetLoader::Start(std::shared_ptr<Job> job)
+{
+  if (!this->Post || !job->ResultCallback || job->FileName.empty())
+  {
+    vtkErrorMacro(<< "A file name, a callback and a post function are required");
+    return 0;
+  }
+  job->Id = this->NextJob++;
+  job->Post = this->Post;
+  job->StartTime = Now();
+  this->Jobs.push_back(job);
+#ifdef DATASET_LOADER_NO_THREADS
+  job->Run(*job);
+#else
+  Job* self = job.get();
+  job->Thread = std::thread(
+    [self]()
+    {
+      vtkDearImGuiTracer::SetThreadName("vtkDearImGuiDatasetLoader");
+      self->Run(*self);
+    });
+#endif
+  return job->Id;
+}
+
+void vtkDearImGuiDatasetLoader::Cancel(int id)
+{
+  for (auto& job : this->Jobs)
+  {
+    if (job->Id == id)
+    {
+      job->CancelRequested.store(true);
+    }
+  }
+}
+
+void vtkDearImGuiDatasetLoader::CancelAll()
+{
+  for (auto& job : this->Jobs)
+  {
+    job->CancelRequested.store(true);
+  }
+}
+
+std::vector<vtkDearImGuiDatasetLoader::Status> vtkDearImGuiDatasetLoader::GetStatus() const
+{
+  std::vector<Status> statuses;
+  const double now = Now();
+  for (const auto& job : this->Jobs)
+  {
+    Status status;
+    status.Job = job->Id;
+    status.FileName = job->FileName;
+    status.State = job->State.load();
+    status.Progress = job->Progress.load();
+    status.BytesRead = job->BytesRead.load();
+    const double end = job->EndTime.load();
+    status.Seconds = (end < 0. ? now : end) - job->StartTime;
+    if (status.State == Failed)
+    {
+      status.Error = job->Error;
+    }
+    statuses.push_back(status);
+  }
+  return statuses;
+}
+
+bool vtkDearImGuiDatasetLoader::IsLoading() const
+{
+  return std::any_of(this->Jobs.begin(), this->Jobs.end(),
+    [](const std::shared_ptr<Job>& job) { return job->State.load() == Loading; });
+}
+
+void vtkDearImGuiDatasetLoader::ClearFinished()
+{
+  auto finished = std::stable_partition(this->Jobs.begin(), this->Jobs.end(),
+    [](const std::shared_ptr<Job>& job) { return job->State.load() == Loading; });
+  for (auto it = finished; it != this->Jobs.end(); ++it)
+  {
+    // State is the worker's last write, this join is short
+    if ((*it)->Thread.joinable())
+    {
+      (*it)->Thread.join();
+    }
+  }
+  this->Jobs.erase(finished, this->Jobs.end());
+}
+
+void vtkDearImGuiDatasetLoader::Draw()
+{
+  if (this->Jobs.empty())
+  {
+    ImGui::TextDisabled("No loads");
+    return;
+  }
+  if (ImGui::SmallButton("Clear finished"))
+  {
+    this->ClearFinished();
+  }
+  if (!vtkDearImGuiTable::Begin("##loads", 5))
+  {
+    return;
+  }
+  vtkDearImGuiTable::SetupColumn("File", 1.f);
+  vtkDearImGuiTable::SetupColumn("Progress", 1.f);
+  vtkDearImGuiTable::SetupColumn("MB/s", 0.4f);
+  vtkDearImGuiTable::SetupColumn("Seconds", 0.4f);
+  vtkDearImGuiTable::SetupColumn("", 0.4f);
+  vtkDearImGuiTable::HeadersRow();
+  for (const Status& status : this->GetStatus())
+  {
+    ImGui::PushID(status.Job);
+    vtkDearImGuiTable::NextRow();
+    vtkDearImGuiTable::NextColumn();
+    const std::size_t slash = status.FileName.find_last_of("/\\");
+    ImGui::TextUnformatted(
+      slash == std::string::npos ? status.FileName.c_str() : status.FileName.c_str() + slash + 1);
+    if (ImGui::IsItemHovered())
+    {
+      ImGui::SetTooltip("%s", status.FileName.c_str());
+    }
+    vtkDearImGuiTable::NextColumn();
+    ImGui::ProgressBar(static_cast<float>(status.Progress), ImVec2(-1.f, 0.f),
+      status.State == Loading ? nullptr : StateNames[status.State]);
+    if (status.State == Failed && ImGui::IsItemHovered())
+    {
+      ImGui::SetTooltip("%s", status.Error.c_str());
+    }
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%.1f", status.Seconds > 0. ? status.BytesRead / 1e6 / status.Seconds : 0.);
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%.1f", status.Seconds);
+    vtkDearImGuiTable::NextColumn();
+    if (status.State == Loading && ImGui::SmallButton("Cancel"))
+    {
+      this->Cancel(status.Job);
+    }
+    ImGui::PopID();
+  }
+  vtkDearImGuiTable::End();
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cstring>
+
+#include <vtkDearImGuiDrawBatcher.h>
+
+#include <vtkObjectFactory.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiDrawBatcher);
+
+namespace
+{
+// Vertices a segment can address.
+const unsigned int MaxIndexableVertices = sizeof(ImDrawIdx) == 2 ? 0x10000u : UINT_MAX;
+
+// bounds: xmin, ymin, xmax, ymax
+bool Contains(const ImVec4& clipRect, const float* bounds)
+{
+  return bounds[0] >= clipRect.x && bounds[1] >= clipRect.y && bounds[2] <= clipRect.z &&
+    bounds[3] <= clipRect.w;
+}
+
+bool SameClipRect(const ImVec4& a, const ImVec4& b)
+{
+  return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+}
+}
+
+vtkDearImGuiDrawBatcher::vtkDearImGuiDrawBatcher()
+  : Output(new ImDrawData)
+{
+}
+
+vtkDearImGuiDrawBatcher::~vtkDearImGuiDrawBatcher() = default;
+
+ImDrawList* vtkDearImGuiDrawBatcher::NextList()
+{
+  if (this->UsedLists.size() == this->Lists.size())
+  {
+    this->Lists.emplace_back(new ImDrawList(ImGui::GetDrawListSharedData()));
+  }
+  ImDrawList* list = this->Lists[this->UsedLists.size()].get();
+  list->CmdBuffer.resize(0);
+  list->IdxBuffer.resize(0);
+  list->VtxBuffer.resize(0);
+  this->UsedLists.push_back(list);
+  this->Bounds.clear();
+  return list;
+}
+
+ImDrawData* vtkDearImGuiDrawBatcher::Batch(ImDrawData* drawData, bool hasVtxOffset)
+{
+  this->InputCommands = this->OutputCommands = 0;
+  this->InputLists = this->OutputLists = 0;
+  if (!drawData || !drawData->Valid)
+  {
+    return drawData;
+  }
+
+  this->UsedLists.clear();
+  ImDrawList* out = nullptr;
+  // Indices of a command are relative to the first vertex of its segment. Commands of
+  // one segment can be merged.
+  unsigned int segment = 0;
+  for (int n = 0; n < drawData->CmdListsCount; ++n)
+  {
+    const ImDrawList* in = drawData->CmdLists[n];
+    this->InputCommands += in->CmdBuffer.Size;
+    const unsigned int end = static_cast<unsigned int>(out ? out->VtxBuffer.Size : 0) +
+      static_cast<unsigned int>(in->VtxBuffer.Size);
+    if (!out || (!hasVtxOffset && end > MaxIndexableVertices))
+    {
+      out = this->NextList();
+      segment = 0;
+    }
+    else if (end - segment > MaxIndexableVertices)
+    {
+      segment = static_cast<unsigned int>(out->VtxBuffer.Size);
+    }
+
+    // append all vertices
+    const unsigned int base = static_cast<unsigned int>(out->VtxBuffer.Size);
+    out->VtxBuffer.resize(out->VtxBuffer.Size + in->VtxBuffer.Size);
+    std::memcpy(out->VtxBuffer.Data + base, in->VtxBuffer.Data,
+      static_cast<std::size_t>(in->VtxBuffer.Size) * sizeof(ImDrawVert));
+
+    for (const ImDrawCmd& cmd : in->CmdBuffer)
+    {
+      if (cmd.VtxOffset != 0 && base + cmd.VtxOffset != segment)
+      {
+        // the list itself is split in segments (only with base vertex support)
+        segment = base + cmd.VtxOffset;
+      }
+      ImDrawCmd rebased = cmd;
+      rebased.IdxOffset = static_cast<unsigned int>(out->IdxBuffer.Size);
+      rebased.VtxOffset = segment;
+      if (cmd.UserCallback)
+      {
+        out->CmdBuffer.push_back(rebased);
+        this->Bounds.insert(this->Bounds.end(), 4, 0.f);
+        continue;
+      }
+      if (cmd.ElemCount == 0)
+      {
+        continue;
+      }
+
+      // copy indices rebased to the segment and measure the geometry
+      const unsigned int shift = base + cmd.VtxOffset - segment;
+      const ImDrawIdx* source = in->IdxBuffer.Data + cmd.IdxOffset;
+      out->IdxBuffer.resize(out->IdxBuffer.Size + static_cast<int>(cmd.ElemCount));
+      ImDrawIdx* destination = out->IdxBuffer.Data + rebased.IdxOffset;
+      const ImDrawVert* vertices = out->VtxBuffer.Data + rebased.VtxOffset;
+      float bounds[4] = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+      for (unsigned int i = 0; i < cmd.ElemCount; ++i)
+      {
+        const unsigned int index = source[i] + shift;
+        destination[i] = static_cast<ImDrawIdx>(index);
+        const ImVec2& pos = vertices[index].pos;
+        bounds[0] = std::min(bounds[0], pos.x);
+        bounds[1] = std::min(bounds[1], pos.y);
+        bounds[2] = std::max(bounds[2], pos.x);
+        bounds[3] = std::max(bounds[3], pos.y);
+      }
+
+      if (out->CmdBuffer.Size > 0)
+      {
+        ImDrawCmd& last = out->CmdBuffer.back();
+        float* lastBounds = &this->Bounds[this->Bounds.size() - 4];
+        const bool sameClip = SameClipRect(last.ClipRect, cmd.ClipRect);
+        // Unclipped geometry stays unclipped under the union of both rects.
+        const bool unclipped =
+          Contains(last.ClipRect, lastBounds) && Contains(cmd.ClipRect, bounds);
+        if (!last.UserCallback && last.TextureId == cmd.TextureId &&
+          last.VtxOffset == rebased.VtxOffset &&
+          last.IdxOffset + last.ElemCount == rebased.IdxOffset && (sameClip || unclipped))
+        {
+          last.ElemCount += cmd.ElemCount;
+          if (!sameClip)
+          {
+            last.ClipRect = ImVec4(std::min(last.ClipRect.x, cmd.ClipRect.x),
+              std::min(last.ClipRect.y, cmd.ClipRect.y), std::max(last.ClipRect.z, cmd.ClipRect.z),
+              std::max(last.ClipRect.w, cmd.ClipRect.w));
+          }
+          lastBounds[0] = std::min(lastBounds[0], bounds[0]);
+          lastBounds[1] = std::min(lastBounds[1], bounds[1]);
+          lastBounds[2] = std::max(lastBounds[2], bounds[2]);
+          lastBounds[3] = std::max(lastBounds[3], bounds[3]);
+          continue;
+        }
+      }
+      out->CmdBuffer.push_back(rebased);
+      this->Bounds.insert(this->Bounds.end(), bounds, bounds + 4);
+    }
+  }
+
+  *this->Output = *drawData;
+#if IMGUI_VERSION_NUM >= 18980
+  // CmdLists became an ImVector in 1.89.8
+  this->Output->CmdLists.resize(0);
+  for (ImDrawList* list : this->UsedLists)
+  {
+    this->Output->CmdLists.push_back(list);
+  }
+#else
+  this->Output->CmdLists = this->UsedLists.data();
+#endif
+  this->Output->CmdListsCount = static_cast<int>(this->UsedLists.size());
+
+  this->InputLists = drawData->CmdListsCount;
+  this->OutputLists = this->Output->CmdListsCount;
+  for (ImDrawList* list : this->UsedLists)
+  {
+    this->OutputCommands += list->CmdBuffer.Size;
+  }
+  return this->Output.get();
+}
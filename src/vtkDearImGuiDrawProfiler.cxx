@@ -0,0 +1,375 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include <vtkDearImGuiDrawProfiler.h>
+#include <vtkDearImGuiTable.h>
+
+#include <vtkObjectFactory.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiDrawProfiler);
+
+namespace
+{
+const char* UnnamedObservers = "(unnamed observers)";
+
+// dispatch overhead below this is not reported as unnamed observers
+const double UnnamedThreshold = 20e-6;
+
+std::string WindowName(const ImDrawList* list, int index)
+{
+#if IMGUI_VERSION_NUM >= 17700
+  const char* owner = list->_OwnerName;
+  if (owner && owner[0])
+  {
+    // child windows are named "Parent/Child_ID"
+    const char* slash = std::strchr(owner, '/');
+    return slash ? std::string(owner, slash) : std::string(owner);
+  }
+#endif
+  char name[32];
+  std::snprintf(name, sizeof(name), "Draw list %d", index);
+  return name;
+}
+}
+
+void vtkDearImGuiDrawProfiler::Series::Push(double sample, int capacity)
+{
+  if (static_cast<int>(this->Samples.size()) != capacity)
+  {
+    this->Samples.assign(capacity, 0.);
+    this->Next = 0;
+    this->Count = 0;
+  }
+  this->Samples[this->Next] = sample;
+  this->Next = (this->Next + 1) % capacity;
+  this->Count = std::min(this->Count + 1, capacity);
+}
+
+vtkDearImGuiDrawProfiler::Statistics vtkDearImGuiDrawProfiler::Series::Get() const
+{
+  Statistics statistics;
+  if (!this->Count)
+  {
+    return statistics;
+  }
+  const int capacity = static_cast<int>(this->Samples.size());
+  statistics.Last = this->Samples[(this->Next + capacity - 1) % capacity];
+  double sum = 0.;
+  for (int i = 0; i < this->Count; ++i)
+  {
+    const double sample = this->Samples[(this->Next + capacity - 1 - i) % capacity];
+    sum += sample;
+    statistics.Maximum = std::max(statistics.Maximum, sample);
+  }
+  statistics.Mean = sum / this->Count;
+  return statistics;
+}
+
+int vtkDearImGuiDrawProfiler::Series::CountAbove(double threshold) const
+{
+  const int capacity = static_cast<int>(this->Samples.size());
+  int count = 0;
+  for (int i = 0; i < this->Count; ++i)
+  {
+    count += this->Samples[(this->Next + capacity - 1 - i) % capacity] > threshold ? 1 : 0;
+  }
+  return count;
+}
+
+vtkDearImGuiDrawProfiler::vtkDearImGuiDrawProfiler() = default;
+
+vtkDearImGuiDrawProfiler::~vtkDearImGuiDrawProfiler() = default;
+
+void vtkDearImGuiDrawProfiler::SetObserverBudget(const char* name, double seconds)
+{
+  if (!name)
+  {
+    return;
+  }
+  if (seconds < 0.)
+  {
+    this->ObserverBudgets.erase(name);
+  }
+  else
+  {
+    this->ObserverBudgets[name] = seconds;
+  }
+  this->Modified();
+}
+
+double vtkDearImGuiDrawProfiler::GetBudget(const std::string& name) const
+{
+  auto found = this->ObserverBudgets.find(name);
+  return found != this->ObserverBudgets.end() ? found->second : this->Budget;
+}
+
+void vtkDearImGuiDrawProfiler::BeginFrame()
+{
+  for (auto& entry : this->Observers)
+  {
+    entry.second.Frame = 0.;
+  }
+  this->InFrame = true;
+}
+
+void vtkDearImGuiDrawProfiler::AddObserverTime(const char* name, double seconds)
+{
+  // ImGuiDrawEvent invoked outside a frame is not the overlay's cost
+  if (!this->InFrame || !name)
+  {
+    return;
+  }
+  ObserverSeries& series = this->Observers[name];
+  series.Frame += seconds;
+  series.IdleFrames = -1; // called, see EndFrame()
+}
+
+void vtkDearImGuiDrawProfiler::EndFrame(double seconds)
+{
+  if (!this->InFrame)
+  {
+    return;
+  }
+  this->InFrame = false;
+  this->DrawEvent.Push(seconds, this->NumberOfFrames);
+
+  double named = 0.;
+  for (const auto& entry : this->Observers)
+  {
+    named += entry.second.Frame;
+  }
+  const double remainder = std::max(seconds - named, 0.);
+  auto unnamed = this->Observers.find(UnnamedObservers);
+  if (remainder > UnnamedThreshold)
+  {
+    ObserverSeries& series = this->Observers[UnnamedObservers];
+    series.Frame = remainder;
+    series.IdleFrames = -1;
+  }
+  else if (unnamed != this->Observers.end())
+  {
+    // ages out like a removed observer
+    unnamed->second.Frame = remainder;
+  }
+
+  std::vector<std::string> over;
+  std::vector<std::string> sustained;
+  for (auto it = this->Observers.begin(); it != this->Observers.end();)
+  {
+    ObserverSeries& series = it->second;
+    // removed observers are forgotten once they left the statistics
+    if (++series.IdleFrames >= this->NumberOfFrames)
+    {
+      it = this->Observers.erase(it);
+      continue;
+    }
+    series.Seconds.Push(series.Frame, this->NumberOfFrames);
+    const double budget = this->GetBudget(it->first);
+    if (budget > 0. && series.Frame > budget)
+    {
+      over.push_back(it->first);
+    }
+    const bool overBudget = budget > 0. && series.Seconds.Get().Mean > budget;
+    if (overBudget && !series.OverBudget)
+    {
+      sustained.push_back(it->first);
+    }
+    series.OverBudget = overBudget;
+    ++it;
+  }
+  for (const std::string& name : sustained)
+  {
+    vtkWarningMacro(<< "ImGuiDrawEvent observer " << name << " is over its budget");
+  }
+  // observers may change the profiler
+  for (const std::string& name : over)
+  {
+    this->InvokeEvent(OverBudgetEvent, const_cast<char*>(name.c_str()));
+  }
+}
+
+void vtkDearImGuiDrawProfiler::MeasureDrawData(const ImDrawData* drawData)
+{
+  if (!drawData)
+  {
+    return;
+  }
+  for (auto& entry : this->Windows)
+  {
+    std::fill(entry.second.Frame, entry.second.Frame + 3, 0.);
+  }
+  for (int n = 0; n < drawData->CmdListsCount; ++n)
+  {
+    const ImDrawList* list = drawData->CmdLists[n];
+    WindowSeries& series = this->Windows[WindowName(list, n)];
+    series.Frame[0] += list->VtxBuffer.Size;
+    series.Frame[1] += list->IdxBuffer.Size;
+    series.Frame[2] += list->CmdBuffer.Size;
+    series.IdleFrames = -1;
+  }
+  for (auto it = this->Windows.begin(); it != this->Windows.end();)
+  {
+    WindowSeries& series = it->second;
+    if (++series.IdleFrames >= this->NumberOfFrames)
+    {
+      it = this->Windows.erase(it);
+      continue;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      series.Counts[i].Push(series.Frame[i], this->NumberOfFrames);
+    }
+    ++it;
+  }
+}
+
+std::vector<vtkDearImGuiDrawProfiler::Observer> vtkDearImGuiDrawProfiler::GetObservers() const
+{
+  std::vector<Observer> observers;
+  observers.reserve(this->Observers.size());
+  for (const auto& entry : this->Observers)
+  {
+    Observer observer;
+    observer.Name = entry.first;
+    observer.Seconds = entry.second.Seconds.Get();
+    observer.Budget = this->GetBudget(entry.first);
+    observer.FramesOverBudget =
+      observer.Budget > 0. ? entry.second.Seconds.CountAbove(observer.Budget) : 0;
+    observer.OverBudget = entry.second.OverBudget;
+    observers.push_back(observer);
+  }
+  return observers;
+}
+
+std::vector<vtkDearImGuiDrawProfiler::Window> vtkDearImGuiDrawProfiler::GetWindows() const
+{
+  std::vector<Window> windows;
+  windows.reserve(this->Windows.size());
+  for (const auto& entry : this->Windows)
+  {
+    Window window;
+    window.Name = entry.first;
+    window.Vertices = entry.second.Counts[0].Get();
+    window.Indices = entry.second.Counts[1].Get();
+    window.Commands = entry.second.Counts[2].Get();
+    windows.push_back(window);
+  }
+  return windows;
+}
+
+std::vector<std::string> vtkDearImGuiDrawProfiler::GetObserversOverBudget() const
+{
+  std::vector<std::string> names;
+  for (const auto& entry : this->Observers)
+  {
+    if (entry.second.OverBudget)
+    {
+      names.push_back(entry.first);
+    }
+  }
+  return names;
+}
+
+vtkDearImGuiDrawProfiler::Statistics vtkDearImGuiDrawProfiler::GetDrawEventSeconds() const
+{
+  return this->DrawEvent.Get();
+}
+
+void vtkDearImGuiDrawProfiler::Reset()
+{
+  this->Observers.clear();
+  this->Windows.clear();
+  this->DrawEvent = Series();
+  this->InFrame = false;
+}
+
+void vtkDearImGuiDrawProfiler::Draw()
+{
+  const Statistics event = this->DrawEvent.Get();
+  ImGui::Text("ImGuiDrawEvent %.2f ms, mean %.2f ms, max %.2f ms", event.Last * 1000.,
+    event.Mean * 1000., event.Maximum * 1000.);
+  float budget = static_cast<float>(this->Budget * 1000.);
+  ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12.f);
+  if (ImGui::SliderFloat("Budget", &budget, 0.f, 16.f, "%.2f ms"))
+  {
+    this->SetBudget(budget / 1000.);
+  }
+  ImGui::SameLine();
+  if (ImGui::SmallButton("Reset"))
+  {
+    this->Reset();
+  }
+
+  if (ImGui::CollapsingHeader("Observers", ImGuiTreeNodeFlags_DefaultOpen) &&
+    vtkDearImGuiTable::Begin("##observers", 6))
+  {
+    vtkDearImGuiTable::SetupColumn("Observer", 1.f);
+    vtkDearImGuiTable::SetupColumn("Last ms", 0.4f);
+    vtkDearImGuiTable::SetupColumn("Mean ms", 0.4f);
+    vtkDearImGuiTable::SetupColumn("Max ms", 0.4f);
+    vtkDearImGuiTable::SetupColumn("Budget ms", 0.4f);
+    vtkDearImGuiTable::SetupColumn("Frames over", 0.4f);
+    vtkDearImGuiTable::HeadersRow();
+    for (const Observer& observer : this->GetObservers())
+    {
+      vtkDearImGuiTable::NextRow();
+      if (observer.OverBudget)
+      {
+        vtkDearImGuiTable::SetRowColor(IM_COL32(170, 50, 50, 110));
+      }
+      vtkDearImGuiTable::NextColumn();
+      ImGui::TextUnformatted(observer.Name.c_str());
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%.2f", observer.Seconds.Last * 1000.);
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%.2f", observer.Seconds.Mean * 1000.);
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%.2f", observer.Seconds.Maximum * 1000.);
+      vtkDearImGuiTable::NextColumn();
+      if (observer.Budget > 0.)
+      {
+        ImGui::Text("%.2f", observer.Budget * 1000.);
+      }
+      else
+      {
+        ImGui::TextDisabled("none");
+      }
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%d", observer.FramesOverBudget);
+    }
+    vtkDearImGuiTable::End();
+  }
+
+  if (ImGui::CollapsingHeader("Windows", ImGuiTreeNodeFlags_DefaultOpen) &&
+    vtkDearImGuiTable::Begin("##windows", 5))
+  {
+    vtkDearImGuiTable::SetupColumn("Window", 1.f);
+    vtkDearImGuiTable::SetupColumn("Vertices", 0.4f);
+    vtkDearImGuiTable::SetupColumn("Indices", 0.4f);
+    vtkDearImGuiTable::SetupColumn("Commands", 0.4f);
+    vtkDearImGuiTable::SetupColumn("Max vertices", 0.4f);
+    vtkDearImGuiTable::HeadersRow();
+    // heaviest first
+    std::vector<Window> windows = this->GetWindows();
+    std::sort(windows.begin(), windows.end(), [](const Window& a, const Window& b)
+      { return a.Vertices.Mean > b.Vertices.Mean; });
+    for (const Window& window : windows)
+    {
+      vtkDearImGuiTable::NextRow();
+      vtkDearImGuiTable::NextColumn();
+      ImGui::TextUnformatted(window.Name.c_str());
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%.0f", window.Vertices.Mean);
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%.0f", window.Indices.Mean);
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%.1f", window.Commands.Mean);
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%.0f", window.Vertices.Maximum);
+    }
+    vtkDearImGuiTable::End();
+  }
+}
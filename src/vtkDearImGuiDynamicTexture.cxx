@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <vtkDearImGuiDynamicTexture.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkScalarsToColors.h>
+#include <vtkSmartPointer.h>
+#include <vtk_glew.h>
+
+#include "imgui.h"
+
+// Without threads (WebAssembly built with USE_PTHREADS=0) scalars are mapped in SetImage().
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define DYNAMIC_TEXTURE_NO_THREADS 1
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiDynamicTexture);
+
+namespace
+{
+template <typename T>
+void MapThroughTable(const T* values, int numberOfComponents, int component, vtkIdType count,
+  const double range[2], const unsigned char* table, unsigned char* rgba)
+{
+  const double scale = range[1] > range[0] ? 256. / (range[1] - range[0]) : 0.;
+  for (vtkIdType i = 0; i < count; ++i)
+  {
+    const double value = static_cast<double>(values[i * numberOfComponents + component]);
+    const int index = std::min(std::max(static_cast<int>((value - range[0]) * scale), 0), 255);
+    std::memcpy(rgba + 4 * i, table + 4 * index, 4);
+  }
+}
+
+void CopyColors(const unsigned char* colors, int numberOfComponents, vtkIdType count,
+  unsigned char* rgba)
+{
+  if (numberOfComponents == 4)
+  {
+    std::memcpy(rgba, colors, static_cast<std::size_t>(count) * 4);
+    return;
+  }
+  for (vtkIdType i = 0; i < count; ++i)
+  {
+    rgba[4 * i + 0] = colors[3 * i + 0];
+    rgba[4 * i + 1] = colors[3 * i + 1];
+    rgba[4 * i + 2] = colors[3 * i + 2];
+    rgba[4 * i + 3] = 255;
+  }
+}
+}
+
+struct vtkDearImGuiDynamicTexture::vtkInternals
+{
+  // An image waiting for conversion to RGBA.
+  struct Source
+  {
+    vtkSmartPointer<vtkDataArray> Scalars;
+    int Width = 0;
+    int Height = 0;
+    int Component = 0;
+    bool UseTable = true;
+    bool UseDataRange = false;
+    double Range[2] = { 0., 1. };
+    unsigned char Table[256 * 4];
+  };
+  // An RGBA image.
+  struct Image
+  {
+    std::vector<unsigned char> Pixels;
+    int Width = 0;
+    int Height = 0;
+  };
+
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  Source Pending;
+  bool HasPending = false;
+  Image Ready;
+  bool HasReady = false;
+  bool Stop = false;
+  std::function<void()> ReadyCallback;
+  std::thread Worker;
+  // images replaced before they reached the texture, counted by every thread
+  std::atomic<unsigned long> DroppedImages{ 0 };
+
+  Image Converting; // worker
+  Image Uploading;  // render thread
+
+  void WorkerLoop();
+  void Convert(Source& source, Image& image);
+  // Hand image over to Upload(), counting an unread image it replaces as dropped.
+  void Publish(Image& image);
+};
+
+void vtkDearImGuiDynamicTexture::vtkInternals::WorkerLoop()
+{
+  vtkDearImGuiTracer::SetThreadName("vtkDearImGuiDynamicTexture");
+  for (;;)
+  {
+    Source source;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Condition.wait(lock, [this]() { return this->Stop || this->HasPending; });
+      if (this->Stop)
+      {
+        return;
+      }
+      source = this->Pending;
+      this->Pending.Scalars = nullptr;
+      this->HasPending = false;
+    }
+    this->Convert(source, this->Converting);
+    this->Publish(this->Converting);
+  }
+}
+
+void vtkDearImGuiDynamicTexture::vtkInternals::Convert(Source& source, Image& image)
+{
+  vtkDearImGuiTracer::Scope scope("MapScalars", "texture");
+  vtkDataArray* scalars = source.Scalars;
+  const vtkIdType count = static_cast<vtkIdType>(source.Width) * source.Height;
+  image.Width = source.Width;
+  image.Height = source.Height;
+  image.Pixels.resize(static_cast<std::size_t>(count) * 4);
+  if (!source.UseTable)
+  {
+    CopyColors(static_cast<const unsigned char*>(scalars->GetVoidPointer(0)),
+      scalars->GetNumberOfComponents(), count, image.Pixels.data());
+    return;
+  }
+  if (source.UseDataRange)
+  {
+    scalars->GetRange(source.Range, source.Component);
+  }
+  switch (scalars->GetDataType())
+  {
+    vtkTemplateMacro(MapThroughTable(static_cast<const VTK_TT*>(scalars->GetVoidPointer(0)),
+      scalars->GetNumberOfComponents(), source.Component, count, source.Range, source.Table,
+      image.Pixels.data()));
+  }
+}
+
+void vtkDearImGuiDynamicTexture::vtkInternals::Publish(Image& image)
+{
+  std::function<void()> callback;
+  bool replaced = false;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    std::swap(this->Ready, image);
+    replaced = this->HasReady;
+    this->HasReady = true;
+    callback = this->ReadyCallback;
+  }
+  if (replaced)
+  {
+    ++this->DroppedImages;
+  }
+  if (callback)
+  {
+    callback();
+  }
+}
+
+vtkDearImGuiDynamicTexture::vtkDearImGuiDynamicTexture()
+  : Internals(new vtkInternals)
+{
+}
+
+vtkDearImGuiDynamicTexture::~vtkDearImGuiDynamicTexture()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+    this->Internals->Stop = true;
+  }
+  this->Internals->Condition.notify_one();
+  if (this->Internals->Worker.joinable())
+  {
+    this->Internals->Worker.join();
+  }
+}
+
+void vtkDearImGuiDynamicTexture::SetReadyCallback(std::function<void()> callback)
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  this->Internals->ReadyCallback = std::move(callback);
+}
+
+unsigned long vtkDearImGuiDynamicTexture::GetDroppedImages() const
+{
+  return this->Internals->DroppedImages.load();
+}
+
+void vtkDearImGuiDynamicTexture::SetImage(
+  vtkImageData* image, vtkScalarsToColors* colors, int component)
+{
+  vtkDataArray* scalars = image ? image->GetPointData()->GetScalars() : nullptr;
+  if (!scalars || component < 0 || component >= scalars->GetNumberOfComponents())
+  {
+    vtkErrorMacro(<< "Image has no scalars to show.");
+    return;
+  }
+  int dimensions[3];
+  image->GetDimensions(dimensions);
+
+  // Copy the first slice and snapshot the colors here, the worker touches neither the
+  // image nor the lookup table.
+  vtkInternals::Source source;
+  source.Width = dimensions[0];
+  source.Height = dimensions[1];
+  source.Component = component;
+  source.Scalars = vtkSmartPointer<vtkDataArray>::Take(scalars->NewInstance());
+  source.Scalars->SetNumberOfComponents(scalars->GetNumberOfComponents());
+  source.Scalars->SetNumberOfTuples(static_cast<vtkIdType>(source.Width) * source.Height);
+  std::memcpy(source.Scalars->GetVoidPointer(0), scalars->GetVoidPointer(0),
+    static_cast<std::size_t>(source.Scalars->GetDataSize()) * scalars->GetDataTypeSize());
+  source.UseTable = colors != nullptr || scalars->GetDataType() != VTK_UNSIGNED_CHAR ||
+    scalars->GetNumberOfComponents() < 3;
+  if (colors)
+  {
+    const double* range = colors->GetRange();
+    source.Range[0] = range[0];
+    source.Range[1] = range[1];
+    for (int i = 0; i < 256; ++i)
+    {
+      const double value = range[0] + (range[1] - range[0]) * (i + 0.5) / 256.;
+      const unsigned char* rgba = colors->MapValue(value);
+      std::memcpy(source.Table + 4 * i, rgba, 4);
+    }
+  }
+  else
+  {
+    source.UseDataRange = true;
+    for (int i = 0; i < 256; ++i)
+    {
+      std::memset(source.Table + 4 * i, i, 3);
+      source.Table[4 * i + 3] = 255;
+    }
+  }
+
+#ifdef DYNAMIC_TEXTURE_NO_THREADS
+  vtkInternals::Image converted;
+  this->Internals->Convert(source, converted);
+  this->Internals->Publish(converted);
+#else
+  vtkInternals& internals = *this->Internals;
+  {
+    std::lock_guard<std::mutex> lock(internals.Mutex);
+    if (internals.HasPending)
+    {
+      ++internals.DroppedImages;
+    }
+    internals.Pending = source;
+    internals.HasPending = true;
+  }
+  if (!internals.Worker.joinable())
+  {
+    internals.Worker = std::thread(&vtkInternals::WorkerLoop, &internals);
+  }
+  internals.Condition.notify_one();
+#endif
+}
+
+void vtkDearImGuiDynamicTexture::SetPixels(const unsigned char* rgba, int width, int height)
+{
+  if (!rgba || width <= 0 || height <= 0)
+  {
+    return;
+  }
+  vtkInternals::Image image;
+  image.Width = width;
+  image.Height = height;
+  image.Pixels.assign(rgba, rgba + static_cast<std::size_t>(width) * height * 4);
+  this->Internals->Publish(image);
+}
+
+void vtkDearImGuiDynamicTexture::Upload()
+{
+  vtkInternals& internals = *this->Internals;
+  {
+    std::lock_guard<std::mutex> lock(internals.Mutex);
+    if (!internals.HasReady)
+    {
+      return;
+    }
+    std::swap(internals.Ready, internals.Uploading);
+    internals.HasReady = false;
+  }
+  const vtkInternals::Image& image = internals.Uploading;
+  const GLsizeiptr size = static_cast<GLsizeiptr>(image.Pixels.size());
+
+  GLint lastTexture, lastUnpackBuffer, lastAlignment, lastRowLength;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+  glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &lastUnpackBuffer);
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &lastAlignment);
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &lastRowLength);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+  if (!this->Texture || this->TextureSize[0] != image.Width ||
+    this->TextureSize[1] != image.Height)
+  {
+    // (re)allocate storage, buffers in flight are orphaned by glBufferData
+    if (!this->Texture)
+    {
+      glGenTextures(1, &this->Texture);
+      glGenBuffers(NumberOfBuffers, this->Buffers);
+    }
+    glBindTexture(GL_TEXTURE_2D, this->Texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.Width, image.Height, 0, GL_RGBA,
+      GL_UNSIGNED_BYTE, nullptr);
+    for (int i = 0; i < NumberOfBuffers; ++i)
+    {
+      glBindBuffer(GL_PIXEL_UNPACK_BUFFER, this->Buffers[i]);
+      glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+      if (this->Fences[i])
+      {
+        glDeleteSync(static_cast<GLsync>(this->Fences[i]));
+        this->Fences[i] = nullptr;
+      }
+    }
+    this->TextureSize[0] = image.Width;
+    this->TextureSize[1] = image.Height;
+  }
+
+  const int slot = this->NextBuffer;
+  bool uploaded = false;
+  if (this->Fences[slot] &&
+    glClientWaitSync(static_cast<GLsync>(this->Fences[slot]), 0, 0) == GL_TIMEOUT_EXPIRED)
+  {
+    // The GPU still reads this buffer. Retry next frame unless a newer image arrives.
+    std::lock_guard<std::mutex> lock(internals.Mutex);
+    if (internals.HasReady)
+    {
+      ++internals.DroppedImages;
+    }
+    else
+    {
+      std::swap(internals.Ready, internals.Uploading);
+      internals.HasReady = true;
+    }
+  }
+  else
+  {
+    if (this->Fences[slot])
+    {
+      glDeleteSync(static_cast<GLsync>(this->Fences[slot]));
+      this->Fences[slot] = nullptr;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, this->Buffers[slot]);
+#ifdef __EMSCRIPTEN__
+    // WebGL has no buffer mapping
+    glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, size, image.Pixels.data());
+#else
+    void* mapped = glMapBufferRange(
+      GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped)
+    {
+      std::memcpy(mapped, image.Pixels.data(), image.Pixels.size());
+      glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+    else
+    {
+      glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, size, image.Pixels.data());
+    }
+#endif
+    glBindTexture(GL_TEXTURE_2D, this->Texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.Width, image.Height, GL_RGBA,
+      GL_UNSIGNED_BYTE, nullptr);
+    this->Fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    this->NextBuffer = (slot + 1) % NumberOfBuffers;
+    uploaded = true;
+  }
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, static_cast<GLuint>(lastUnpackBuffer));
+  glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(lastTexture));
+  glPixelStorei(GL_UNPACK_ALIGNMENT, lastAlignment);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, lastRowLength);
+  if (uploaded)
+  {
+    this->Modified();
+  }
+}
+
+void vtkDearImGuiDynamicTexture::ReleaseGraphicsResources()
+{
+  for (int i = 0; i < NumberOfBuffers; ++i)
+  {
+    if (this->Fences[i])
+    {
+      glDeleteSync(static_cast<GLsync>(this->Fences[i]));
+      this->Fences[i] = nullptr;
+    }
+  }
+  if (this->Texture)
+  {
+    glDeleteBuffers(NumberOfBuffers, this->Buffers);
+    glDeleteTextures(1, &this->Texture);
+    this->Texture = 0;
+    std::fill(this->Buffers, this->Buffers + NumberOfBuffers, 0u);
+  }
+  this->TextureSize[0] = this->TextureSize[1] = 0;
+  this->NextBuffer = 0;
+}
+
+void vtkDearImGuiDynamicTexture::Draw(float width, float height)
+{
+  if (!this->Texture)
+  {
+    ImGui::Dummy(ImVec2(width > 0.f ? width : 1.f, height > 0.f ? height : 1.f));
+    return;
+  }
+  const ImVec2 size(width > 0.f ? width : static_cast<float>(this->TextureSize[0]),
+    height > 0.f ? height : static_cast<float>(this->TextureSize[1]));
+  // rows are stored bottom to top
+  ImGui::Image((ImTextureID)(intptr_t)this->Texture, size,
+    ImVec2(0.f, 1.f), ImVec2(1.f, 0.f));
+}
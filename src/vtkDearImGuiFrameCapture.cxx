@@ -0,0 +1,623 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <vtkDearImGuiFrameCapture.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPNGWriter.h>
+#include <vtkPointData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtk_glew.h>
+
+// Without threads (WebAssembly built with USE_PTHREADS=0) frames are encoded in Collect().
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define FRAME_CAPTURE_NO_THREADS 1
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiFrameCapture);
+
+namespace
+{
+const int NumberOfReadbacks = 3;
+// nanoseconds StopRecording() waits for a readback
+const GLuint64 DrainTimeout = 1000000000;
+
+struct Frame
+{
+  std::vector<unsigned char> Pixels; // RGBA8, rows bottom to top
+  int Width = 0;
+  int Height = 0;
+  std::string Screenshot;
+  unsigned long Recording = 0; // recording the frame belongs to, 0 for none
+  bool Callback = false;
+};
+
+struct Readback
+{
+  GLuint Buffer = 0;
+  GLsizeiptr Capacity = 0;
+  GLsync Fence = nullptr;
+  Frame Request; // without pixels
+};
+
+// "movie.png" -> "movie_000042.png"
+std::string NumberedFileName(const std::string& fileName, unsigned long number)
+{
+  const std::size_t slash = fileName.find_last_of("/\\");
+  std::size_t dot = fileName.find_last_of('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+  {
+    dot = fileName.size();
+  }
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), "_%06lu", number);
+  return fileName.substr(0, dot) + suffix + fileName.substr(dot);
+}
+}
+
+struct vtkDearImGuiFrameCapture::vtkInternals
+{
+  // render thread
+  Readback Readbacks[NumberOfReadbacks];
+  std::deque<int> InFlight; // oldest first
+  GLuint ResolveFramebuffer = 0;
+  GLuint ResolveRenderbuffer = 0;
+  int ResolveSize[2] = { 0, 0 };
+  bool HasCallback = false;
+
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::condition_variable Idle;
+  std::deque<std::unique_ptr<Frame>> Queue;
+  std::vector<std::unique_ptr<Frame>> FreeFrames;
+  std::vector<std::string> Errors;
+  FrameCallback Callback;
+  bool Busy = false;
+  bool Stop = false;
+  std::thread Encoder;
+
+  // Recording. Only changed while the encoder is idle.
+  unsigned long RecordingId = 0;
+  std::string FileName;
+  int Format = PNG;
+  int FrameRate = 30;
+  FILE* File = nullptr;
+  unsigned long FrameNumber = 0;
+  int RecordingSize[2] = { 0, 0 };
+  bool ReportedSizeChange = false;
+  std::vector<unsigned char> Planes; // encoder
+
+  std::unique_ptr<Frame> AcquireFrame();
+  // Returns false when the queue is full.
+  bool Enqueue(std::unique_ptr<Frame>& frame, int maximumQueuedFrames);
+  void WaitForIdle(std::unique_lock<std::mutex>& lock);
+  void EncoderLoop();
+  void Encode(Frame& frame, const FrameCallback& callback);
+  void WritePNG(const std::string& fileName, const Frame& frame);
+  void WriteRecording(const Frame& frame);
+  void Error(const std::string& message);
+};
+
+std::unique_ptr<Frame> vtkDearImGuiFrameCapture::vtkInternals::AcquireFrame()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (this->FreeFrames.empty())
+  {
+    return std::unique_ptr<Frame>(new Frame);
+  }
+  std::unique_ptr<Frame> frame = std::move(this->FreeFrames.back());
+  this->FreeFrames.pop_back();
+  return frame;
+}
+
+bool vtkDearImGuiFrameCapture::vtkInternals::Enqueue(
+  std::unique_ptr<Frame>& frame, int maximumQueuedFrames)
+{
+#ifdef FRAME_CAPTURE_NO_THREADS
+  (void)maximumQueuedFrames;
+  this->Encode(*frame, this->Callback);
+  this->FreeFrames.push_back(std::move(frame));
+  return true;
+#else
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    // screenshots are never dropped
+    if (static_cast<int>(this->Queue.size()) >= maximumQueuedFrames && frame->Screenshot.empty())
+    {
+      this->FreeFrames.push_back(std::move(frame));
+      return false;
+    }
+    this->Queue.push_back(std::move(frame));
+    if (!this->Encoder.joinable())
+    {
+      this->Encoder = std::thread(&vtkInternals::EncoderLoop, this);
+    }
+  }
+  this->Condition.notify_one();
+  return true;
+#endif
+}
+
+void vtkDearImGuiFrameCapture::vtkInternals::WaitForIdle(std::unique_lock<std::mutex>& lock)
+{
+  this->Idle.wait(lock, [this]() { return this->Queue.empty() && !this->Busy; });
+}
+
+void vtkDearImGuiFrameCapture::vtkInternals::EncoderLoop()
+{
+  vtkDearImGuiTracer::SetThreadName("vtkDearImGuiFrameCapture");
+  for (;;)
+  {
+    std::unique_ptr<Frame> frame;
+    FrameCallback callback;
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Condition.wait(lock, [this]() { return this->Stop || !this->Queue.empty(); });
+      if (this->Queue.empty())
+      {
+        return;
+      }
+      frame = std::move(this->Queue.front());
+      this->Queue.pop_front();
+      this->Busy = true;
+      callback = this->Callback;
+    }
+    this->Encode(*frame, callback);
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      this->FreeFrames.push_back(std::move(frame));
+      this->Busy = false;
+    }
+    this->Idle.notify_all();
+  }
+}
+
+void vtkDearImGuiFrameCapture::vtkInternals::Encode(Frame& frame, const FrameCallback& callback)
+{
+  vtkDearImGuiTracer::Scope scope("EncodeFrame", "capture");
+  // the framebuffer alpha is not meaningful once the overlay is blended in
+  const std::size_t count = static_cast<std::size_t>(frame.Width) * frame.Height;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    frame.Pixels[4 * i + 3] = 255;
+  }
+  if (!frame.Screenshot.empty())
+  {
+    this->WritePNG(frame.Screenshot, frame);
+  }
+  if (frame.Recording != 0 && frame.Recording == this->RecordingId)
+  {
+    this->WriteRecording(frame);
+  }
+  if (frame.Callback && callback)
+  {
+    callback(frame.Pixels.data(), frame.Width, frame.Height);
+  }
+}
+
+void vtkDearImGuiFrameCapture::vtkInternals::WritePNG(
+  const std::string& fileName, const Frame& frame)
+{
+  vtkNew<vtkUnsignedCharArray> scalars;
+  scalars->SetNumberOfComponents(4);
+  // wraps the pixels, the writer only reads them
+  scalars->SetArray(const_cast<unsigned char*>(frame.Pixels.data()),
+    static_cast<vtkIdType>(frame.Pixels.size()), 1);
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(frame.Width, frame.Height, 1);
+  image->GetPointData()->SetScalars(scalars);
+  vtkNew<vtkPNGWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(image);
+  writer->Write();
+  if (writer->GetErrorCode() != 0)
+  {
+    this->Error("Cannot write " + fileName);
+  }
+}
+
+void vtkDearImGuiFrameCapture::vtkInternals::WriteRecording(const Frame& frame)
+{
+  if (this->Format == PNG)
+  {
+    this->WritePNG(NumberedFileName(this->FileName, this->FrameNumber++), frame);
+    return;
+  }
+  if (this->FrameNumber == 0)
+  {
+    this->RecordingSize[0] = frame.Width;
+    this->RecordingSize[1] = frame.Height;
+    if (this->Format == Y4M)
+    {
+      std::fprintf(this->File, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", frame.Width,
+        frame.Height, this->FrameRate);
+    }
+  }
+  else if (frame.Width != this->RecordingSize[0] || frame.Height != this->RecordingSize[1])
+  {
+    if (!this->ReportedSizeChange)
+    {
+      this->ReportedSizeChange = true;
+      this->Error("Frame size changed while recording " + this->FileName + ", frames dropped.");
+    }
+    return;
+  }
+  ++this->FrameNumber;
+
+  const std::size_t width = static_cast<std::size_t>(frame.Width);
+  bool written = true;
+  if (this->Format == Raw)
+  {
+    for (int y = frame.Height - 1; y >= 0; --y)
+    {
+      written &= std::fwrite(&frame.Pixels[4 * width * y], 4, width, this->File) == width;
+    }
+  }
+  else
+  {
+    // BT.601 limited range, planes top to bottom
+    const std::size_t planeSize = width * frame.Height;
+    this->Planes.resize(3 * planeSize);
+    unsigned char* luma = this->Planes.data();
+    unsigned char* cb = luma + planeSize;
+    unsigned char* cr = cb + planeSize;
+    std::size_t i = 0;
+    for (int y = frame.Height - 1; y >= 0; --y)
+    {
+      const unsigned char* rgba = &frame.Pixels[4 * width * y];
+      for (std::size_t x = 0; x < width; ++x, ++i, rgba += 4)
+      {
+        const int r = rgba[0], g = rgba[1], b = rgba[2];
+        luma[i] = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        cb[i] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        cr[i] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+      }
+    }
+    written = std::fputs("FRAME\n", this->File) >= 0 &&
+      std::fwrite(this->Planes.data(), 1, this->Planes.size(), this->File) ==
+        this->Planes.size();
+  }
+  if (!written)
+  {
+    this->Error("Cannot write to " + this->FileName);
+  }
+}
+
+void vtkDearImGuiFrameCapture::vtkInternals::Error(const std::string& message)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Errors.push_back(message);
+}
+
+vtkDearImGuiFrameCapture::vtkDearImGuiFrameCapture()
+  : Internals(new vtkInternals)
+{
+}
+
+vtkDearImGuiFrameCapture::~vtkDearImGuiFrameCapture()
+{
+  this->StopRecording();
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+    this->Internals->Stop = true;
+  }
+  this->Internals->Condition.notify_one();
+  // pending screenshots are written first
+  if (this->Internals->Encoder.joinable())
+  {
+    this->Internals->Encoder.join();
+  }
+}
+
+void vtkDearImGuiFrameCapture::Screenshot(const char* fileName)
+{
+  this->PendingScreenshot = fileName ? fileName : "";
+}
+
+bool vtkDearImGuiFrameCapture::StartRecording(const char* fileName, int format)
+{
+  this->StopRecording();
+  if (!fileName || format < PNG || format > Y4M)
+  {
+    return false;
+  }
+  FILE* file = nullptr;
+  if (format != PNG)
+  {
+    file = std::fopen(fileName, "wb");
+    if (!file)
+    {
+      vtkErrorMacro(<< "Cannot open " << fileName);
+      return false;
+    }
+  }
+  vtkInternals& internals = *this->Internals;
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+  internals.WaitForIdle(lock);
+  ++internals.RecordingId;
+  internals.FileName = fileName;
+  internals.Format = format;
+  internals.FrameRate = this->FrameRate;
+  internals.File = file;
+  internals.FrameNumber = 0;
+  internals.ReportedSizeChange = false;
+  this->Recording = true;
+  return true;
+}
+
+void vtkDearImGuiFrameCapture::StopRecording()
+{
+  if (!this->Recording)
+  {
+    return;
+  }
+  this->Recording = false;
+  vtkInternals& internals = *this->Internals;
+  // the last frames of the recording are still being read back
+  const bool inFlight = std::any_of(internals.InFlight.begin(), internals.InFlight.end(),
+    [&internals](int slot)
+    { return internals.Readbacks[slot].Request.Recording == internals.RecordingId; });
+  if (inFlight)
+  {
+    this->CollectReadbacks(true);
+  }
+  std::unique_lock<std::mutex> lock(internals.Mutex);
+  internals.WaitForIdle(lock);
+  ++internals.RecordingId;
+  if (internals.File)
+  {
+    std::fclose(internals.File);
+    internals.File = nullptr;
+  }
+}
+
+void vtkDearImGuiFrameCapture::SetFrameCallback(FrameCallback callback)
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  this->Internals->HasCallback = static_cast<bool>(callback);
+  this->Internals->Callback = std::move(callback);
+}
+
+bool vtkDearImGuiFrameCapture::IsCapturing() const
+{
+  return !this->PendingScreenshot.empty() || this->Recording || this->Internals->HasCallback;
+}
+
+bool vtkDearImGuiFrameCapture::HasPendingReadbacks() const
+{
+  return !this->Internals->InFlight.empty();
+}
+
+std::size_t vtkDearImGuiFrameCapture::GetGraphicsMemorySize() const
+{
+  const vtkInternals& internals = *this->Internals;
+  std::size_t bytes = 0;
+  for (const Readback& readback : internals.Readbacks)
+  {
+    bytes += static_cast<std::size_t>(readback.Capacity);
+  }
+  if (internals.ResolveRenderbuffer)
+  {
+    bytes += static_cast<std::size_t>(internals.ResolveSize[0]) * internals.ResolveSize[1] * 4;
+  }
+  return bytes;
+}
+
+void vtkDearImGuiFrameCapture::Capture(int width, int height)
+{
+  vtkInternals& internals = *this->Internals;
+  if (!this->IsCapturing() || width <= 0 || height <= 0)
+  {
+    return;
+  }
+  Frame request;
+  request.Width = width;
+  request.Height = height;
+  request.Screenshot = this->PendingScreenshot;
+  request.Recording = this->Recording ? internals.RecordingId : 0;
+  request.Callback = internals.HasCallback;
+  if (request.Screenshot.empty())
+  {
+    std::lock_guard<std::mutex> lock(internals.Mutex);
+    if (static_cast<int>(internals.Queue.size()) >= this->MaximumQueuedFrames)
+    {
+      // the encoder is behind, do not read back a frame that would be dropped
+      ++this->DroppedFrames;
+      return;
+    }
+  }
+  if (static_cast<int>(internals.InFlight.size()) == NumberOfReadbacks)
+  {
+    // all pack buffers are in flight, a screenshot waits for the next frame
+    ++this->DroppedFrames;
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope("CaptureFrame", "capture");
+
+  GLint lastPackBuffer, lastAlignment, lastReadFramebuffer, lastDrawFramebuffer, sampleBuffers;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &lastPackBuffer);
+  glGetIntegerv(GL_PACK_ALIGNMENT, &lastAlignment);
+  glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &lastReadFramebuffer);
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &lastDrawFramebuffer);
+  glGetIntegerv(GL_SAMPLE_BUFFERS, &sampleBuffers);
+
+  if (sampleBuffers > 0)
+  {
+    // multisampled pixels cannot be read, resolve them first
+    if (!internals.ResolveFramebuffer)
+    {
+      glGenFramebuffers(1, &internals.ResolveFramebuffer);
+      glGenRenderbuffers(1, &internals.ResolveRenderbuffer);
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, internals.ResolveFramebuffer);
+    if (internals.ResolveSize[0] != width || internals.ResolveSize[1] != height)
+    {
+      GLint lastRenderbuffer;
+      glGetIntegerv(GL_RENDERBUFFER_BINDING, &lastRenderbuffer);
+      glBindRenderbuffer(GL_RENDERBUFFER, internals.ResolveRenderbuffer);
+      glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+      glBindRenderbuffer(GL_RENDERBUFFER, static_cast<GLuint>(lastRenderbuffer));
+      glFramebufferRenderbuffer(
+        GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, internals.ResolveRenderbuffer);
+      internals.ResolveSize[0] = width;
+      internals.ResolveSize[1] = height;
+    }
+    glBlitFramebuffer(
+      0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, internals.ResolveFramebuffer);
+  }
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+  const GLsizeiptr size = static_cast<GLsizeiptr>(width) * height * 4;
+#ifdef __EMSCRIPTEN__
+  // WebGL2 cannot map buffers and getBufferSubData would wait anyway, read directly.
+  std::unique_ptr<Frame> frame = internals.AcquireFrame();
+  frame->Pixels.resize(static_cast<std::size_t>(size));
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, frame->Pixels.data());
+  frame->Width = width;
+  frame->Height = height;
+  frame->Screenshot = request.Screenshot;
+  frame->Recording = request.Recording;
+  frame->Callback = request.Callback;
+  if (!internals.Enqueue(frame, this->MaximumQueuedFrames))
+  {
+    ++this->DroppedFrames;
+  }
+#else
+  int slot = 0;
+  while (std::find(internals.InFlight.begin(), internals.InFlight.end(), slot) !=
+    internals.InFlight.end())
+  {
+    ++slot;
+  }
+  Readback& readback = internals.Readbacks[slot];
+  if (!readback.Buffer)
+  {
+    glGenBuffers(1, &readback.Buffer);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.Buffer);
+  if (readback.Capacity < size)
+  {
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    readback.Capacity = size;
+  }
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  readback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  readback.Request = request;
+  internals.InFlight.push_back(slot);
+#endif
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(lastPackBuffer));
+  glPixelStorei(GL_PACK_ALIGNMENT, lastAlignment);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(lastReadFramebuffer));
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(lastDrawFramebuffer));
+  this->PendingScreenshot.clear();
+  ++this->CapturedFrames;
+}
+
+void vtkDearImGuiFrameCapture::Collect()
+{
+  this->CollectReadbacks(false);
+}
+
+void vtkDearImGuiFrameCapture::CollectReadbacks(bool wait)
+{
+  vtkInternals& internals = *this->Internals;
+  std::vector<std::string> errors;
+  {
+    std::lock_guard<std::mutex> lock(internals.Mutex);
+    errors.swap(internals.Errors);
+  }
+  for (const std::string& error : errors)
+  {
+    vtkErrorMacro(<< error);
+  }
+  if (internals.InFlight.empty())
+  {
+    return;
+  }
+
+  GLint lastPackBuffer;
+  glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &lastPackBuffer);
+  while (!internals.InFlight.empty())
+  {
+    Readback& readback = internals.Readbacks[internals.InFlight.front()];
+    const GLenum status = wait
+      ? glClientWaitSync(readback.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, DrainTimeout)
+      : glClientWaitSync(readback.Fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+    {
+      break;
+    }
+    glDeleteSync(readback.Fence);
+    readback.Fence = nullptr;
+    internals.InFlight.pop_front();
+    if (status == GL_WAIT_FAILED)
+    {
+      continue;
+    }
+
+    std::unique_ptr<Frame> frame = internals.AcquireFrame();
+    const std::size_t size = static_cast<std::size_t>(readback.Request.Width) *
+      readback.Request.Height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.Buffer);
+    const void* pixels = glMapBufferRange(
+      GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+    if (!pixels)
+    {
+      ++this->DroppedFrames;
+      continue;
+    }
+    frame->Pixels.resize(size);
+    std::memcpy(frame->Pixels.data(), pixels, size);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    frame->Width = readback.Request.Width;
+    frame->Height = readback.Request.Height;
+    frame->Screenshot = readback.Request.Screenshot;
+    frame->Recording = readback.Request.Recording;
+    frame->Callback = readback.Request.Callback;
+    // drained frames may exceed the queue by the readbacks, they are the last ones
+    if (!internals.Enqueue(
+          frame, this->MaximumQueuedFrames + (wait ? NumberOfReadbacks : 0)))
+    {
+      ++this->DroppedFrames;
+    }
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, static_cast<GLuint>(lastPackBuffer));
+}
+
+void vtkDearImGuiFrameCapture::ReleaseGraphicsResources()
+{
+  vtkInternals& internals = *this->Internals;
+  for (Readback& readback : internals.Readbacks)
+  {
+    if (readback.Fence)
+    {
+      glDeleteSync(readback.Fence);
+      readback.Fence = nullptr;
+    }
+    if (readback.Buffer)
+    {
+      glDeleteBuffers(1, &readback.Buffer);
+      readback.Buffer = 0;
+      readback.Capacity = 0;
+    }
+  }
+  internals.InFlight.clear();
+  if (internals.ResolveFramebuffer)
+  {
+    glDeleteFramebuffers(1, &internals.ResolveFramebuffer);
+    glDeleteRenderbuffers(1, &internals.ResolveRenderbuffer);
+    internals.ResolveFramebuffer = internals.ResolveRenderbuffer = 0;
+    internals.ResolveSize[0] = internals.ResolveSize[1] = 0;
+  }
+}
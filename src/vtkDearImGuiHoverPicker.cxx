@@ -0,0 +1,436 @@
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <vtkDearImGuiHoverPicker.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkActor.h>
+#include <vtkCamera.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkGenericCell.h>
+#include <vtkIdList.h>
+#include <vtkMapper.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+#include <vtkStaticCellLocator.h>
+
+#include "imgui.h"
+
+// Without threads (WebAssembly built with USE_PTHREADS=0) queries run inside Update().
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define HOVER_PICKER_NO_THREADS 1
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiHoverPicker);
+
+namespace
+{
+// Number of point data arrays reported per hit.
+const int MaxPointValues = 8;
+
+void TransformPoint(const double matrix[16], const double in[3], double out[3])
+{
+  const double homogeneous[4] = { in[0], in[1], in[2], 1. };
+  double result[4];
+  vtkMatrix4x4::MultiplyPoint(matrix, homogeneous, result);
+  const double w = result[3] != 0. ? result[3] : 1.;
+  out[0] = result[0] / w;
+  out[1] = result[1] / w;
+  out[2] = result[2] / w;
+}
+}
+
+struct vtkDearImGuiHoverPicker::vtkInternals
+{
+  // A locator (re)build, or a removal when Data is null.
+  struct Build
+  {
+    const void* Key;
+    vtkSmartPointer<vtkDataSet> Data;
+  };
+  struct Target
+  {
+    const void* Key;
+    double Matrix[16];
+  };
+  struct Query
+  {
+    double P0[3];
+    double P1[3];
+    std::vector<Target> Targets;
+  };
+  struct Hit
+  {
+    bool Valid = false;
+    const void* Key = nullptr;
+    vtkIdType CellId = -1;
+    double Position[3] = { 0., 0., 0. };
+    std::vector<std::pair<std::string, double>> PointValues;
+  };
+
+  // UI thread
+  struct Entry
+  {
+    vtkWeakPointer<vtkActor> Actor;
+    vtkDataSet* Source = nullptr; // identity only
+    vtkMTimeType MTime = 0;
+    unsigned long Frame = 0;
+  };
+  std::unordered_map<vtkActor*, Entry> Entries;
+  unsigned long Frame = 0;
+  int LastPosition[2] = { -1, -1 };
+  vtkMTimeType LastStateMTime = 0;
+  unsigned long ConsumedSerial = 0;
+
+  // shared, guarded by Mutex
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::vector<Build> Builds;
+  Query PendingQuery;
+  bool HasQuery = false;
+  bool Stop = false;
+  Hit LatestHit;
+  unsigned long HitSerial = 0;
+  std::function<void()> ResultCallback;
+
+  // worker thread
+  struct Located
+  {
+    vtkSmartPointer<vtkDataSet> Data;
+    vtkSmartPointer<vtkStaticCellLocator> Locator;
+  };
+  std::unordered_map<const void*, Located> Locators;
+  vtkNew<vtkGenericCell> Cell;
+  std::vector<double> Weights;
+  Query LastQuery;
+  bool HasLastQuery = false;
+  std::thread Worker;
+
+  void WorkerLoop();
+  void ProcessPending();
+  Hit Answer(const Query& query);
+  void Publish(Hit&& hit);
+};
+
+void vtkDearImGuiHoverPicker::vtkInternals::WorkerLoop()
+{
+  vtkDearImGuiTracer::SetThreadName("vtkDearImGuiHoverPicker");
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->Condition.wait(
+        lock, [this]() { return this->Stop || this->HasQuery || !this->Builds.empty(); });
+      if (this->Stop)
+      {
+        return;
+      }
+    }
+    this->ProcessPending();
+  }
+}
+
+void vtkDearImGuiHoverPicker::vtkInternals::ProcessPending()
+{
+  std::vector<Build> builds;
+  bool hasQuery = false;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    builds.swap(this->Builds);
+    hasQuery = this->HasQuery;
+    if (hasQuery)
+    {
+      this->LastQuery = std::move(this->PendingQuery);
+      this->HasLastQuery = true;
+      this->HasQuery = false;
+    }
+  }
+  // Answer with the locators at hand first, builds can take a while.
+  if (hasQuery)
+  {
+    this->Publish(this->Answer(this->LastQuery));
+  }
+  for (const Build& build : builds)
+  {
+    if (!build.Data)
+    {
+      this->Locators.erase(build.Key);
+      continue;
+    }
+    vtkDearImGuiTracer::Scope scope("BuildLocator", "hover");
+    Located located;
+    located.Data = build.Data;
+    located.Locator = vtkSmartPointer<vtkStaticCellLocator>::New();
+    located.Locator->SetDataSet(build.Data);
+    located.Locator->BuildLocator();
+    this->Locators[build.Key] = located;
+  }
+  if (!builds.empty() && this->HasLastQuery)
+  {
+    this->Publish(this->Answer(this->LastQuery));
+  }
+}
+
+vtkDearImGuiHoverPicker::vtkInternals::Hit vtkDearImGuiHoverPicker::vtkInternals::Answer(
+  const Query& query)
+{
+  vtkDearImGuiTracer::Scope scope("HoverQuery", "hover");
+  Hit hit;
+  double closest = VTK_DOUBLE_MAX;
+  for (const Target& target : query.Targets)
+  {
+    auto found = this->Locators.find(target.Key);
+    if (found == this->Locators.end())
+    {
+      continue; // not built yet
+    }
+    // intersect in model coordinates, t is invariant under the transform.
+    double inverse[16];
+    vtkMatrix4x4::Invert(target.Matrix, inverse);
+    double p0[3], p1[3];
+    TransformPoint(inverse, query.P0, p0);
+    TransformPoint(inverse, query.P1, p1);
+
+    double t, x[3], pcoords[3];
+    int subId;
+    vtkIdType cellId;
+    if (!found->second.Locator->IntersectWithLine(
+          p0, p1, 0., t, x, pcoords, subId, cellId, this->Cell) ||
+      t >= closest)
+    {
+      continue;
+    }
+    closest = t;
+    hit.Valid = true;
+    hit.Key = target.Key;
+    hit.CellId = cellId;
+    TransformPoint(target.Matrix, x, hit.Position);
+
+    // interpolate point data at the hit, the locator may have left another cell in Cell
+    hit.PointValues.clear();
+    found->second.Data->GetCell(cellId, this->Cell);
+    vtkIdList* pointIds = this->Cell->GetPointIds();
+    this->Weights.resize(static_cast<std::size_t>(pointIds->GetNumberOfIds()));
+    double location[3];
+    this->Cell->EvaluateLocation(subId, pcoords, location, this->Weights.data());
+    vtkPointData* pointData = found->second.Data->GetPointData();
+    const int numberOfArrays = std::min(pointData->GetNumberOfArrays(), MaxPointValues);
+    for (int i = 0; i < numberOfArrays; ++i)
+    {
+      vtkDataArray* array = pointData->GetArray(i);
+      if (!array)
+      {
+        continue;
+      }
+      double squaredSum = 0.;
+      double value = 0.;
+      for (int c = 0; c < array->GetNumberOfComponents(); ++c)
+      {
+        value = 0.;
+        for (vtkIdType k = 0; k < pointIds->GetNumberOfIds(); ++k)
+        {
+          value += this->Weights[k] * array->GetComponent(pointIds->GetId(k), c);
+        }
+        squaredSum += value * value;
+      }
+      if (array->GetNumberOfComponents() > 1)
+      {
+        value = std::sqrt(squaredSum);
+      }
+      hit.PointValues.emplace_back(array->GetName() ? array->GetName() : "(unnamed)", value);
+    }
+  }
+  return hit;
+}
+
+void vtkDearImGuiHoverPicker::vtkInternals::Publish(Hit&& hit)
+{
+  std::function<void()> callback;
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->LatestHit = std::move(hit);
+    ++this->HitSerial;
+    callback = this->ResultCallback;
+  }
+  if (callback)
+  {
+    callback();
+  }
+}
+
+vtkDearImGuiHoverPicker::vtkDearImGuiHoverPicker()
+  : Internals(new vtkInternals)
+{
+}
+
+vtkDearImGuiHoverPicker::~vtkDearImGuiHoverPicker()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+    this->Internals->Stop = true;
+  }
+  this->Internals->Condition.notify_one();
+  if (this->Internals->Worker.joinable())
+  {
+    this->Internals->Worker.join();
+  }
+}
+
+void vtkDearImGuiHoverPicker::SetResultCallback(std::function<void()> callback)
+{
+  std::lock_guard<std::mutex> lock(this->Internals->Mutex);
+  this->Internals->ResultCallback = std::move(callback);
+}
+
+void vtkDearImGuiHoverPicker::Clear()
+{
+  this->LastResult = Result();
+}
+
+void vtkDearImGuiHoverPicker::Update(vtkRenderer* renderer, int x, int y)
+{
+  vtkInternals& internals = *this->Internals;
+  if (!renderer)
+  {
+    this->Clear();
+    return;
+  }
+
+  // Snapshot the pickable actors, shallow copying inputs that changed.
+  ++internals.Frame;
+  std::vector<vtkInternals::Build> builds;
+  vtkInternals::Query query;
+  vtkMTimeType stateMTime = renderer->GetActiveCamera()->GetMTime();
+  vtkPropCollection* props = renderer->GetViewProps();
+  vtkCollectionSimpleIterator it;
+  props->InitTraversal(it);
+  while (vtkProp* prop = props->GetNextProp(it))
+  {
+    vtkActor* actor = vtkActor::SafeDownCast(prop);
+    if (!actor || !actor->GetVisibility() || !actor->GetPickable() || !actor->GetMapper())
+    {
+      continue;
+    }
+    vtkDataSet* data = actor->GetMapper()->GetInputAsDataSet();
+    if (!data || data->GetNumberOfCells() == 0)
+    {
+      continue;
+    }
+    vtkInternals::Entry& entry = internals.Entries[actor];
+    entry.Actor = actor;
+    entry.Frame = internals.Frame;
+    if (entry.Source != data || entry.MTime != data->GetMTime())
+    {
+      vtkSmartPointer<vtkDataSet> copy = vtkSmartPointer<vtkDataSet>::Take(data->NewInstance());
+      copy->ShallowCopy(data);
+      builds.push_back({ actor, copy });
+      entry.Source = data;
+      entry.MTime = data->GetMTime();
+    }
+    vtkMatrix4x4* matrix = actor->GetMatrix();
+    stateMTime = std::max(stateMTime, matrix->GetMTime());
+    vtkInternals::Target target;
+    target.Key = actor;
+    std::copy(&matrix->Element[0][0], &matrix->Element[0][0] + 16, target.Matrix);
+    query.Targets.push_back(target);
+  }
+  for (auto entry = internals.Entries.begin(); entry != internals.Entries.end();)
+  {
+    if (entry->second.Frame != internals.Frame)
+    {
+      builds.push_back({ entry->first, nullptr });
+      entry = internals.Entries.erase(entry);
+    }
+    else
+    {
+      ++entry;
+    }
+  }
+
+  // Nothing moved: the last answer still holds.
+  const bool moved = x != internals.LastPosition[0] || y != internals.LastPosition[1] ||
+    stateMTime != internals.LastStateMTime;
+  if (moved || !builds.empty())
+  {
+    internals.LastPosition[0] = x;
+    internals.LastPosition[1] = y;
+    internals.LastStateMTime = stateMTime;
+
+    double p0[4], p1[4];
+    renderer->SetDisplayPoint(x, y, 0.);
+    renderer->DisplayToWorld();
+    renderer->GetWorldPoint(p0);
+    renderer->SetDisplayPoint(x, y, 1.);
+    renderer->DisplayToWorld();
+    renderer->GetWorldPoint(p1);
+    for (int i = 0; i < 3; ++i)
+    {
+      query.P0[i] = p0[3] != 0. ? p0[i] / p0[3] : p0[i];
+      query.P1[i] = p1[3] != 0. ? p1[i] / p1[3] : p1[i];
+    }
+    {
+      std::lock_guard<std::mutex> lock(internals.Mutex);
+      std::move(builds.begin(), builds.end(), std::back_inserter(internals.Builds));
+      internals.PendingQuery = std::move(query);
+      internals.HasQuery = true;
+    }
+#ifdef HOVER_PICKER_NO_THREADS
+    internals.ProcessPending();
+#else
+    if (!internals.Worker.joinable())
+    {
+      internals.Worker = std::thread(&vtkInternals::WorkerLoop, &internals);
+    }
+    internals.Condition.notify_one();
+#endif
+  }
+
+  // Pick up the newest answer.
+  std::lock_guard<std::mutex> lock(internals.Mutex);
+  if (internals.HitSerial == internals.ConsumedSerial)
+  {
+    return;
+  }
+  internals.ConsumedSerial = internals.HitSerial;
+  const vtkInternals::Hit& hit = internals.LatestHit;
+  this->LastResult = Result();
+  auto entry = internals.Entries.find(static_cast<vtkActor*>(const_cast<void*>(hit.Key)));
+  if (hit.Valid && entry != internals.Entries.end())
+  {
+    this->LastResult.Valid = true;
+    this->LastResult.Actor = entry->second.Actor;
+    this->LastResult.CellId = hit.CellId;
+    std::copy(hit.Position, hit.Position + 3, this->LastResult.Position);
+    this->LastResult.PointValues = hit.PointValues;
+  }
+}
+
+void vtkDearImGuiHoverPicker::DrawTooltip()
+{
+  vtkActor* actor = this->LastResult.Actor;
+  if (!this->LastResult.Valid || !actor)
+  {
+    return;
+  }
+  const double* position = this->LastResult.Position;
+  ImGui::BeginTooltip();
+  ImGui::Text("%s (%p)", actor->GetClassName(), static_cast<void*>(actor));
+  ImGui::Text("Cell %lld", static_cast<long long>(this->LastResult.CellId));
+  ImGui::Text("Position %.4g, %.4g, %.4g", position[0], position[1], position[2]);
+  for (const auto& value : this->LastResult.PointValues)
+  {
+    ImGui::Text("%s: %.6g", value.first.c_str(), value.second);
+  }
+  ImGui::EndTooltip();
+}
@@ -1,8 +1,31 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
+#include <vtkDearImGuiActionRegistry.h>
+#include <vtkDearImGuiDatasetLoader.h>
+#include <vtkDearImGuiDrawBatcher.h>
+#include <vtkDearImGuiDrawProfiler.h>
+#include <vtkDearImGuiDynamicTexture.h>
+#include <vtkDearImGuiFrameCapture.h>
+#include <vtkDearImGuiHoverPicker.h>
+#include <vtkDearImGuiOcclusionCuller.h>
 #include <vtkDearImGuiInjector.h>
+#include <vtkDearImGuiInputQueue.h>
+#include <vtkDearImGuiOutliner.h>
+#include <vtkDearImGuiParameterCommitter.h>
+#include <vtkDearImGuiPropertyEditor.h>
+#include <vtkDearImGuiRemoteServer.h>
+#include <vtkDearImGuiResourceMonitor.h>
+#include <vtkDearImGuiSDFFont.h>
+#include <vtkDearImGuiSMPPanel.h>
+#include <vtkDearImGuiSharedMemoryPublisher.h>
+#include <vtkDearImGuiTracer.h>
+#include <vtkDearImGuiTransferFunctionEditor.h>
 
 #include <vtkCallbackCommand.h>
 #include <vtkInteractorStyleSwitch.h>
@@ -12,6 +35,7 @@
 #include <vtkOpenGLRenderWindow.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
+#include <vtkSmartPointer.h>
 #include <vtk_glew.h>
 
 #if defined(GL_ES_VERSION_3_0) && !defined(IMGUI_IMPL_OPENGL_ES3)
@@ -70,13 +94,383 @@ const std::unordered_map<int, int> imguiToVtkCursors(
     { ImGuiMouseCursor_ResizeNESW, VTK_CURSOR_SIZENE },
     { ImGuiMouseCursor_ResizeNWSE, VTK_CURSOR_SIZENW }, { ImGuiMouseCursor_Hand, VTK_CURSOR_HAND },
     { ImGuiMouseCursor_NotAllowed, VTK_CURSOR_DEFAULT } });
+
+// Monotonic time in seconds, used for frame pacing.
+double Now()
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+}
+
+// Handlers of the input events routed through DispatchEv.
+class vtkDearImGuiEventRouting
+{
+public:
+  // Feeds an event to ImGui. Returning false keeps it from the interactor style.
+  using Update = bool (*)(vtkDearImGuiInjector* self, vtkInteractorStyle* style, ImGuiIO& io);
+  // Runs after the interactor style handled the event, or not.
+  using After = void (*)(vtkDearImGuiInjector* self, vtkInteractorStyle* style);
+
+  // Input goes through the injector's queue, which feeds it to ImGui at the start of
+  // the frames, see vtkDearImGuiInputQueue.
+  static bool Move(vtkDearImGuiInjector* self, vtkInteractorStyle* style, ImGuiIO&)
+  {
+    vtkRenderWindowInteractor* interactor = style->GetInteractor();
+    const int* position = interactor->GetEventPosition();
+    // ImGui's origin is at the top left
+    self->InputQueue.AddMousePos(static_cast<float>(position[0]),
+      static_cast<float>(interactor->GetSize()[1] - position[1]));
+    return true;
+  }
+
+  // double clicks are presses, ImGui detects them
+  template <int Button, bool Down>
+  static bool Press(vtkDearImGuiInjector* self, vtkInteractorStyle* style, ImGuiIO& io)
+  {
+    Move(self, style, io);
+    self->InputQueue.AddMouseButton(Button, Down);
+    return true;
+  }
+
+  template <int Vertical, int Horizontal>
+  static bool Wheel(vtkDearImGuiInjector* self, vtkInteractorStyle*, ImGuiIO&)
+  {
+    self->InputQueue.AddMouseWheel(static_cast<float>(Horizontal), static_cast<float>(Vertical));
+    return true;
+  }
+
+  static bool Leave(vtkDearImGuiInjector* self, vtkInteractorStyle*, ImGuiIO&)
+  {
+    self->InputQueue.AddMouseLeave();
+    return true;
+  }
+
+  static bool Char(vtkDearImGuiInjector* self, vtkInteractorStyle* style, ImGuiIO& io);
+
+  template <bool Down>
+  static bool Key(vtkDearImGuiInjector* self, vtkInteractorStyle* style, ImGuiIO& io)
+  {
+    return KeyEvent(self, style, io, Down);
+  }
+  static bool KeyEvent(
+    vtkDearImGuiInjector* self, vtkInteractorStyle* style, ImGuiIO& io, bool down);
+
+  static void Hover(vtkDearImGuiInjector* self, vtkInteractorStyle*)
+  {
+    if (self->HoverPicking)
+    {
+      // the cursor position is queried when the frame begins
+      self->RequestRender();
+    }
+  }
+
+  static void Timer(vtkDearImGuiInjector* self, vtkInteractorStyle* style);
+
+  // Keep rendering a few frames after mouse input so that ImGui can react to it.
+  static void UpdateTimer(vtkDearImGuiInjector* self, vtkRenderWindowInteractor* interactor);
+
+  // Whether ImGui keeps an event from the interactor style.
+  static bool Captured(vtkDearImGuiInjector* self, vtkRenderWindowInteractor* interactor,
+    unsigned long eid, int capture);
+};
+
+namespace
+{
+enum EventCapture
+{
+  NoCapture = 0,
+  MouseCapture,
+  KeyboardCapture
+};
+
+struct EventRoute
+{
+  unsigned long Event;
+  const char* Name;
+  int Capture;      // an EventCapture
+  bool Interaction; // switches frame pacing to the interactive rate
+  bool UpdateTimer;
+  vtkDearImGuiEventRouting::Update Update;
+  // interactor style handlers, in order
+  void (vtkInteractorStyle::*First)();
+  void (vtkInteractorStyle::*Second)();
+  vtkDearImGuiEventRouting::After After;
+};
+
+using R = vtkDearImGuiEventRouting;
+using S = vtkInteractorStyle;
+
+// One route per observed event, in the order the observers are installed.
+constexpr EventRoute EventRoutes[] = {
+  { vtkCommand::EnterEvent, "EnterEvent", NoCapture, true, false, &R::Move, nullptr, nullptr,
+    nullptr },
+  { vtkCommand::LeaveEvent, "LeaveEvent", NoCapture, true, false, &R::Leave, nullptr, nullptr,
+    nullptr },
+  { vtkCommand::MouseMoveEvent, "MouseMoveEvent", MouseCapture, true, false, &R::Move,
+    &S::OnMouseMove, nullptr, &R::Hover },
+  { vtkCommand::LeftButtonPressEvent, "LeftButtonPressEvent", MouseCapture, true, true,
+    &R::Press<ImGuiMouseButton_Left, true>, &S::OnLeftButtonDown, nullptr, nullptr },
+  { vtkCommand::LeftButtonReleaseEvent, "LeftButtonReleaseEvent", MouseCapture, true, true,
+    &R::Press<ImGuiMouseButton_Left, false>, &S::OnLeftButtonUp, nullptr, nullptr },
+  { vtkCommand::LeftButtonDoubleClickEvent, "LeftButtonDoubleClickEvent", MouseCapture, true,
+    true, &R::Press<ImGuiMouseButton_Left, true>, &S::OnLeftButtonDoubleClick, nullptr,
+    nullptr },
+  { vtkCommand::MiddleButtonPressEvent, "MiddleButtonPressEvent", MouseCapture, true, true,
+    &R::Press<ImGuiMouseButton_Middle, true>, &S::OnMiddleButtonDown, nullptr, nullptr },
+  { vtkCommand::MiddleButtonReleaseEvent, "MiddleButtonReleaseEvent", MouseCapture, true, true,
+    &R::Press<ImGuiMouseButton_Middle, false>, &S::OnMiddleButtonUp, nullptr, nullptr },
+  { vtkCommand::MiddleButtonDoubleClickEvent, "MiddleButtonDoubleClickEvent", MouseCapture,
+    true, true, &R::Press<ImGuiMouseButton_Middle, true>, &S::OnMiddleButtonDoubleClick,
+    nullptr, nullptr },
+  { vtkCommand::RightButtonPressEvent, "RightButtonPressEvent", MouseCapture, true, true,
+    &R::Press<ImGuiMouseButton_Right, true>, &S::OnRightButtonDown, nullptr, nullptr },
+  { vtkCommand::RightButtonReleaseEvent, "RightButtonReleaseEvent", MouseCapture, true, true,
+    &R::Press<ImGuiMouseButton_Right, false>, &S::OnRightButtonUp, nullptr, nullptr },
+  { vtkCommand::RightButtonDoubleClickEvent, "RightButtonDoubleClickEvent", MouseCapture, true,
+    true, &R::Press<ImGuiMouseButton_Right, true>, &S::OnRightButtonDoubleClick, nullptr,
+    nullptr },
+  { vtkCommand::MouseWheelForwardEvent, "MouseWheelForwardEvent", MouseCapture, true, true,
+    &R::Wheel<1, 0>, &S::OnMouseWheelForward, nullptr, nullptr },
+  { vtkCommand::MouseWheelBackwardEvent, "MouseWheelBackwardEvent", MouseCapture, true, true,
+    &R::Wheel<-1, 0>, &S::OnMouseWheelBackward, nullptr, nullptr },
+  { vtkCommand::MouseWheelLeftEvent, "MouseWheelLeftEvent", MouseCapture, true, true,
+    &R::Wheel<0, 1>, &S::OnMouseWheelLeft, nullptr, nullptr },
+  { vtkCommand::MouseWheelRightEvent, "MouseWheelRightEvent", MouseCapture, true, true,
+    &R::Wheel<0, -1>, &S::OnMouseWheelRight, nullptr, nullptr },
+  { vtkCommand::ExposeEvent, "ExposeEvent", NoCapture, false, false, nullptr, &S::OnExpose,
+    nullptr, nullptr },
+  { vtkCommand::ConfigureEvent, "ConfigureEvent", NoCapture, false, false, nullptr,
+    &S::OnConfigure, nullptr, nullptr },
+  { vtkCommand::TimerEvent, "TimerEvent", NoCapture, false, false, nullptr, &S::OnTimer,
+    nullptr, &R::Timer },
+  { vtkCommand::KeyPressEvent, "KeyPressEvent", KeyboardCapture, true, false, &R::Key<true>,
+    &S::OnKeyDown, &S::OnKeyPress, nullptr },
+  { vtkCommand::KeyReleaseEvent, "KeyReleaseEvent", KeyboardCapture, true, false,
+    &R::Key<false>, &S::OnKeyUp, &S::OnKeyRelease, nullptr },
+  { vtkCommand::CharEvent, "CharEvent", KeyboardCapture, true, false, &R::Char, &S::OnChar,
+    nullptr, nullptr },
+};
+constexpr std::size_t NumberOfEventRoutes = sizeof(EventRoutes) / sizeof(EventRoutes[0]);
+
+// Index of the routes by event id, generated at compile time.
+constexpr std::size_t MaxRoutedEvent(std::size_t i = 0, std::size_t maximum = 0)
+{
+  return i == NumberOfEventRoutes
+    ? maximum
+    : MaxRoutedEvent(i + 1, EventRoutes[i].Event > maximum ? EventRoutes[i].Event : maximum);
+}
+
+constexpr signed char EventRouteOf(std::size_t eid, std::size_t i = 0)
+{
+  return i == NumberOfEventRoutes
+    ? -1
+    : EventRoutes[i].Event == eid ? static_cast<signed char>(i) : EventRouteOf(eid, i + 1);
+}
+
+template <std::size_t... I>
+struct EventIds
+{
+};
+template <std::size_t N, std::size_t... I>
+struct MakeEventIds : MakeEventIds<N - 1, N - 1, I...>
+{
+};
+template <std::size_t... I>
+struct MakeEventIds<0, I...>
+{
+  using Type = EventIds<I...>;
+};
+
+template <std::size_t... I>
+constexpr std::array<signed char, sizeof...(I)> MakeEventIndex(EventIds<I...>)
+{
+  return { { EventRouteOf(I)... } };
+}
+
+constexpr std::size_t EventIndexSize = MaxRoutedEvent() + 1;
+constexpr std::array<signed char, EventIndexSize> EventIndex =
+  MakeEventIndex(MakeEventIds<EventIndexSize>::Type());
+
+const EventRoute* FindEventRoute(unsigned long eid)
+{
+  const int route = eid < EventIndexSize ? EventIndex[eid] : -1;
+  return route >= 0 ? &EventRoutes[route] : nullptr;
+}
+}
+
+bool vtkDearImGuiEventRouting::Char(
+  vtkDearImGuiInjector* self, vtkInteractorStyle* style, ImGuiIO& io)
+{
+#ifdef USES_WIN32
+  std::string keySym = style->GetInteractor()->GetKeySym();
+  unsigned int key = 0;
+  if (KeySymToVKeyCode.find(keySym.c_str()) != KeySymToVKeyCode.end())
+  {
+    key = KeySymToVKeyCode.at(keySym.c_str());
+  }
+  else
+  {
+    key = static_cast<unsigned int>(style->GetInteractor()->GetKeyCode());
+  }
+  self->InputQueue.AddCharacter(key);
+#else
+  self->InputQueue.AddCharacters(style->GetInteractor()->GetKeySym());
+#endif
+  return true;
+}
+
+bool vtkDearImGuiEventRouting::KeyEvent(
+  vtkDearImGuiInjector* self, vtkInteractorStyle* style, ImGuiIO& io, bool down)
+{
+  vtkRenderWindowInteractor* interactor = style->GetInteractor();
+  std::string keySym = interactor->GetKeySym() ? interactor->GetKeySym() : "";
+  bool alt = false, ctrl = false, shift = false, super = false;
+#ifdef USES_X11
+  // Do not rely on VTK giving correct info for ctrl, shift, alt keys on X11.
+  // So, check for literal in key sym string
+  const auto& nul = std::string::npos;
+  alt = (keySym.find("Alt") != nul) || (keySym.find("alt") != nul);
+  ctrl = (keySym.find("Control") != nul) || (keySym.find("control") != nul);
+  shift = (keySym.find("Shift") != nul) || (keySym.find("shift") != nul);
+  super = (keySym == "Win_L") || (keySym == "Win_R") || (keySym == "Super_L") ||
+    (keySym == "Super_R");
+#elif defined(USES_SDL2)
+  alt = interactor->GetAltKey();
+  ctrl = interactor->GetControlKey();
+  shift = interactor->GetShiftKey();
+  super = (SDL_GetModState() & KMOD_GUI) ? true : false;
+#elif defined(USES_WIN32)
+  alt = interactor->GetAltKey();
+  ctrl = interactor->GetControlKey();
+  shift = interactor->GetShiftKey();
+  super = (GetKeyState(VK_LWIN) || GetKeyState(VK_RWIN)) ? true : false;
+#endif
+  self->InputQueue.AddModifiers(ctrl && down, shift && down, alt && down, super && down);
+
+#if IMGUI_VERSION_NUM >= 18700
+  const int key = vtkDearImGuiInputQueue::ToImGuiKey(keySym.c_str());
+  if (key != ImGuiKey_None)
+  {
+    self->InputQueue.AddKey(key, down);
+  }
+#else
+  // index into io.KeysDown, see the key map in SetUp
+  unsigned int key = 0;
+#ifdef USES_X11
+  key = interactor->GetKeyCode();
+#elif defined(USES_SDL2)
+  key = SDL_GetScancodeFromKey(static_cast<unsigned int>(interactor->GetKeyCode()));
+  if (!key)
+  {
+    key = static_cast<unsigned int>(interactor->GetKeyCode());
+  }
+#elif defined(USES_WIN32)
+  if (KeySymToVKeyCode.find(keySym.c_str()) != KeySymToVKeyCode.end())
+  {
+    key = KeySymToVKeyCode.at(keySym.c_str());
+  }
+  else
+  {
+    key = static_cast<unsigned int>(interactor->GetKeyCode());
+  }
+#endif
+  self->InputQueue.AddKey(static_cast<int>(key), down);
+#endif
+
+  // one lookup per key press, whatever the number of shortcuts
+  if (down && !io.WantTextInput &&
+    self->Actions->TriggerShortcut(keySym.c_str(), interactor->GetControlKey() != 0,
+      interactor->GetShiftKey() != 0, interactor->GetAltKey() != 0))
+  {
+    self->WakeUp();
+    return false;
+  }
+  return true;
+}
+
+void vtkDearImGuiEventRouting::Timer(vtkDearImGuiInjector* self, vtkInteractorStyle* style)
+{
+  self->RequestRender();
+  if (--(self->ImGuiFrameCntsRemained) == 0)
+  {
+    style->GetInteractor()->DestroyTimer(self->ImGuiForceUpdateTimer);
+    self->ImGuiForceUpdateTimer = -1;
+  }
+}
+
+void vtkDearImGuiEventRouting::UpdateTimer(
+  vtkDearImGuiInjector* self, vtkRenderWindowInteractor* interactor)
+{
+  self->UpdateMouseCursor(interactor->GetRenderWindow());
+  if (self->ImGuiForceUpdateTimer == -1)
+  {
+    self->ImGuiForceUpdateTimer = interactor->CreateRepeatingTimer(10); // 10ms is fast enough
+    self->ImGuiFrameCntsRemained = 5; // repeating 5 render calls is enough
+  }
+  else
+  {
+    interactor->ResetTimer(self->ImGuiForceUpdateTimer);
+    self->ImGuiFrameCntsRemained = 5;
+  }
+}
+
+bool vtkDearImGuiEventRouting::Captured(vtkDearImGuiInjector* self,
+  vtkRenderWindowInteractor* interactor, unsigned long eid, int capture)
+{
+  const ImGuiIO& io = ImGui::GetIO();
+  const bool mouse = capture == MouseCapture;
+  if (mouse ? self->GrabMouse : self->GrabKeyboard)
+  {
+    return false;
+  }
+  const bool wants = mouse ? io.WantCaptureMouse : io.WantCaptureKeyboard;
+  const vtkDearImGuiInjector::CapturePolicy& policy =
+    mouse ? self->MouseCapturePolicy : self->KeyboardCapturePolicy;
+  return policy ? policy(eid, wants, interactor->GetEventPosition()) : wants;
 }
 
 vtkDearImGuiInjector::vtkDearImGuiInjector()
 {
   // Start DearImGui
   IMGUI_CHECKVERSION();
+  vtkDearImGuiAllocator::Install();
   ImGui::CreateContext();
+  // a fresh hover result needs a frame to show up
+  this->HoverPicker->SetResultCallback([this]() { this->WakeUp(); });
+  this->DatasetLoader->SetPostFunction(
+    [this](std::function<void()> command) { return this->PostCommand(std::move(command)); });
+  this->SMPPanel->SetPostFunction(
+    [this](std::function<void()> command) { return this->PostCommand(std::move(command)); });
+
+  // built-in menus
+  vtkDearImGuiActionRegistry* actions = this->Actions;
+  actions->AddToggle("Input/Grab Mouse", &this->GrabMouse);
+  actions->AddToggle("Input/Grab Keyboard", &this->GrabKeyboard);
+  actions->AddAction("Input/Hardware Cursor",
+    []() { ImGui::GetIO().MouseDrawCursor = !ImGui::GetIO().MouseDrawCursor; }, nullptr,
+    []() { return ImGui::GetIO().MouseDrawCursor; });
+#ifndef IMGUI_DISABLE_DEMO_WINDOWS
+  actions->AddToggle("Tools/ImGui Demo", &this->ShowDemo);
+#endif
+#ifndef IMGUI_DISABLE_METRICS_WINDOW
+  // '/' separates menus
+  actions->AddToggle("Tools/Metrics & Debugger", &this->ShowAppMetrics);
+#endif
+#ifndef IMGUI_DISABLE_DEMO_WINDOWS
+  actions->AddToggle("Tools/Style Editor", &this->ShowAppStyleEditor);
+  actions->AddToggle("Tools/About Dear ImGui", &this->ShowAppAbout);
+#endif
+  actions->AddToggle("Tools/Outliner", &this->ShowOutliner);
+  actions->AddToggle("Tools/Parameters", &this->ShowParameters);
+  actions->AddToggle("Tools/SMP Backends", &this->ShowSMPPanel);
+  actions->AddToggle("Tools/Resources", &this->ShowResources);
+  actions->AddToggle("Tools/Loads", &this->ShowLoads);
+  actions->AddToggle("Tools/Draw Profile", &this->ShowDrawProfile);
+  actions->AddToggle("Tools/Grab Mouse", &this->GrabMouse);
+  actions->AddToggle("Tools/Grab Keyboard", &this->GrabKeyboard);
+  actions->AddAction(
+    "Tools/Command Palette", [actions]() { actions->OpenPalette(); }, "Ctrl+Shift+P");
 }
 
 vtkDearImGuiInjector::~vtkDearImGuiInjector()
@@ -101,15 +495,22 @@ void vtkDearImGuiInjector::Inject(vtkRenderWindowInteractor* interactor)
   {
     return;
   }
+  if (this->OcclusionCulling)
+  {
+    renWin->StencilCapableOn();
+  }
 
   // intercept interactor
   this->EventCallbackCommand->SetClientData(this);
   this->EventCallbackCommand->SetCallback(&vtkDearImGuiInjector::DispatchEv);
   interactor->AddObserver(vtkCommand::StartEvent, this, &vtkDearImGuiInjector::PumpEv);
+  // Render requests are coalesced here while frame pacing is enabled.
+  interactor->AddObserver(vtkCommand::RenderEvent, this, &vtkDearImGuiInjector::OnRenderRequest);
 
   // intercept renderer
   renWin->AddObserver(vtkCommand::StartEvent, this, &vtkDearImGuiInjector::BeginDearImGuiOverlay);
   renWin->AddObserver(vtkCommand::RenderEvent, this, &vtkDearImGuiInjector::RenderDearImGuiOverlay);
+  renWin->AddObserver(vtkCommand::EndEvent, this, &vtkDearImGuiInjector::EndRenderTrace);
 
   // Safely exit when vtk app exits
   interactor->AddObserver(vtkCommand::ExitEvent, this, &vtkDearImGuiInjector::TearDown);
@@ -133,7 +534,8 @@ bool vtkDearImGuiInjector::SetUp(vtkRenderWindow* renWin)
                                                         // (optional)
 
   // Keyboard mapping. Dear ImGui will use those indices to peek into the
-  // io.KeysDown[] array.
+  // io.KeysDown[] array. Newer versions get ImGuiKey values, see vtkDearImGuiInputQueue.
+#if IMGUI_VERSION_NUM < 18700
 #ifdef USES_X11
   io.KeyMap[ImGuiKey_Tab] = XStringToKeysym("Tab") & 0xff;
   io.KeyMap[ImGuiKey_LeftArrow] = XStringToKeysym("Left") & 0xff;
@@ -204,6 +606,7 @@ bool vtkDearImGuiInjector::SetUp(vtkRenderWindow* renWin)
   io.KeyMap[ImGuiKey_Y] = 'Y';
   io.KeyMap[ImGuiKey_Z] = 'Z';
 #endif
+#endif
 #if defined(_WIN32)
   io.BackendPlatformName = renWin->GetClassName();
   io.ImeWindowHandle = renWin->GetGenericWindowId();
@@ -212,6 +615,11 @@ bool vtkDearImGuiInjector::SetUp(vtkRenderWindow* renWin)
   this->FinishedSetup = status;
   this->InvokeEvent(
     vtkDearImGuiInjector::ImGuiSetupEvent, reinterpret_cast<void*>(&this->FinishedSetup));
+  // observers added the fonts, the backend creates the font texture on the first frame
+  if (this->SDFFont->HasFonts() && !this->SDFFont->Build(io.Fonts))
+  {
+    vtkErrorMacro(<< "Failed to build the distance field font atlas");
+  }
   return status;
 }
 
@@ -222,6 +630,29 @@ void vtkDearImGuiInjector::TearDown(vtkObject* caller, unsigned long eid, void*
   {
     interactor->SetDone(true);
   }
+  for (auto& texture : this->DynamicTextures)
+  {
+    texture->ReleaseGraphicsResources();
+  }
+  for (auto& texture : this->RetiredDynamicTextures)
+  {
+    texture->ReleaseGraphicsResources();
+  }
+  this->RetiredDynamicTextures.clear();
+  for (auto& editor : this->TransferFunctionEditors)
+  {
+    editor->ReleaseGraphicsResources();
+  }
+  for (auto& editor : this->RetiredTransferFunctionEditors)
+  {
+    editor->ReleaseGraphicsResources();
+  }
+  this->RetiredTransferFunctionEditors.clear();
+  this->StopPublishing();
+  this->FrameCapture->StopRecording();
+  this->FrameCapture->ReleaseGraphicsResources();
+  this->RemoteServer->Close();
+  this->SDFFont->ReleaseGraphicsResources();
   ImGui_ImplOpenGL3_Shutdown();
   this->InvokeEvent(vtkDearImGuiInjector::ImGuiTearDownEvent, nullptr);
   vtkDebugMacro(<< "tear down");
@@ -232,6 +663,8 @@ void vtkDearImGuiInjector::BeginDearImGuiOverlay(
 {
   vtkDebugMacro(<< "BeginDearImGuiOverlay");
   auto renWin = vtkRenderWindow::SafeDownCast(caller);
+  this->RenderStartTime = vtkDearImGuiTracer::GetActive() ? vtkDearImGuiTracer::Now() : -1.;
+  vtkDearImGuiTracer::Scope scope("BeginDearImGuiOverlay", "injector");
 
   // Ensure valid DearImGui context exists.
   if (!ImGui::GetCurrentContext())
@@ -246,6 +679,12 @@ void vtkDearImGuiInjector::BeginDearImGuiOverlay(
     return; // try next time when vtkRenderWindow finished first render
   }
 
+  // A frame spans from here to the next BeginDearImGuiOverlay.
+  vtkDearImGuiAllocator::GetInstance()->BeginFrame();
+
+  // Run work posted from other threads before anyone draws.
+  this->DrainPostedCommands();
+
   // Setup display size (every frame to accommodate for window resizing)
   ImGuiIO& io = ImGui::GetIO();
   int* size = renWin->GetSize();
@@ -263,8 +702,12 @@ void vtkDearImGuiInjector::BeginDearImGuiOverlay(
     (this->Time > 0.0 && this->Time < currentTime) ? (currentTime - this->Time) : (1. / 60.);
   this->Time = currentTime;
 
+  // one transition per button and key each frame, the rest waits for the next
   auto interactor = renWin->GetInteractor();
-  this->UpdateMousePosAndButtons(interactor);
+  if (this->InputQueue.Apply())
+  {
+    this->WakeUp();
+  }
   this->UpdateMouseCursor(renWin);
 
   vtkDebugMacro(<< "new frame begin");
@@ -272,37 +715,24 @@ void vtkDearImGuiInjector::BeginDearImGuiOverlay(
   // Begin ImGui drawing
   ImGui_ImplOpenGL3_NewFrame();
   ImGui::NewFrame();
+#ifndef IMGUI_INJECTOR_DISABLE_MENU_BAR
   // Menu Bar
-  if (ImGui::BeginMainMenuBar())
-  {
-    if (ImGui::BeginMenu("Input"))
-    {
-      ImGui::MenuItem("Grab Mouse", NULL, &this->GrabMouse);
-      ImGui::MenuItem("Grab Keyboard", NULL, &this->GrabKeyboard);
-      ImGui::MenuItem("Hardware Cursor", NULL, &io.MouseDrawCursor);
-      ImGui::EndMenu();
-    }
-    if (ImGui::BeginMenu("Tools"))
-    {
-      ImGui::MenuItem("ImGui Demo", NULL, &this->ShowDemo);
-      ImGui::MenuItem("Metrics/Debugger", NULL, &this->ShowAppMetrics);
-      ImGui::MenuItem("Style Editor", NULL, &this->ShowAppStyleEditor);
-      ImGui::MenuItem("About Dear ImGui", NULL, &this->ShowAppAbout);
-      ImGui::MenuItem("Grab Mouse", NULL, &this->GrabMouse);
-      ImGui::MenuItem("Grab Keyboard", NULL, &this->GrabKeyboard);
-      ImGui::EndMenu();
-    }
-    ImGui::EndMainMenuBar();
-  }
+  this->Actions->DrawMenuBar();
+#endif
+#ifndef IMGUI_DISABLE_DEMO_WINDOWS
   if (this->ShowDemo)
   {
     ImGui::SetNextWindowCollapsed(true, ImGuiCond_Once);
     ImGui::ShowDemoWindow(&this->ShowDemo);
   }
+#endif
+#ifndef IMGUI_DISABLE_METRICS_WINDOW
   if (this->ShowAppMetrics)
   {
     ImGui::ShowMetricsWindow(&this->ShowAppMetrics);
   }
+#endif
+#ifndef IMGUI_DISABLE_DEMO_WINDOWS
   if (this->ShowAppStyleEditor)
   {
     ImGui::Begin("Style editor", &this->ShowAppStyleEditor);
@@ -313,7 +743,112 @@ void vtkDearImGuiInjector::BeginDearImGuiOverlay(
   {
     ImGui::ShowAboutWindow(&this->ShowAppAbout);
   }
-  this->InvokeEvent(ImGuiDrawEvent);
+#endif
+  if (this->ShowOutliner)
+  {
+    ImGui::SetNextWindowSize(ImVec2(420, 480), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Outliner", &this->ShowOutliner))
+    {
+      this->Outliner->Draw(renWin);
+    }
+    ImGui::End();
+  }
+  if (this->ShowParameters)
+  {
+    ImGui::SetNextWindowSize(ImVec2(520, 240), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Parameters", &this->ShowParameters))
+    {
+      this->ParameterCommitter->DrawMetrics();
+    }
+    ImGui::End();
+  }
+  if (this->ShowSMPPanel)
+  {
+    ImGui::SetNextWindowSize(ImVec2(560, 320), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("SMP Backends", &this->ShowSMPPanel))
+    {
+      this->SMPPanel->Draw();
+    }
+    ImGui::End();
+  }
+  if (this->ShowResources)
+  {
+    ImGui::SetNextWindowSize(ImVec2(560, 420), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Resources", &this->ShowResources))
+    {
+      this->ResourceMonitor->Draw();
+    }
+    ImGui::End();
+  }
+  if (this->ShowLoads)
+  {
+    ImGui::SetNextWindowSize(ImVec2(520, 200), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Loads", &this->ShowLoads))
+    {
+      this->DatasetLoader->Draw();
+    }
+    ImGui::End();
+  }
+  if (this->ShowDrawProfile)
+  {
+    ImGui::SetNextWindowSize(ImVec2(560, 360), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin("Draw Profile", &this->ShowDrawProfile))
+    {
+      this->DrawProfiler->Draw();
+    }
+    ImGui::End();
+  }
+  {
+    vtkDearImGuiTracer::Scope drawScope("ImGuiDrawEvent", "injector");
+    this->DrawProfiler->BeginFrame();
+    const double drawStart = Now();
+    this->InvokeEvent(ImGuiDrawEvent);
+    this->DrawProfiler->EndFrame(Now() - drawStart);
+  }
+  this->Actions->DrawPalette();
+  // apply widget edits in one batch, before this frame renders
+  this->PropertyEditor->Commit();
+  for (auto& editor : this->TransferFunctionEditors)
+  {
+    editor->Commit();
+  }
+  const double commitWait = this->ParameterCommitter->Update();
+  if (this->ParameterTimer != -1 && Now() >= this->ParameterTimerDue)
+  {
+    this->ParameterTimer = -1; // fired
+  }
+  // a debounced commit needs a frame even when no input comes
+  if (commitWait >= 0 && interactor &&
+    (this->ParameterTimer == -1 || Now() + commitWait < this->ParameterTimerDue))
+  {
+    if (this->ParameterTimer != -1)
+    {
+      interactor->DestroyTimer(this->ParameterTimer);
+    }
+    this->ParameterTimer =
+      interactor->CreateOneShotTimer(static_cast<unsigned long>(commitWait * 1000.) + 1);
+    this->ParameterTimerDue = Now() + commitWait;
+  }
+  // benchmarks run on a worker, collect their timings
+  if (this->SMPPanel->Step())
+  {
+    this->WakeUp();
+  }
+
+  if (this->HoverPicking && interactor)
+  {
+    int x, y;
+    interactor->GetLastEventPosition(x, y);
+    this->HoverPicker->Update(interactor->FindPokedRenderer(x, y), x, y);
+    if (this->ShowHoverTooltip && !io.WantCaptureMouse)
+    {
+      this->HoverPicker->DrawTooltip();
+    }
+  }
+  if (this->OcclusionCulling)
+  {
+    this->OcclusionCuller->BeginFrame(renWin);
+  }
 
   vtkDebugMacro(<< "new frame end");
 }
@@ -322,127 +857,402 @@ void vtkDearImGuiInjector::RenderDearImGuiOverlay(
   vtkObject* caller, unsigned long eid, void* callData)
 {
   vtkDebugMacro(<< "RenderDearImGuiOverlay");
+  vtkDearImGuiTracer::Scope scope("RenderDearImGuiOverlay", "injector");
   auto renWin = vtkRenderWindow::SafeDownCast(caller);
   auto openGLrenWin = vtkOpenGLRenderWindow::SafeDownCast(renWin);
   ImGuiIO& io = ImGui::GetIO();
+  // the overlay covers the culled pixels
+  this->OcclusionCuller->EndFrame();
   if (io.Fonts->IsBuilt())
   {
     ImGui::Render();
+    for (auto& texture : this->RetiredDynamicTextures)
+    {
+      texture->ReleaseGraphicsResources();
+    }
+    this->RetiredDynamicTextures.clear();
+    for (auto& texture : this->DynamicTextures)
+    {
+      texture->Upload();
+    }
+    for (auto& editor : this->RetiredTransferFunctionEditors)
+    {
+      editor->ReleaseGraphicsResources();
+    }
+    this->RetiredTransferFunctionEditors.clear();
+    for (auto& editor : this->TransferFunctionEditors)
+    {
+      editor->Upload();
+    }
     auto fbo = openGLrenWin->GetRenderFramebuffer();
     fbo->Bind();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    ImDrawData* drawData = ImGui::GetDrawData();
+    this->DrawProfiler->MeasureDrawData(drawData);
+    if (!this->OcclusionCulling)
+    {
+      this->OcclusionCuller->Reset();
+    }
+    else if (this->OcclusionCuller->Update(drawData))
+    {
+      this->WakeUp(); // a window moved off culled pixels
+    }
+    if (this->BatchDrawCalls)
+    {
+      // base vertices need GL 3.2, the backend advertises them through this flag
+      const bool hasVtxOffset = (io.BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset) != 0;
+      drawData = this->DrawBatcher->Batch(drawData, hasVtxOffset);
+    }
+    this->RemoteServer->SendDrawData(drawData);
+    // after sending, the protocol carries no callbacks
+    this->SDFFont->Prepare(drawData);
+    ImGui_ImplOpenGL3_RenderDrawData(drawData);
+    // hand finished readbacks to the encoder before issuing a new one
+    this->FrameCapture->Collect();
+    if (this->FrameCapture->IsCapturing())
+    {
+      int size[2];
+      fbo->GetLastSize(size);
+      this->FrameCapture->Capture(size[0], size[1]);
+    }
     fbo->UnBind();
+    if (this->ShowResources)
+    {
+      this->MeasureResources(renWin);
+    }
   }
 }
 
-void vtkDearImGuiInjector::InstallEventCallback(vtkRenderWindowInteractor* interactor)
+void vtkDearImGuiInjector::MeasureResources(vtkRenderWindow* renWin)
 {
-  auto iObserver = interactor->GetInteractorStyle();
-  if (iObserver == nullptr)
+  vtkDearImGuiResourceMonitor* monitor = this->ResourceMonitor;
+  ImGuiIO& io = ImGui::GetIO();
+  ImDrawData* drawData = ImGui::GetDrawData();
+  // the backend keeps the atlas as RGBA32 and streams the draw data into one buffer pair
+  monitor->SetOverlayResource(
+    "Font atlas", static_cast<std::size_t>(io.Fonts->TexWidth) * io.Fonts->TexHeight * 4);
+  monitor->SetOverlayResource("Draw buffers",
+    static_cast<std::size_t>(drawData->TotalVtxCount) * sizeof(ImDrawVert) +
+      static_cast<std::size_t>(drawData->TotalIdxCount) * sizeof(ImDrawIdx));
+  std::size_t bytes = 0;
+  for (auto& texture : this->DynamicTextures)
   {
-    return;
+    bytes += texture->GetGraphicsMemorySize();
   }
-  auto styleBase = vtkInteractorStyle::SafeDownCast(iObserver);
-  if (styleBase == nullptr)
+  monitor->SetOverlayResource("Dynamic textures", bytes);
+  bytes = 0;
+  for (auto& editor : this->TransferFunctionEditors)
   {
-    return;
+    bytes += editor->GetGraphicsMemorySize();
   }
+  monitor->SetOverlayResource("Transfer function tables", bytes);
+  monitor->SetOverlayResource("Frame capture", this->FrameCapture->GetGraphicsMemorySize());
+  monitor->Update(renWin);
+}
 
-  this->currentIStyle = nullptr;
-  if (styleBase->IsA("vtkInteractorStyleSwitchBase"))
+void vtkDearImGuiInjector::EndRenderTrace(vtkObject* caller, unsigned long eid, void* callData)
+{
+  if (this->RenderStartTime >= 0.)
   {
-    this->currentIStyle = vtkInteractorStyleSwitch::SafeDownCast(styleBase)->GetCurrentStyle();
+    vtkDearImGuiTracer::AddSpan(
+      "vtkRenderWindow::Render", "vtk", this->RenderStartTime, vtkDearImGuiTracer::Now());
+    this->RenderStartTime = -1.;
   }
-  else
+}
+
+namespace
+{
+// Forwards ImGuiDrawEvent to an observer, records it as a named span and reports its
+// time to the profiler.
+class vtkNamedDrawCommand : public vtkCommand
+{
+public:
+  static vtkNamedDrawCommand* New() { return new vtkNamedDrawCommand; }
+  vtkTypeMacro(vtkNamedDrawCommand, vtkCommand);
+
+  void Execute(vtkObject* caller, unsigned long eid, void* callData) override
   {
-    this->currentIStyle = styleBase;
+    const double start = Now();
+    {
+      vtkDearImGuiTracer::Scope scope(this->Name.c_str(), "observer");
+      this->Command->Execute(caller, eid, callData);
+    }
+    if (this->Profiler)
+    {
+      this->Profiler->AddObserverTime(this->Name.c_str(), Now() - start);
+    }
+    this->SetAbortFlag(this->Command->GetAbortFlag());
   }
 
-  this->currentIStyle->AddObserver(vtkCommand::EnterEvent, this->EventCallbackCommand, 1.0);
+  std::string Name;
+  vtkSmartPointer<vtkCommand> Command;
+  vtkWeakPointer<vtkDearImGuiDrawProfiler> Profiler;
+};
+}
 
-  this->currentIStyle->AddObserver(vtkCommand::LeaveEvent, this->EventCallbackCommand, 1.0);
+unsigned long vtkDearImGuiInjector::AddDrawObserver(
+  const char* name, vtkCommand* command, float priority)
+{
+  if (!command)
+  {
+    return 0;
+  }
+  vtkNamedDrawCommand* named = vtkNamedDrawCommand::New();
+  named->Name = name ? name : command->GetClassName();
+  named->Command = command;
+  named->Profiler = this->DrawProfiler;
+  unsigned long tag = this->AddObserver(ImGuiDrawEvent, named, priority);
+  named->Delete();
+  return tag;
+}
 
-  this->currentIStyle->AddObserver(vtkCommand::MouseMoveEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiHoverPicker* vtkDearImGuiInjector::GetHoverPicker()
+{
+  return this->HoverPicker;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::LeftButtonPressEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiDrawBatcher* vtkDearImGuiInjector::GetDrawBatcher()
+{
+  return this->DrawBatcher;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::LeftButtonReleaseEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiPropertyEditor* vtkDearImGuiInjector::GetPropertyEditor()
+{
+  return this->PropertyEditor;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::LeftButtonDoubleClickEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiDynamicTexture* vtkDearImGuiInjector::CreateDynamicTexture()
+{
+  vtkNew<vtkDearImGuiDynamicTexture> texture;
+  // a converted image needs a frame to reach the screen
+  texture->SetReadyCallback([this]() { this->WakeUp(); });
+  this->DynamicTextures.emplace_back(texture.GetPointer());
+  return texture;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::MiddleButtonPressEvent, this->EventCallbackCommand, 1.0);
+void vtkDearImGuiInjector::RemoveDynamicTexture(vtkDearImGuiDynamicTexture* texture)
+{
+  auto it = std::find(this->DynamicTextures.begin(), this->DynamicTextures.end(), texture);
+  if (it != this->DynamicTextures.end())
+  {
+    // GL names are freed with the context current, in the next RenderDearImGuiOverlay
+    this->RetiredDynamicTextures.push_back(*it);
+    this->DynamicTextures.erase(it);
+  }
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::MiddleButtonReleaseEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiOutliner* vtkDearImGuiInjector::GetOutliner()
+{
+  return this->Outliner;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::MiddleButtonDoubleClickEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiParameterCommitter* vtkDearImGuiInjector::GetParameterCommitter()
+{
+  return this->ParameterCommitter;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::RightButtonPressEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiSMPPanel* vtkDearImGuiInjector::GetSMPPanel()
+{
+  return this->SMPPanel;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::RightButtonReleaseEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiResourceMonitor* vtkDearImGuiInjector::GetResourceMonitor()
+{
+  return this->ResourceMonitor;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::RightButtonDoubleClickEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiDatasetLoader* vtkDearImGuiInjector::GetDatasetLoader()
+{
+  return this->DatasetLoader;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::MouseWheelForwardEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiSDFFont* vtkDearImGuiInjector::GetSDFFont()
+{
+  return this->SDFFont;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::MouseWheelBackwardEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiInputQueue* vtkDearImGuiInjector::GetInputQueue()
+{
+  return &this->InputQueue;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::MouseWheelLeftEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiDrawProfiler* vtkDearImGuiInjector::GetDrawProfiler()
+{
+  return this->DrawProfiler;
+}
 
-  this->currentIStyle->AddObserver(
-    vtkCommand::MouseWheelRightEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiOcclusionCuller* vtkDearImGuiInjector::GetOcclusionCuller()
+{
+  return this->OcclusionCuller;
+}
 
-  this->currentIStyle->AddObserver(vtkCommand::ExposeEvent, this->EventCallbackCommand, 1.0);
+bool vtkDearImGuiInjector::AddAction(const char* path, std::function<void()> callback,
+  const char* shortcut, std::function<bool()> checked)
+{
+  return this->Actions->AddAction(path, std::move(callback), shortcut, std::move(checked));
+}
 
-  this->currentIStyle->AddObserver(vtkCommand::ConfigureEvent, this->EventCallbackCommand, 1.0);
+bool vtkDearImGuiInjector::RemoveAction(const char* path)
+{
+  return this->Actions->RemoveAction(path);
+}
 
-  this->currentIStyle->AddObserver(vtkCommand::TimerEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiActionRegistry* vtkDearImGuiInjector::GetActionRegistry()
+{
+  return this->Actions;
+}
 
-  this->currentIStyle->AddObserver(vtkCommand::KeyPressEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiTransferFunctionEditor* vtkDearImGuiInjector::CreateTransferFunctionEditor()
+{
+  vtkNew<vtkDearImGuiTransferFunctionEditor> editor;
+  this->TransferFunctionEditors.emplace_back(editor.GetPointer());
+  return editor;
+}
 
-  this->currentIStyle->AddObserver(vtkCommand::KeyReleaseEvent, this->EventCallbackCommand, 1.0);
+void vtkDearImGuiInjector::RemoveTransferFunctionEditor(
+  vtkDearImGuiTransferFunctionEditor* editor)
+{
+  auto it = std::find(
+    this->TransferFunctionEditors.begin(), this->TransferFunctionEditors.end(), editor);
+  if (it != this->TransferFunctionEditors.end())
+  {
+    this->RetiredTransferFunctionEditors.push_back(*it);
+    this->TransferFunctionEditors.erase(it);
+  }
+}
 
-  this->currentIStyle->AddObserver(vtkCommand::CharEvent, this->EventCallbackCommand, 1.0);
+vtkDearImGuiFrameCapture* vtkDearImGuiInjector::GetFrameCapture()
+{
+  return this->FrameCapture;
 }
 
-void vtkDearImGuiInjector::UninstallEventCallback()
+void vtkDearImGuiInjector::SaveScreenshot(const char* fileName)
 {
-  this->currentIStyle->RemoveObserver(this->EventCallbackCommand);
+  this->FrameCapture->Screenshot(fileName);
+  // rendering right away could re-enter an ImGuiDrawEvent observer
+  this->WakeUp();
 }
 
-void vtkDearImGuiInjector::UpdateMousePosAndButtons(vtkRenderWindowInteractor* interactor)
+bool vtkDearImGuiInjector::StartRemoteUI(const char* address)
 {
-  // Update buttons
-  ImGuiIO& io = ImGui::GetIO();
-  for (int i = 0; i < 3; i++)
+  return this->RemoteServer->Listen(address);
+}
+
+void vtkDearImGuiInjector::StopRemoteUI()
+{
+  this->RemoteServer->Close();
+}
+
+vtkDearImGuiRemoteServer* vtkDearImGuiInjector::GetRemoteServer()
+{
+  return this->RemoteServer;
+}
+
+bool vtkDearImGuiInjector::StartPublishing(
+  const char* name, int maximumWidth, int maximumHeight)
+{
+  if ((maximumWidth <= 0 || maximumHeight <= 0) && this->Interactor)
+  {
+    const int* size = this->Interactor->GetRenderWindow()->GetSize();
+    maximumWidth = size[0];
+    maximumHeight = size[1];
+  }
+  if (!this->Publisher->Open(name, maximumWidth, maximumHeight))
   {
-    io.MouseDown[i] = this->MouseJustPressed[i];
+    return false;
   }
+  vtkDearImGuiSharedMemoryPublisher* publisher = this->Publisher;
+  this->FrameCapture->SetFrameCallback(
+    [publisher](const unsigned char* rgba, int width, int height)
+    { publisher->Publish(rgba, width, height); });
+  this->WakeUp();
+  return true;
+}
 
-  // Update mouse position
-#ifdef __EMSCRIPTEN__
-  this->Focused = true; // Emscripten
-#endif
-  if (this->Focused)
+void vtkDearImGuiInjector::StopPublishing()
+{
+  if (this->Publisher->IsOpen())
   {
-    int mouse_x, mouse_y;
-    interactor->GetLastEventPosition(mouse_x, mouse_y);
-    io.MousePos =
-      ImVec2(static_cast<float>(mouse_x), io.DisplaySize.y - static_cast<float>(mouse_y));
+    this->FrameCapture->SetFrameCallback(nullptr);
+    // waits for a frame being published
+    this->Publisher->Close();
   }
 }
 
+vtkDearImGuiSharedMemoryPublisher* vtkDearImGuiInjector::GetPublisher()
+{
+  return this->Publisher;
+}
+
+bool vtkDearImGuiInjector::StartTrace(const char* fileName)
+{
+  if (!this->Tracer->Start(fileName))
+  {
+    return false;
+  }
+  vtkDearImGuiTracer::SetThreadName("UI");
+  return true;
+}
+
+void vtkDearImGuiInjector::StopTrace()
+{
+  this->Tracer->Stop();
+}
+
+void vtkDearImGuiInjector::InstallEventCallback(vtkRenderWindowInteractor* interactor)
+{
+  auto iObserver = interactor->GetInteractorStyle();
+  if (iObserver == nullptr)
+  {
+    return;
+  }
+  auto styleBase = vtkInteractorStyle::SafeDownCast(iObserver);
+  if (styleBase == nullptr)
+  {
+    return;
+  }
+
+  this->currentIStyle = nullptr;
+  if (styleBase->IsA("vtkInteractorStyleSwitchBase"))
+  {
+    this->currentIStyle = vtkInteractorStyleSwitch::SafeDownCast(styleBase)->GetCurrentStyle();
+  }
+  else
+  {
+    this->currentIStyle = styleBase;
+  }
+
+  // one observer per routed event, see DispatchEv
+  for (const EventRoute& route : EventRoutes)
+  {
+    this->currentIStyle->AddObserver(route.Event, this->EventCallbackCommand, 1.0);
+  }
+}
+
+void vtkDearImGuiInjector::SetMouseCapturePolicy(CapturePolicy policy)
+{
+  this->MouseCapturePolicy = std::move(policy);
+}
+
+void vtkDearImGuiInjector::SetKeyboardCapturePolicy(CapturePolicy policy)
+{
+  this->KeyboardCapturePolicy = std::move(policy);
+}
+
+vtkDearImGuiInjector::CapturePolicy vtkDearImGuiInjector::CaptureInRegion(
+  int xmin, int ymin, int xmax, int ymax)
+{
+  return [=](unsigned long, bool imguiWants, const int position[2])
+  {
+    return imguiWants && position[0] >= xmin && position[0] <= xmax && position[1] >= ymin &&
+      position[1] <= ymax;
+  };
+}
+
+void vtkDearImGuiInjector::UninstallEventCallback()
+{
+  this->currentIStyle->RemoveObserver(this->EventCallbackCommand);
+}
+
 void vtkDearImGuiInjector::UpdateMouseCursor(vtkRenderWindow* renWin)
 {
   ImGuiIO& io = ImGui::GetIO();
@@ -465,20 +1275,6 @@ void vtkDearImGuiInjector::UpdateMouseCursor(vtkRenderWindow* renWin)
 
 namespace
 {
-
-void mainLoopCallback(void* arg)
-{
-  vtkDearImGuiInjector* self = static_cast<vtkDearImGuiInjector*>(arg);
-  vtkRenderWindowInteractor* interactor = self->Interactor;
-  vtkRenderWindow* renWin = interactor->GetRenderWindow();
-
-  // self->InstallEventCallback(interactor);
-  interactor->ProcessEvents();
-  // self->UninstallEventCallback();
-  // if (!interactor->GetDone())
-  //   renWin->Render();
-}
-
 #ifdef __EMSCRIPTEN__
 EM_BOOL resizeCallback(int eventType, const EmscriptenUiEvent* e, void* userData)
 {
@@ -490,315 +1286,263 @@ EM_BOOL resizeCallback(int eventType, const EmscriptenUiEvent* e, void* userData
 
 }
 
-void vtkDearImGuiInjector::PumpEv(vtkObject* caller, unsigned long eid, void* callData)
+bool vtkDearImGuiInjector::PostCommand(std::function<void()> command)
 {
-  vtkDebugMacro(<< "PumpEv");
-  auto interactor = vtkRenderWindowInteractor::SafeDownCast(caller);
-  interactor->Enable();
-  interactor->Initialize();
-
-  InstallEventCallback(interactor);
-#ifdef __EMSCRIPTEN__
-  emscripten_set_resize_callback(
-    EMSCRIPTEN_EVENT_TARGET_WINDOW, reinterpret_cast<void*>(interactor), 1, resizeCallback);
-  emscripten_set_main_loop_arg(&mainLoopCallback, (void*)this, 0, 1);
-#else
-  while (!interactor->GetDone())
+  if (!this->PostedCommands.Push(std::move(command)))
   {
-    // mainLoopCallback(reinterpret_cast<void*>(this));
-    interactor->ProcessEvents();
+    return false;
   }
-#endif
+  this->WakeUp();
+  return true;
 }
 
-void vtkDearImGuiInjector::DispatchEv(
-  vtkObject* caller, unsigned long eid, void* clientData, void* callData)
+void vtkDearImGuiInjector::WakeUp()
 {
-  // auto interactor = vtkRenderWindowInteractor::SafeDownCast(caller);
-  auto iStyle = vtkInteractorStyle::SafeDownCast(caller);
-  auto self = reinterpret_cast<vtkDearImGuiInjector*>(clientData);
-
-  // manage update timer
-  auto interactor = iStyle->GetInteractor();
-  auto renWin = interactor->GetRenderWindow();
-  auto createImGuiUpdateTimer = [&](){
-      self->UpdateMousePosAndButtons(interactor);
-      self->UpdateMouseCursor(renWin);
-      if(self->ImGuiForceUpdateTimer == -1) {
-        self->ImGuiForceUpdateTimer = iStyle->GetInteractor()->CreateRepeatingTimer(10); // 10ms is fast enough
-        self->ImGuiFrameCntsRemained = 5; // repeating 5 render calls is enough
-      }
-      else {
-        iStyle->GetInteractor()->ResetTimer(self->ImGuiForceUpdateTimer);
-        self->ImGuiFrameCntsRemained = 5;
-      }
-  };
+  this->WakeUpRequested.store(true);
+  if (this->Sleeping.load())
+  {
+    // lock so that the notification cannot slip in between the loop's predicate check
+    // and its wait.
+    std::lock_guard<std::mutex> lock(this->WakeUpMutex);
+    this->WakeUpCondition.notify_one();
+  }
+}
 
-  ImGuiIO& io = ImGui::GetIO();
-  (void)io;
+void vtkDearImGuiInjector::WaitForWakeUp(double timeout)
+{
+  this->Sleeping.store(true);
+  {
+    std::unique_lock<std::mutex> lock(this->WakeUpMutex);
+    this->WakeUpCondition.wait_for(lock, std::chrono::duration<double>(timeout),
+      [this]() { return this->WakeUpRequested.load(); });
+  }
+  this->Sleeping.store(false);
+}
 
-  switch (eid)
+void vtkDearImGuiInjector::DrainPostedCommands()
+{
+  // Bound the work so that commands which post commands cannot starve the frame.
+  vtkDearImGuiCommandQueue::Command command;
+  std::size_t budget = this->PostedCommands.GetCapacity();
+  while (this->PostedCommands.Pop(command))
   {
-    case vtkCommand::EnterEvent:
+    command();
+    if (--budget == 0)
     {
-      self->Focused = true;
+      // leftovers are run next frame.
+      this->WakeUp();
       break;
     }
-    case vtkCommand::LeaveEvent:
-    {
-      self->Focused = false;
+  }
+}
 
-      break;
-    }
-    case vtkCommand::MouseMoveEvent:
-    {
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnMouseMove();
-      }
-      break;
-    }
-    case vtkCommand::LeftButtonPressEvent:
-    {
-      self->MouseJustPressed[ImGuiMouseButton_Left] = true;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnLeftButtonDown();
-      }
-      break;
-    }
-    case vtkCommand::LeftButtonReleaseEvent:
-    {
-      self->MouseJustPressed[ImGuiMouseButton_Left] = false;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnLeftButtonUp();
-      }
-      break;
-    }
-    case vtkCommand::LeftButtonDoubleClickEvent:
-    {
-      io.MouseDoubleClicked[ImGuiMouseButton_Left] = true;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnLeftButtonDoubleClick();
-      }
-      break;
-    }
-    case vtkCommand::MiddleButtonPressEvent:
-    {
-      self->MouseJustPressed[ImGuiMouseButton_Middle] = true;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnMiddleButtonDown();
-      }
-      break;
-    }
-    case vtkCommand::MiddleButtonReleaseEvent:
-    {
-      self->MouseJustPressed[ImGuiMouseButton_Middle] = false;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnMiddleButtonUp();
-      }
-      break;
-    }
-    case vtkCommand::MiddleButtonDoubleClickEvent:
-    {
-      io.MouseDoubleClicked[ImGuiMouseButton_Middle] = true;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnMiddleButtonDoubleClick();
-      }
-      break;
-    }
-    case vtkCommand::RightButtonPressEvent:
-    {
-      self->MouseJustPressed[ImGuiMouseButton_Right] = true;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnRightButtonDown();
-      }
-      break;
-    }
-    case vtkCommand::RightButtonReleaseEvent:
-    {
-      self->MouseJustPressed[ImGuiMouseButton_Right] = false;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnRightButtonUp();
-      }
-      break;
-    }
-    case vtkCommand::RightButtonDoubleClickEvent:
+void vtkDearImGuiInjector::UpdatePacingState(vtkRenderWindowInteractor* interactor)
+{
+  // While pacing, the interactor only records render requests (see OnRenderRequest)
+  // and the loop decides when to render.
+  if (this->IsPacing() && interactor->GetEnableRender())
+  {
+    interactor->EnableRenderOff();
+    this->PacingDisabledRender = true;
+  }
+  else if (!this->IsPacing() && this->PacingDisabledRender)
+  {
+    interactor->EnableRenderOn();
+    this->PacingDisabledRender = false;
+    if (this->RenderRequested)
     {
-      io.MouseDoubleClicked[ImGuiMouseButton_Right] = true;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnRightButtonDoubleClick();
-      }
-      break;
+      this->RenderRequested = false;
+      interactor->Render();
     }
-    case vtkCommand::MouseWheelBackwardEvent:
+  }
+}
+
+void vtkDearImGuiInjector::RequestRender()
+{
+  if (this->IsPacing())
+  {
+    if (!this->RenderRequested)
     {
-      io.MouseWheel = -1;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnMouseWheelBackward();
-      }
-      break;
+      this->RenderRequested = true;
+      this->RenderRequestTime = Now();
     }
-    case vtkCommand::MouseWheelForwardEvent:
-    {
-      io.MouseWheel = 1;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnMouseWheelForward();
-      }
-      break;
-    }
-    case vtkCommand::MouseWheelLeftEvent:
+  }
+  else if (this->Interactor && this->Interactor->GetRenderWindow())
+  {
+    this->Interactor->GetRenderWindow()->Render();
+  }
+}
+
+void vtkDearImGuiInjector::OnRenderRequest(vtkObject* caller, unsigned long eid, void* callData)
+{
+  if (this->PacingDisabledRender)
+  {
+    this->RequestRender();
+  }
+}
+
+double vtkDearImGuiInjector::GetFrameInterval() const
+{
+  const bool interacting = (Now() - this->LastInteractionTime < this->InteractionTimeout) ||
+    (this->ImGuiForceUpdateTimer != -1);
+  const double rate = interacting ? this->TargetFrameRate : this->IdleFrameRate;
+  return rate > 0 ? 1. / rate : 0.;
+}
+
+double vtkDearImGuiInjector::GetTimeToNextFrame() const
+{
+  const double interval = this->GetFrameInterval();
+  return interval > 0 ? this->LastFrameDeadline + interval - Now() : 0.;
+}
+
+void vtkDearImGuiInjector::RenderPacedFrame()
+{
+  const double now = Now();
+  const double interval = this->GetFrameInterval();
+  const double deadline = this->LastFrameDeadline + interval;
+  if (interval <= 0 || this->RenderRequestTime > deadline)
+  {
+    // uncapped, or nothing was due at the deadline: start a new schedule.
+    this->LastFrameDeadline = now;
+  }
+  else
+  {
+    double lateness = now - deadline;
+    this->FrameJitter = std::abs(lateness);
+    if (lateness > this->SpinTime)
     {
-      io.MouseWheelH = 1;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
-      {
-        iStyle->OnMouseWheelLeft();
-      }
-      break;
+      ++this->MissedFrames;
+      this->InvokeEvent(FrameDeadlineMissedEvent, &lateness);
     }
-    case vtkCommand::MouseWheelRightEvent:
+    // keep the phase of the schedule, unless whole frames were skipped.
+    this->LastFrameDeadline = lateness < interval ? deadline : now;
+  }
+  this->RenderRequested = false;
+  this->Interactor->GetRenderWindow()->Render();
+}
+
+void vtkDearImGuiInjector::MainLoopCallback(void* arg)
+{
+  vtkDearImGuiInjector* self = static_cast<vtkDearImGuiInjector*>(arg);
+  vtkRenderWindowInteractor* interactor = self->Interactor;
+  vtkDearImGuiTracer::Scope scope("PumpEv", "injector");
+
+  self->UpdatePacingState(interactor);
+  interactor->ProcessEvents();
+  if (self->WakeUpRequested.exchange(false))
+  {
+    // posted commands are drained in BeginDearImGuiOverlay
+    self->RequestRender();
+  }
+  if (self->RenderRequested && self->GetTimeToNextFrame() <= 0)
+  {
+    self->RenderPacedFrame();
+  }
+  if (self->RemoteServer->Poll(interactor))
+  {
+    // show the client what its input did
+    self->RequestRender();
+  }
+  if (self->Publisher->IsOpen() && self->Publisher->PollInput(interactor))
+  {
+    self->RequestRender();
+  }
+  if (self->FrameCapture->HasPendingReadbacks())
+  {
+    // the last frames of a recording or a screenshot may not be followed by a render
+    vtkRenderWindow* renWin = interactor->GetRenderWindow();
+    renWin->MakeCurrent();
+    self->FrameCapture->Collect();
+  }
+  self->Tracer->Poll();
+}
+
+void vtkDearImGuiInjector::PumpEv(vtkObject* caller, unsigned long eid, void* callData)
+{
+  vtkDebugMacro(<< "PumpEv");
+  auto interactor = vtkRenderWindowInteractor::SafeDownCast(caller);
+  interactor->Enable();
+  interactor->Initialize();
+
+  InstallEventCallback(interactor);
+#ifdef __EMSCRIPTEN__
+  emscripten_set_resize_callback(
+    EMSCRIPTEN_EVENT_TARGET_WINDOW, reinterpret_cast<void*>(interactor), 1, resizeCallback);
+  // the browser paces the loop, 0 follows requestAnimationFrame.
+  const int fps = static_cast<int>(this->TargetFrameRate);
+  emscripten_set_main_loop_arg(&vtkDearImGuiInjector::MainLoopCallback, (void*)this, fps, 1);
+#else
+  const double pollInterval = 0.001;
+  while (!interactor->GetDone())
+  {
+    MainLoopCallback(reinterpret_cast<void*>(this));
+    double timeout = pollInterval;
+    if (this->RenderRequested)
     {
-      io.MouseWheelH = -1;
-      createImGuiUpdateTimer();
-      if (!io.WantCaptureMouse || (io.WantCaptureMouse && self->GrabMouse))
+      const double remaining = this->GetTimeToNextFrame();
+      if (remaining <= this->SpinTime)
       {
-        iStyle->OnMouseWheelRight();
+        // spin the last stretch for a precise frame start.
+        while (this->GetTimeToNextFrame() > 0)
+        {
+          std::this_thread::yield();
+        }
+        this->RenderPacedFrame();
+        continue;
       }
-      break;
-    }
-    case vtkCommand::ExposeEvent:
-    {
-      iStyle->OnExpose();
-      break;
-    }
-    case vtkCommand::ConfigureEvent:
-    {
-      iStyle->OnConfigure();
-      break;
+      // sleep in short slices so that input keeps being processed and can switch
+      // the loop to the interactive rate.
+      timeout = std::min(timeout, remaining - this->SpinTime);
     }
-    case vtkCommand::TimerEvent:
+    if (!this->WakeUpRequested.load())
     {
-      iStyle->OnTimer();
-      renWin->Render();
-      if(--(self->ImGuiFrameCntsRemained) == 0) {
-        interactor->DestroyTimer(self->ImGuiForceUpdateTimer);
-        self->ImGuiForceUpdateTimer = -1;
-      }
-      break;
+      // ProcessEvents() does not block, so idle here until the next event poll
+      // unless a command gets posted.
+      this->WaitForWakeUp(timeout);
     }
-    case vtkCommand::CharEvent:
-    {
-      std::string keySym = iStyle->GetInteractor()->GetKeySym();
-#ifdef USES_WIN32
-      unsigned int key = 0;
-      if (KeySymToVKeyCode.find(keySym.c_str()) != KeySymToVKeyCode.end())
-      {
-        key = KeySymToVKeyCode.at(keySym.c_str());
-      }
-      else
-      {
-        key = static_cast<unsigned int>(iStyle->GetInteractor()->GetKeyCode());
-      }
-      io.AddInputCharacter(key);
-#else
-      io.AddInputCharactersUTF8(keySym.c_str());
+  }
 #endif
+}
 
-      if (!io.WantCaptureKeyboard || (io.WantCaptureKeyboard && self->GrabKeyboard))
-      {
-        iStyle->OnChar();
-      }
-      break;
-    }
-    case vtkCommand::KeyPressEvent:
-    case vtkCommand::KeyReleaseEvent:
-    {
-      bool down = eid == vtkCommand::KeyPressEvent;
-      std::string keySym = iStyle->GetInteractor()->GetKeySym();
-#ifdef USES_X11
-      unsigned int key = iStyle->GetInteractor()->GetKeyCode();
-      // Do not rely on VTK giving correct info for ctrl, shift, alt keys on X11.
-      // So, check for literal in key sym string
-      const auto& nul = std::string::npos;
-      io.KeyAlt = (keySym.find("Alt") != nul) || (keySym.find("alt") != nul);
-      io.KeyCtrl = (keySym.find("Control") != nul) || (keySym.find("control") != nul);
-      io.KeyShift = (keySym.find("Shift") != nul) || (keySym.find("shift") != nul);
-      io.KeySuper = (keySym == "Win_L") || (keySym == "Win_R") || (keySym == "Super_L") ||
-        (keySym == "Super_R");
-      io.KeySuper &= down;
-#elif defined(USES_SDL2)
-      unsigned int key =
-        SDL_GetScancodeFromKey(static_cast<unsigned int>(iStyle->GetInteractor()->GetKeyCode()));
-      if (!key)
-      {
-        key = static_cast<unsigned int>(iStyle->GetInteractor()->GetKeyCode());
-      }
-      io.KeyAlt = iStyle->GetInteractor()->GetAltKey();
-      io.KeyCtrl = iStyle->GetInteractor()->GetControlKey();
-      io.KeyShift = iStyle->GetInteractor()->GetShiftKey();
-      io.KeySuper = (SDL_GetModState() & KMOD_GUI) ? true : false;
-#elif defined(USES_WIN32)
-      unsigned int key = 0;
-      if (KeySymToVKeyCode.find(keySym.c_str()) != KeySymToVKeyCode.end())
-      {
-        key = KeySymToVKeyCode.at(keySym.c_str());
-      }
-      else
-      {
-        key = static_cast<unsigned int>(iStyle->GetInteractor()->GetKeyCode());
-      }
-      io.KeyAlt = iStyle->GetInteractor()->GetAltKey();
-      io.KeyCtrl = iStyle->GetInteractor()->GetControlKey();
-      io.KeyShift = iStyle->GetInteractor()->GetShiftKey();
-      io.KeySuper = (GetKeyState(VK_LWIN) || GetKeyState(VK_RWIN)) ? true : false;
-#endif
-      if (key >= 0 && key < IM_ARRAYSIZE(io.KeysDown))
-      {
-        io.KeysDown[key] = (down);
-      }
-      io.KeyAlt &= down;
-      io.KeyCtrl &= down;
-      io.KeyShift &= down;
-      io.KeySuper &= down;
+void vtkDearImGuiInjector::DispatchEv(
+  vtkObject* caller, unsigned long eid, void* clientData, void* callData)
+{
+  const EventRoute* route = FindEventRoute(eid);
+  if (!route)
+  {
+    return;
+  }
+  // observers are only installed on interactor styles
+  auto iStyle = static_cast<vtkInteractorStyle*>(caller);
+  auto self = static_cast<vtkDearImGuiInjector*>(clientData);
+  vtkDearImGuiTracer::Scope scope(route->Name, "event");
+  ImGuiIO& io = ImGui::GetIO();
 
-      if (!io.WantCaptureKeyboard || (io.WantCaptureKeyboard && self->GrabKeyboard))
-      {
-        if (down)
-        {
-          iStyle->OnKeyDown();
-          iStyle->OnKeyPress();
-        }
-        else
-        {
-          iStyle->OnKeyUp();
-          iStyle->OnKeyRelease();
-        }
-      }
-      break;
+  if (route->Interaction)
+  {
+    // input switches frame pacing to the interactive rate.
+    self->LastInteractionTime = Now();
+  }
+  bool forward = !route->Update || route->Update(self, iStyle, io);
+  if (route->UpdateTimer)
+  {
+    vtkDearImGuiEventRouting::UpdateTimer(self, iStyle->GetInteractor());
+  }
+  if (forward && route->Capture != NoCapture)
+  {
+    forward =
+      !vtkDearImGuiEventRouting::Captured(self, iStyle->GetInteractor(), eid, route->Capture);
+  }
+  if (forward && route->First)
+  {
+    (iStyle->*route->First)();
+    if (route->Second)
+    {
+      (iStyle->*route->Second)();
     }
-    default:
-      break;
+  }
+  if (route->After)
+  {
+    route->After(self, iStyle);
   }
 }
@@ -0,0 +1,321 @@
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include <vtkDearImGuiInputQueue.h>
+#include <vtkDearImGuiTracer.h>
+
+#include "imgui.h"
+
+namespace
+{
+const char* EventNames[] = { "MousePos", "MouseButton", "MouseWheel", "Key", "Modifiers",
+  "Char" };
+
+enum ModifierBits
+{
+  ControlBit = 1,
+  ShiftBit = 2,
+  AltBit = 4,
+  SuperBit = 8
+};
+
+#if IMGUI_VERSION_NUM >= 18700
+#if IMGUI_VERSION_NUM >= 18900
+const ImGuiKey ModifierKeys[] = { ImGuiMod_Ctrl, ImGuiMod_Shift, ImGuiMod_Alt, ImGuiMod_Super };
+#else
+const ImGuiKey ModifierKeys[] = { ImGuiKey_ModCtrl, ImGuiKey_ModShift, ImGuiKey_ModAlt,
+  ImGuiKey_ModSuper };
+#endif
+
+// named keys, letters, digits and function keys are mapped in ToImGuiKey
+const std::unordered_map<std::string, ImGuiKey> NamedKeys = { { "Tab", ImGuiKey_Tab },
+  { "Left", ImGuiKey_LeftArrow }, { "Right", ImGuiKey_RightArrow }, { "Up", ImGuiKey_UpArrow },
+  { "Down", ImGuiKey_DownArrow }, { "Prior", ImGuiKey_PageUp }, { "Page_Up", ImGuiKey_PageUp },
+  { "Next", ImGuiKey_PageDown }, { "Page_Down", ImGuiKey_PageDown }, { "Home", ImGuiKey_Home },
+  { "End", ImGuiKey_End }, { "Insert", ImGuiKey_Insert }, { "Delete", ImGuiKey_Delete },
+  { "BackSpace", ImGuiKey_Backspace }, { "space", ImGuiKey_Space }, { "Return", ImGuiKey_Enter },
+  { "Escape", ImGuiKey_Escape }, { "apostrophe", ImGuiKey_Apostrophe },
+  { "comma", ImGuiKey_Comma }, { "minus", ImGuiKey_Minus }, { "period", ImGuiKey_Period },
+  { "slash", ImGuiKey_Slash }, { "semicolon", ImGuiKey_Semicolon }, { "equal", ImGuiKey_Equal },
+  { "bracketleft", ImGuiKey_LeftBracket }, { "backslash", ImGuiKey_Backslash },
+  { "bracketright", ImGuiKey_RightBracket }, { "grave", ImGuiKey_GraveAccent },
+  { "Caps_Lock", ImGuiKey_CapsLock }, { "Scroll_Lock", ImGuiKey_ScrollLock },
+  { "Num_Lock", ImGuiKey_NumLock }, { "Print", ImGuiKey_PrintScreen },
+  { "Snapshot", ImGuiKey_PrintScreen }, { "Pause", ImGuiKey_Pause },
+  { "KP_Decimal", ImGuiKey_KeypadDecimal }, { "KP_Divide", ImGuiKey_KeypadDivide },
+  { "KP_Multiply", ImGuiKey_KeypadMultiply }, { "KP_Subtract", ImGuiKey_KeypadSubtract },
+  { "KP_Add", ImGuiKey_KeypadAdd }, { "KP_Enter", ImGuiKey_KeypadEnter },
+  { "KP_Equal", ImGuiKey_KeypadEqual }, { "Shift_L", ImGuiKey_LeftShift },
+  { "Shift_R", ImGuiKey_RightShift }, { "Control_L", ImGuiKey_LeftCtrl },
+  { "Control_R", ImGuiKey_RightCtrl }, { "Alt_L", ImGuiKey_LeftAlt },
+  { "Alt_R", ImGuiKey_RightAlt }, { "Super_L", ImGuiKey_LeftSuper },
+  { "Super_R", ImGuiKey_RightSuper }, { "Win_L", ImGuiKey_LeftSuper },
+  { "Win_R", ImGuiKey_RightSuper }, { "Menu", ImGuiKey_Menu }, { "App", ImGuiKey_Menu } };
+#endif
+}
+
+void vtkDearImGuiInputQueue::Push(int type, int code, bool down, float x, float y)
+{
+  if (!this->Events.empty())
+  {
+    // a frame only needs the last position and the sum of the wheel steps
+    Event& last = this->Events.back();
+    if (type == MousePos && last.Type == MousePos)
+    {
+      last.X = x;
+      last.Y = y;
+      return;
+    }
+    if (type == MouseWheel && last.Type == MouseWheel)
+    {
+      last.X += x;
+      last.Y += y;
+      return;
+    }
+  }
+  this->Events.push_back({ type, vtkDearImGuiTracer::Now(), code, down, x, y });
+}
+
+void vtkDearImGuiInputQueue::AddMousePos(float x, float y)
+{
+  this->Push(MousePos, 0, false, x, y);
+}
+
+void vtkDearImGuiInputQueue::AddMouseLeave()
+{
+  this->Push(MousePos, 0, false, -FLT_MAX, -FLT_MAX);
+}
+
+void vtkDearImGuiInputQueue::AddMouseButton(int button, bool down)
+{
+  this->Push(MouseButton, button, down, 0.f, 0.f);
+}
+
+void vtkDearImGuiInputQueue::AddMouseWheel(float horizontal, float vertical)
+{
+  this->Push(MouseWheel, 0, false, horizontal, vertical);
+}
+
+void vtkDearImGuiInputQueue::AddKey(int key, bool down)
+{
+  this->Push(Key, key, down, 0.f, 0.f);
+}
+
+void vtkDearImGuiInputQueue::AddModifiers(bool control, bool shift, bool alt, bool super)
+{
+  const int bits = (control ? ControlBit : 0) | (shift ? ShiftBit : 0) | (alt ? AltBit : 0) |
+    (super ? SuperBit : 0);
+  this->Push(Modifiers, bits, false, 0.f, 0.f);
+}
+
+void vtkDearImGuiInputQueue::AddCharacters(const char* utf8)
+{
+  if (!utf8 || !utf8[0])
+  {
+    return;
+  }
+  const int offset = static_cast<int>(this->Text.size());
+  this->Text.append(utf8);
+  this->Text.push_back('\0');
+  this->Push(Char, offset, false, 0.f, 0.f);
+}
+
+void vtkDearImGuiInputQueue::AddCharacter(unsigned int codepoint)
+{
+  char utf8[5] = { 0, 0, 0, 0, 0 };
+  if (codepoint == 0 || codepoint > 0x10FFFF)
+  {
+    return;
+  }
+  if (codepoint < 0x80)
+  {
+    utf8[0] = static_cast<char>(codepoint);
+  }
+  else if (codepoint < 0x800)
+  {
+    utf8[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+    utf8[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+  }
+  else if (codepoint < 0x10000)
+  {
+    utf8[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+    utf8[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+    utf8[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+  }
+  else
+  {
+    utf8[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+    utf8[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+    utf8[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+    utf8[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+  }
+  this->AddCharacters(utf8);
+}
+
+bool vtkDearImGuiInputQueue::Apply()
+{
+  if (this->Events.empty())
+  {
+    return false;
+  }
+  ImGuiIO& io = ImGui::GetIO();
+  const bool tracing = vtkDearImGuiTracer::GetActive() != nullptr;
+  const double now = tracing ? vtkDearImGuiTracer::Now() : 0.;
+  // same rules as the trickling of ImGui's own queue
+  int buttonsChanged = 0;
+  bool moved = false;
+  bool wheeled = false;
+  bool keyChanged = false;
+  bool typed = false;
+  // keys and text only alternate within a frame while no text field has focus
+  const bool interleaved = !io.WantTextInput;
+  int keys[8];
+  int numberOfKeys = 0;
+  std::size_t applied = 0;
+  for (; applied < this->Events.size(); ++applied)
+  {
+    const Event& event = this->Events[applied];
+    if (event.Type == MousePos)
+    {
+      if (buttonsChanged || wheeled || keyChanged)
+      {
+        break;
+      }
+#if IMGUI_VERSION_NUM >= 18700
+      io.AddMousePosEvent(event.X, event.Y);
+#else
+      io.MousePos = ImVec2(event.X, event.Y);
+#endif
+      moved = true;
+    }
+    else if (event.Type == MouseButton)
+    {
+      if ((buttonsChanged & (1 << event.Code)) || wheeled)
+      {
+        break;
+      }
+#if IMGUI_VERSION_NUM >= 18700
+      io.AddMouseButtonEvent(event.Code, event.Down);
+#else
+      io.MouseDown[event.Code] = event.Down;
+#endif
+      buttonsChanged |= 1 << event.Code;
+    }
+    else if (event.Type == MouseWheel)
+    {
+      if (moved || buttonsChanged)
+      {
+        break;
+      }
+#if IMGUI_VERSION_NUM >= 18700
+      io.AddMouseWheelEvent(event.X, event.Y);
+#else
+      io.MouseWheelH += event.X;
+      io.MouseWheel += event.Y;
+#endif
+      wheeled = true;
+    }
+    else if (event.Type == Key)
+    {
+      bool changed = false;
+      for (int i = 0; i < numberOfKeys; ++i)
+      {
+        changed |= keys[i] == event.Code;
+      }
+      if (changed || buttonsChanged || (typed && !interleaved) ||
+        numberOfKeys == IM_ARRAYSIZE(keys))
+      {
+        break;
+      }
+      keys[numberOfKeys++] = event.Code;
+#if IMGUI_VERSION_NUM >= 18700
+      io.AddKeyEvent(static_cast<ImGuiKey>(event.Code), event.Down);
+#else
+      if (event.Code >= 0 && event.Code < IM_ARRAYSIZE(io.KeysDown))
+      {
+        io.KeysDown[event.Code] = event.Down;
+      }
+#endif
+      keyChanged = true;
+    }
+    else if (event.Type == Char)
+    {
+      if ((keyChanged && !interleaved) || buttonsChanged || moved || wheeled)
+      {
+        break;
+      }
+      io.AddInputCharactersUTF8(&this->Text[event.Code]);
+      typed = true;
+    }
+    else
+    {
+#if IMGUI_VERSION_NUM >= 18700
+      for (int bit = 0; bit < 4; ++bit)
+      {
+        io.AddKeyEvent(ModifierKeys[bit], (event.Code & (1 << bit)) != 0);
+      }
+#else
+      io.KeyCtrl = (event.Code & ControlBit) != 0;
+      io.KeyShift = (event.Code & ShiftBit) != 0;
+      io.KeyAlt = (event.Code & AltBit) != 0;
+      io.KeySuper = (event.Code & SuperBit) != 0;
+#endif
+    }
+    if (tracing)
+    {
+      vtkDearImGuiTracer::AddSpan(EventNames[event.Type], "input", event.Time, now);
+    }
+  }
+  this->Events.erase(this->Events.begin(), this->Events.begin() + applied);
+  if (this->Events.empty())
+  {
+    this->Text.clear();
+  }
+  return !this->Events.empty();
+}
+
+int vtkDearImGuiInputQueue::ToImGuiKey(const char* keySym)
+{
+#if IMGUI_VERSION_NUM >= 18700
+  if (!keySym || !keySym[0])
+  {
+    return ImGuiKey_None;
+  }
+  if (!keySym[1])
+  {
+    const char c = keySym[0];
+    if (c >= 'a' && c <= 'z')
+    {
+      return ImGuiKey_A + (c - 'a');
+    }
+    if (c >= 'A' && c <= 'Z')
+    {
+      return ImGuiKey_A + (c - 'A');
+    }
+    if (c >= '0' && c <= '9')
+    {
+      return ImGuiKey_0 + (c - '0');
+    }
+  }
+  if (keySym[0] == 'F' && keySym[1] >= '1' && keySym[1] <= '9')
+  {
+    const int number = std::atoi(keySym + 1);
+    if (number >= 1 && number <= 12)
+    {
+      return ImGuiKey_F1 + (number - 1);
+    }
+  }
+  if (std::strncmp(keySym, "KP_", 3) == 0 && keySym[3] >= '0' && keySym[3] <= '9' && !keySym[4])
+  {
+    return ImGuiKey_Keypad0 + (keySym[3] - '0');
+  }
+  auto it = NamedKeys.find(keySym);
+  return it != NamedKeys.end() ? it->second : ImGuiKey_None;
+#else
+  (void)keySym;
+  return 0;
+#endif
+}
@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+#include <vtkDearImGuiOcclusionCuller.h>
+
+#include <vtkCommand.h>
+#include <vtkObjectFactory.h>
+#include <vtkOpenGLFramebufferObject.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkOpenGLState.h>
+#include <vtkRenderer.h>
+#include <vtkRendererCollection.h>
+#include <vtk_glew.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiOcclusionCuller);
+
+namespace
+{
+using Rect = vtkDearImGuiOcclusionCuller::Rect;
+
+// the stencil bit marking covered pixels, VTK does not use the high bits
+const GLuint CulledBit = 0x80;
+
+bool Same(const Rect& a, const Rect& b)
+{
+  return a.X0 == b.X0 && a.Y0 == b.Y0 && a.X1 == b.X1 && a.Y1 == b.Y1;
+}
+
+bool Contains(const Rect& outer, const Rect& inner)
+{
+  return outer.X0 <= inner.X0 && outer.Y0 <= inner.Y0 && outer.X1 >= inner.X1 &&
+    outer.Y1 >= inner.Y1;
+}
+
+// Area of the union, rectangles overlap where windows do.
+double UnionArea(const std::vector<Rect>& rects)
+{
+  std::vector<int> xs;
+  for (const Rect& rect : rects)
+  {
+    xs.push_back(rect.X0);
+    xs.push_back(rect.X1);
+  }
+  std::sort(xs.begin(), xs.end());
+  double area = 0.;
+  std::vector<std::pair<int, int>> spans;
+  for (std::size_t i = 1; i < xs.size(); ++i)
+  {
+    if (xs[i] == xs[i - 1])
+    {
+      continue;
+    }
+    spans.clear();
+    for (const Rect& rect : rects)
+    {
+      if (rect.X0 <= xs[i - 1] && rect.X1 >= xs[i])
+      {
+        spans.emplace_back(rect.Y0, rect.Y1);
+      }
+    }
+    std::sort(spans.begin(), spans.end());
+    int covered = 0, top = INT_MIN;
+    for (const auto& span : spans)
+    {
+      const int begin = std::max(span.first, top);
+      covered += std::max(span.second - begin, 0);
+      top = std::max(top, span.second);
+    }
+    area += static_cast<double>(covered) * (xs[i] - xs[i - 1]);
+  }
+  return area;
+}
+
+bool IsOpaqueBackground(ImU32 color)
+{
+  if ((color & IM_COL32_A_MASK) != IM_COL32_A_MASK)
+  {
+    return false;
+  }
+  const ImGuiCol backgrounds[] = { ImGuiCol_WindowBg, ImGuiCol_ChildBg, ImGuiCol_PopupBg };
+  for (ImGuiCol background : backgrounds)
+  {
+    if (color == ImGui::GetColorU32(background))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Opaque window background the draw list starts with, in display coordinates as
+// x0, y0, x1, y1. The rounded corners are left out, that takes two rectangles.
+void FindBackground(const ImDrawList* list, float rounding, std::vector<ImVec4>& rects)
+{
+  if (list->VtxBuffer.Size < 4 || list->CmdBuffer.Size == 0)
+  {
+    return;
+  }
+  const ImDrawCmd& cmd = list->CmdBuffer[0];
+  const ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+  const ImDrawVert* vertices = list->VtxBuffer.Data;
+  const ImU32 color = vertices[0].col;
+  if (cmd.UserCallback || cmd.TextureId != atlas->TexID || !IsOpaqueBackground(color))
+  {
+    return;
+  }
+  // the background is one filled shape, its anti-aliased fringe is transparent
+  const ImVec2 white = atlas->TexUvWhitePixel;
+  float x0 = FLT_MAX, y0 = FLT_MAX, x1 = -FLT_MAX, y1 = -FLT_MAX;
+  int end = 0;
+  for (; end < list->VtxBuffer.Size; ++end)
+  {
+    const ImDrawVert& vertex = vertices[end];
+    if ((vertex.col & ~IM_COL32_A_MASK) != (color & ~IM_COL32_A_MASK) ||
+      vertex.uv.x != white.x || vertex.uv.y != white.y)
+    {
+      break;
+    }
+    if (vertex.col == color)
+    {
+      x0 = std::min(x0, vertex.pos.x);
+      y0 = std::min(y0, vertex.pos.y);
+      x1 = std::max(x1, vertex.pos.x);
+      y1 = std::max(y1, vertex.pos.y);
+    }
+  }
+  const float corner = rounding + 1.f;
+  if (x1 - x0 <= 2.f * corner || y1 - y0 <= 2.f * corner)
+  {
+    return;
+  }
+  // a rectangle has every vertex on an edge or in a rounded corner, e.g. a circle not
+  for (int i = 0; i < end; ++i)
+  {
+    const ImVec2& p = vertices[i].pos;
+    if (vertices[i].col != color)
+    {
+      continue;
+    }
+    const float dx = std::min(p.x - x0, x1 - p.x);
+    const float dy = std::min(p.y - y0, y1 - p.y);
+    if (dx >= 1.f && dy >= 1.f && (dx >= corner || dy >= corner))
+    {
+      return;
+    }
+  }
+  x0 = std::max(x0, cmd.ClipRect.x);
+  y0 = std::max(y0, cmd.ClipRect.y);
+  x1 = std::min(x1, cmd.ClipRect.z);
+  y1 = std::min(y1, cmd.ClipRect.w);
+  if (rounding > 0.f)
+  {
+    rects.emplace_back(x0 + corner, y0, x1 - corner, y1);
+    rects.emplace_back(x0, y0 + corner, x1, y1 - corner);
+  }
+  else
+  {
+    rects.emplace_back(x0, y0, x1, y1);
+  }
+}
+}
+
+vtkDearImGuiOcclusionCuller::vtkDearImGuiOcclusionCuller() = default;
+
+vtkDearImGuiOcclusionCuller::~vtkDearImGuiOcclusionCuller()
+{
+  for (auto& observed : this->Observed)
+  {
+    if (observed.first)
+    {
+      observed.first->RemoveObserver(observed.second);
+    }
+  }
+}
+
+bool vtkDearImGuiOcclusionCuller::Update(const ImDrawData* drawData)
+{
+  if (!drawData || drawData->DisplaySize.x <= 0.f || drawData->DisplaySize.y <= 0.f)
+  {
+    this->Reset();
+    return false;
+  }
+  const ImGuiStyle& style = ImGui::GetStyle();
+  const float rounding =
+    std::max(std::max(style.WindowRounding, style.ChildRounding), style.PopupRounding);
+  std::vector<ImVec4> found;
+  for (int n = 0; n < drawData->CmdListsCount; ++n)
+  {
+    FindBackground(drawData->CmdLists[n], rounding, found);
+  }
+
+  // display to framebuffer pixels, rounded inwards
+  const float sx = drawData->FramebufferScale.x;
+  const float sy = drawData->FramebufferScale.y;
+  const int size[2] = { static_cast<int>(drawData->DisplaySize.x * sx),
+    static_cast<int>(drawData->DisplaySize.y * sy) };
+  std::vector<Rect> current;
+  for (const ImVec4& r : found)
+  {
+    Rect rect;
+    rect.X0 = std::max(static_cast<int>(std::ceil((r.x - drawData->DisplayPos.x) * sx)), 0);
+    rect.X1 =
+      std::min(static_cast<int>(std::floor((r.z - drawData->DisplayPos.x) * sx)), size[0]);
+    rect.Y0 = std::max(
+      size[1] - static_cast<int>(std::floor((r.w - drawData->DisplayPos.y) * sy)), 0);
+    rect.Y1 = std::min(
+      size[1] - static_cast<int>(std::ceil((r.y - drawData->DisplayPos.y) * sy)), size[1]);
+    if (rect.X0 < rect.X1 && rect.Y0 < rect.Y1)
+    {
+      current.push_back(rect);
+    }
+  }
+
+  bool exposed = false;
+  for (const Rect& culled : this->Culled)
+  {
+    exposed |= std::none_of(current.begin(), current.end(),
+      [&culled](const Rect& rect) { return Contains(rect, culled); });
+  }
+  this->CulledFraction = this->Culled.empty()
+    ? 0.
+    : UnionArea(this->Culled) / (static_cast<double>(size[0]) * size[1]);
+  this->Culled.clear();
+
+  if (size[0] != this->FramebufferSize[0] || size[1] != this->FramebufferSize[1])
+  {
+    this->Previous.clear();
+    this->FramebufferSize[0] = size[0];
+    this->FramebufferSize[1] = size[1];
+  }
+  this->Next.clear();
+  for (const Rect& rect : current)
+  {
+    if (std::any_of(this->Previous.begin(), this->Previous.end(),
+          [&rect](const Rect& previous) { return Same(previous, rect); }))
+    {
+      this->Next.push_back(rect);
+    }
+  }
+  this->Previous = std::move(current);
+  return exposed;
+}
+
+void vtkDearImGuiOcclusionCuller::BeginFrame(vtkRenderWindow* renderWindow)
+{
+  this->Armed = renderWindow && !this->Next.empty();
+  this->Window = renderWindow;
+  if (!renderWindow)
+  {
+    return;
+  }
+  this->Observed.erase(std::remove_if(this->Observed.begin(), this->Observed.end(),
+                         [](const std::pair<vtkWeakPointer<vtkRenderer>, unsigned long>& observed)
+                         { return !observed.first; }),
+    this->Observed.end());
+  // the render framebuffer is bound once a renderer starts
+  vtkRendererCollection* renderers = renderWindow->GetRenderers();
+  vtkCollectionSimpleIterator it;
+  renderers->InitTraversal(it);
+  while (vtkRenderer* renderer = renderers->GetNextRenderer(it))
+  {
+    auto found = std::find_if(this->Observed.begin(), this->Observed.end(),
+      [renderer](const std::pair<vtkWeakPointer<vtkRenderer>, unsigned long>& observed)
+      { return observed.first == renderer; });
+    if (found == this->Observed.end())
+    {
+      const unsigned long tag =
+        renderer->AddObserver(vtkCommand::StartEvent, this, &vtkDearImGuiOcclusionCuller::Cull);
+      this->Observed.emplace_back(renderer, tag);
+    }
+  }
+}
+
+void vtkDearImGuiOcclusionCuller::Cull(vtkObject* caller, unsigned long eid, void* callData)
+{
+  auto renderer = vtkRenderer::SafeDownCast(caller);
+  if (!this->Armed || !renderer || renderer->GetRenderWindow() != this->Window)
+  {
+    return;
+  }
+  // once per frame, the stencil holds for the following renderers
+  this->Armed = false;
+  auto window = vtkOpenGLRenderWindow::SafeDownCast(this->Window);
+  vtkOpenGLFramebufferObject* fbo = window ? window->GetRenderFramebuffer() : nullptr;
+  if (!fbo)
+  {
+    return;
+  }
+  int size[2];
+  fbo->GetLastSize(size);
+  GLint bound = 0;
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &bound);
+  GLint stencil = GL_NONE;
+  glGetFramebufferAttachmentParameteriv(
+    GL_DRAW_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &stencil);
+  if (static_cast<unsigned int>(bound) != fbo->GetFBOIndex() || stencil == GL_NONE ||
+    size[0] != this->FramebufferSize[0] || size[1] != this->FramebufferSize[1])
+  {
+    vtkDebugMacro(<< "Render framebuffer has no stencil or a new size, nothing culled");
+    return;
+  }
+
+  // scissored clears, no geometry needed
+  vtkOpenGLState* state = window->GetState();
+  {
+    vtkOpenGLState::ScopedglEnableDisable scissorTest(state, GL_SCISSOR_TEST);
+    vtkOpenGLState::ScopedglScissor scissor(state);
+    state->vtkglEnable(GL_SCISSOR_TEST);
+    state->vtkglStencilMask(CulledBit);
+    glClearStencil(0);
+    state->vtkglScissor(0, 0, size[0], size[1]);
+    state->vtkglClear(GL_STENCIL_BUFFER_BIT);
+    glClearStencil(CulledBit);
+    for (const Rect& rect : this->Next)
+    {
+      state->vtkglScissor(rect.X0, rect.Y0, rect.X1 - rect.X0, rect.Y1 - rect.Y0);
+      state->vtkglClear(GL_STENCIL_BUFFER_BIT);
+    }
+    glClearStencil(0);
+    state->vtkglStencilMask(0xFF);
+  }
+  state->vtkglStencilFunc(GL_NOTEQUAL, CulledBit, CulledBit);
+  state->vtkglStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+  state->vtkglEnable(GL_STENCIL_TEST);
+  this->Culled = this->Next;
+  this->Applied = true;
+}
+
+void vtkDearImGuiOcclusionCuller::EndFrame()
+{
+  this->Armed = false;
+  if (!this->Applied)
+  {
+    return;
+  }
+  this->Applied = false;
+  if (auto window = vtkOpenGLRenderWindow::SafeDownCast(this->Window))
+  {
+    window->GetState()->vtkglDisable(GL_STENCIL_TEST);
+  }
+}
+
+void vtkDearImGuiOcclusionCuller::Reset()
+{
+  this->EndFrame();
+  this->Previous.clear();
+  this->Next.clear();
+  this->Culled.clear();
+  this->CulledFraction = 0.;
+}
@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <cstdio>
+#include <unordered_set>
+
+#include <vtkDearImGuiOutliner.h>
+#include <vtkDearImGuiTable.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkActor.h>
+#include <vtkActor2D.h>
+#include <vtkCommand.h>
+#include <vtkObjectFactory.h>
+#include <vtkProperty.h>
+#include <vtkProperty2D.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkRendererCollection.h>
+#include <vtkVersionMacros.h>
+#include <vtkVolume.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiOutliner);
+
+namespace
+{
+const char* TypeNames[] = { "Renderer", "Actor", "Volume", "Actor2D", "Prop" };
+
+int RowType(vtkProp* prop)
+{
+  if (vtkActor::SafeDownCast(prop))
+  {
+    return vtkDearImGuiOutliner::ActorRow;
+  }
+  if (vtkVolume::SafeDownCast(prop))
+  {
+    return vtkDearImGuiOutliner::VolumeRow;
+  }
+  if (vtkActor2D::SafeDownCast(prop))
+  {
+    return vtkDearImGuiOutliner::Actor2DRow;
+  }
+  return vtkDearImGuiOutliner::OtherRow;
+}
+
+std::string RowLabel(vtkObject* object, int number)
+{
+#if VTK_MAJOR_VERSION > 9 || (VTK_MAJOR_VERSION == 9 && VTK_MINOR_VERSION >= 2)
+  const std::string name = object->GetObjectName();
+  if (!name.empty())
+  {
+    return name;
+  }
+#endif
+  char label[96];
+  std::snprintf(label, sizeof(label), "%s %d", object->GetClassName(), number);
+  return label;
+}
+}
+
+vtkDearImGuiOutliner::vtkDearImGuiOutliner() = default;
+
+vtkDearImGuiOutliner::~vtkDearImGuiOutliner() = default;
+
+void vtkDearImGuiOutliner::Update(vtkRenderWindow* renderWindow)
+{
+  // Adding or removing an item modifies a collection, the newest of those times
+  // changes with any of them.
+  vtkRendererCollection* renderers = renderWindow->GetRenderers();
+  vtkMTimeType time = renderers->GetMTime();
+  vtkCollectionSimpleIterator it;
+  renderers->InitTraversal(it);
+  while (vtkRenderer* renderer = renderers->GetNextRenderer(it))
+  {
+    time = std::max(time, renderer->GetViewProps()->GetMTime());
+  }
+  if (renderWindow == this->RenderWindow && time == this->SceneTime)
+  {
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope("UpdateOutliner", "editor");
+  this->RenderWindow = renderWindow;
+  this->SceneTime = time;
+  this->Rows.clear();
+  this->Index.Clear();
+  int rendererNumber = 0;
+  renderers->InitTraversal(it);
+  while (vtkRenderer* renderer = renderers->GetNextRenderer(it))
+  {
+    this->Rows.push_back({ renderer, nullptr, RendererRow, RowLabel(renderer, rendererNumber++) });
+    vtkPropCollection* props = renderer->GetViewProps();
+    this->Rows.reserve(this->Rows.size() + props->GetNumberOfItems());
+    int propNumber = 0;
+    vtkCollectionSimpleIterator propIt;
+    props->InitTraversal(propIt);
+    while (vtkProp* prop = props->GetNextProp(propIt))
+    {
+      this->Rows.push_back({ renderer, prop, RowType(prop), RowLabel(prop, propNumber++) });
+    }
+  }
+  for (const Row& row : this->Rows)
+  {
+    // searchable by name and type
+    this->Index.Add(row.Label + " " + TypeNames[row.Type]);
+  }
+
+  // drop what is gone
+  std::unordered_set<const void*> present;
+  if (!this->Selection.empty() || !this->Collapsed.empty())
+  {
+    for (const Row& row : this->Rows)
+    {
+      present.insert(row.Prop ? static_cast<const void*>(row.Prop) : row.Renderer);
+    }
+  }
+  auto removed = [&present](const void* item) { return present.count(item) == 0; };
+  const std::size_t selected = this->Selection.size();
+  this->Selection.erase(
+    std::remove_if(this->Selection.begin(), this->Selection.end(), removed),
+    this->Selection.end());
+  this->Collapsed.erase(
+    std::remove_if(this->Collapsed.begin(), this->Collapsed.end(), removed),
+    this->Collapsed.end());
+  this->Index.Find(this->Filter, this->Matches);
+  this->LastFilter = this->Filter;
+  this->VisibleRowsValid = false;
+  if (this->Selection.size() != selected)
+  {
+    this->InvokeEvent(vtkCommand::SelectionChangedEvent);
+  }
+}
+
+void vtkDearImGuiOutliner::UpdateVisibleRows()
+{
+  if (this->LastFilter != this->Filter)
+  {
+    // a longer query only narrows down the previous matches
+    if (!this->LastFilter.empty() &&
+      std::string(this->Filter).find(this->LastFilter) != std::string::npos)
+    {
+      this->Index.Refine(this->Filter, this->Matches, this->Matches);
+    }
+    else
+    {
+      this->Index.Find(this->Filter, this->Matches);
+    }
+    this->LastFilter = this->Filter;
+    this->VisibleRowsValid = false;
+  }
+  if (this->VisibleRowsValid)
+  {
+    return;
+  }
+  this->VisibleRows.clear();
+  const bool filtering = this->Filter[0] != '\0' || this->TypeFilter >= 0;
+  // a renderer row is listed when the renderer or one of its props matches
+  int rendererRow = -1;
+  bool rendererListed = false;
+  bool collapsed = false;
+  std::size_t next = 0;
+  for (int id = 0; id < static_cast<int>(this->Rows.size()); ++id)
+  {
+    const Row& row = this->Rows[id];
+    while (next < this->Matches.size() && this->Matches[next] < id)
+    {
+      ++next;
+    }
+    const bool matches = next < this->Matches.size() && this->Matches[next] == id &&
+      (this->TypeFilter < 0 || this->TypeFilter == row.Type);
+    if (row.Type == RendererRow)
+    {
+      rendererRow = id;
+      rendererListed = !filtering || matches;
+      collapsed = std::find(this->Collapsed.begin(), this->Collapsed.end(), row.Renderer) !=
+        this->Collapsed.end();
+      if (rendererListed)
+      {
+        this->VisibleRows.push_back(id);
+      }
+      continue;
+    }
+    if (!matches)
+    {
+      continue;
+    }
+    if (!rendererListed && rendererRow >= 0)
+    {
+      this->VisibleRows.push_back(rendererRow);
+      rendererListed = true;
+    }
+    if (!collapsed)
+    {
+      this->VisibleRows.push_back(id);
+    }
+  }
+  this->VisibleRowsValid = true;
+}
+
+void vtkDearImGuiOutliner::Select(vtkProp* prop, bool toggle)
+{
+  auto it = std::find(this->Selection.begin(), this->Selection.end(), prop);
+  if (toggle)
+  {
+    if (it != this->Selection.end())
+    {
+      this->Selection.erase(it);
+    }
+    else
+    {
+      this->Selection.push_back(prop);
+    }
+  }
+  else
+  {
+    this->Selection.assign(1, prop);
+  }
+  this->InvokeEvent(vtkCommand::SelectionChangedEvent);
+}
+
+void vtkDearImGuiOutliner::ClearSelection()
+{
+  if (!this->Selection.empty())
+  {
+    this->Selection.clear();
+    this->InvokeEvent(vtkCommand::SelectionChangedEvent);
+  }
+}
+
+void vtkDearImGuiOutliner::DrawRow(const Row& row)
+{
+  vtkDearImGuiTable::NextRow();
+  ImGui::PushID(row.Prop ? static_cast<void*>(row.Prop) : static_cast<void*>(row.Renderer));
+
+  vtkDearImGuiTable::NextColumn();
+  if (row.Prop)
+  {
+    bool visible = row.Prop->GetVisibility() != 0;
+    if (ImGui::Checkbox("##visible", &visible))
+    {
+      row.Prop->SetVisibility(visible);
+    }
+  }
+  else
+  {
+    bool draw = row.Renderer->GetDraw() != 0;
+    if (ImGui::Checkbox("##draw", &draw))
+    {
+      row.Renderer->SetDraw(draw);
+    }
+  }
+
+  vtkDearImGuiTable::NextColumn();
+  if (row.Prop)
+  {
+    ImGui::Indent();
+    const bool selected =
+      std::find(this->Selection.begin(), this->Selection.end(), row.Prop) != this->Selection.end();
+    if (ImGui::Selectable(row.Label.c_str(), selected, ImGuiSelectableFlags_SpanAllColumns))
+    {
+      this->Select(row.Prop, ImGui::GetIO().KeyCtrl);
+    }
+    ImGui::Unindent();
+  }
+  else
+  {
+    const bool collapsed = std::find(this->Collapsed.begin(), this->Collapsed.end(),
+                             row.Renderer) != this->Collapsed.end();
+    ImGui::SetNextItemOpen(!collapsed);
+    const bool open = ImGui::TreeNodeEx(row.Label.c_str(),
+      ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanAvailWidth);
+    if (open == collapsed)
+    {
+      if (open)
+      {
+        this->Collapsed.erase(
+          std::find(this->Collapsed.begin(), this->Collapsed.end(), row.Renderer));
+      }
+      else
+      {
+        this->Collapsed.push_back(row.Renderer);
+      }
+      this->VisibleRowsValid = false;
+    }
+  }
+
+  vtkDearImGuiTable::NextColumn();
+  ImGui::TextUnformatted(TypeNames[row.Type]);
+
+  vtkDearImGuiTable::NextColumn();
+  ImGui::SetNextItemWidth(-1.f);
+  if (vtkActor* actor = vtkActor::SafeDownCast(row.Prop))
+  {
+    float opacity = static_cast<float>(actor->GetProperty()->GetOpacity());
+    if (ImGui::SliderFloat("##opacity", &opacity, 0.f, 1.f, "%.2f"))
+    {
+      actor->GetProperty()->SetOpacity(opacity);
+    }
+  }
+  else if (vtkActor2D* actor2D = vtkActor2D::SafeDownCast(row.Prop))
+  {
+    float opacity = static_cast<float>(actor2D->GetProperty()->GetOpacity());
+    if (ImGui::SliderFloat("##opacity", &opacity, 0.f, 1.f, "%.2f"))
+    {
+      actor2D->GetProperty()->SetOpacity(opacity);
+    }
+  }
+  ImGui::PopID();
+}
+
+void vtkDearImGuiOutliner::Draw(vtkRenderWindow* renderWindow)
+{
+  if (!renderWindow)
+  {
+    return;
+  }
+  this->Update(renderWindow);
+
+  ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x * 0.6f);
+  ImGui::InputTextWithHint("##filter", "Filter by name or type", this->Filter,
+    sizeof(this->Filter));
+  ImGui::SameLine();
+  ImGui::SetNextItemWidth(-1.f);
+  int type = this->TypeFilter + 1;
+  const char* types[] = { "All", "Renderers", "Actors", "Volumes", "2D Actors", "Other" };
+  if (ImGui::Combo("##type", &type, types, IM_ARRAYSIZE(types)))
+  {
+    this->TypeFilter = type - 1;
+    this->VisibleRowsValid = false;
+  }
+  this->UpdateVisibleRows();
+  ImGui::TextDisabled("%d of %d rows, %d selected", static_cast<int>(this->VisibleRows.size()),
+    static_cast<int>(this->Rows.size()), static_cast<int>(this->Selection.size()));
+
+  if (!vtkDearImGuiTable::Begin(
+        "##outliner", 4, vtkDearImGuiTable::RowBackground | vtkDearImGuiTable::ScrollY))
+  {
+    return;
+  }
+  vtkDearImGuiTable::SetupColumn("", 0.1f);
+  vtkDearImGuiTable::SetupColumn("Name", 1.f);
+  vtkDearImGuiTable::SetupColumn("Type", 0.35f);
+  vtkDearImGuiTable::SetupColumn("Opacity", 0.45f);
+  vtkDearImGuiTable::HeadersRow();
+  // only the rows in view, toggles take effect on the next frame
+  ImGuiListClipper clipper;
+  clipper.Begin(static_cast<int>(this->VisibleRows.size()));
+  while (clipper.Step())
+  {
+    for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+    {
+      this->DrawRow(this->Rows[this->VisibleRows[i]]);
+    }
+  }
+  vtkDearImGuiTable::End();
+}
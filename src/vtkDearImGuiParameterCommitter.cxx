@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include <vtkDearImGuiParameterCommitter.h>
+#include <vtkDearImGuiTable.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkObjectFactory.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiParameterCommitter);
+
+namespace
+{
+const char* PolicyNames[] = { "Immediate", "Debounce", "Trailing edge" };
+
+int ClampPolicy(int policy)
+{
+  const bool valid = policy >= vtkDearImGuiParameterCommitter::Immediate &&
+    policy <= vtkDearImGuiParameterCommitter::TrailingEdge;
+  return valid ? policy : static_cast<int>(vtkDearImGuiParameterCommitter::TrailingEdge);
+}
+
+double Now()
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+}
+
+vtkDearImGuiParameterCommitter::vtkDearImGuiParameterCommitter() = default;
+
+vtkDearImGuiParameterCommitter::~vtkDearImGuiParameterCommitter() = default;
+
+void vtkDearImGuiParameterCommitter::AddParameter(const char* name, int numberOfComponents,
+  const double* value, Callback commit, Callback preview, int policy, double delay)
+{
+  if (!name || !name[0])
+  {
+    return;
+  }
+  Parameter& parameter = this->Parameters[name];
+  parameter = Parameter();
+  parameter.NumberOfComponents = std::max(1, std::min(numberOfComponents, 4));
+  if (value)
+  {
+    std::copy(value, value + parameter.NumberOfComponents, parameter.Value);
+  }
+  parameter.Commit = std::move(commit);
+  parameter.Preview = std::move(preview);
+  parameter.Policy = ClampPolicy(policy);
+  parameter.Delay = std::max(0., delay);
+  this->Modified();
+}
+
+bool vtkDearImGuiParameterCommitter::RemoveParameter(const char* name)
+{
+  if (!this->Parameters.erase(name ? name : ""))
+  {
+    return false;
+  }
+  this->Modified();
+  return true;
+}
+
+bool vtkDearImGuiParameterCommitter::SetPolicy(const char* name, int policy, double delay)
+{
+  auto it = this->Parameters.find(name ? name : "");
+  if (it == this->Parameters.end())
+  {
+    return false;
+  }
+  it->second.Policy = ClampPolicy(policy);
+  it->second.Delay = std::max(0., delay);
+  this->Modified();
+  return true;
+}
+
+bool vtkDearImGuiParameterCommitter::Write(const char* name, const double* value, bool active)
+{
+  auto it = this->Parameters.find(name ? name : "");
+  if (it == this->Parameters.end() || !value)
+  {
+    return false;
+  }
+  Parameter& parameter = it->second;
+  ++parameter.Statistics.Writes;
+  parameter.Active = active;
+  if (std::equal(value, value + parameter.NumberOfComponents, parameter.Value))
+  {
+    return true;
+  }
+  if (parameter.Version != parameter.CommittedVersion)
+  {
+    // the consumer never sees the value this one replaces
+    ++parameter.Statistics.Dropped;
+  }
+  std::copy(value, value + parameter.NumberOfComponents, parameter.Value);
+  ++parameter.Version;
+  parameter.LastWriteTime = Now();
+  return true;
+}
+
+const double* vtkDearImGuiParameterCommitter::GetValue(const char* name) const
+{
+  auto it = this->Parameters.find(name ? name : "");
+  return it != this->Parameters.end() ? it->second.Value : nullptr;
+}
+
+bool vtkDearImGuiParameterCommitter::SliderParameter(
+  const char* name, double minimum, double maximum, const char* format)
+{
+  auto it = this->Parameters.find(name ? name : "");
+  if (it == this->Parameters.end())
+  {
+    return false;
+  }
+  double value[4];
+  std::copy(it->second.Value, it->second.Value + 4, value);
+  const bool changed = ImGui::SliderScalarN(name, ImGuiDataType_Double, value,
+    it->second.NumberOfComponents, &minimum, &maximum, format);
+  const bool active = ImGui::IsItemActive();
+  // releasing the widget is a write too, TrailingEdge commits on it
+  if (changed || active != it->second.Active)
+  {
+    this->Write(name, value, active);
+  }
+  return changed;
+}
+
+bool vtkDearImGuiParameterCommitter::DragParameter(
+  const char* name, float speed, const char* format)
+{
+  auto it = this->Parameters.find(name ? name : "");
+  if (it == this->Parameters.end())
+  {
+    return false;
+  }
+  double value[4];
+  std::copy(it->second.Value, it->second.Value + 4, value);
+  const bool changed = ImGui::DragScalarN(name, ImGuiDataType_Double, value,
+    it->second.NumberOfComponents, speed, nullptr, nullptr, format);
+  const bool active = ImGui::IsItemActive();
+  if (changed || active != it->second.Active)
+  {
+    this->Write(name, value, active);
+  }
+  return changed;
+}
+
+void vtkDearImGuiParameterCommitter::CommitParameter(
+  const std::string& name, Parameter& parameter)
+{
+  parameter.CommittedVersion = parameter.Version;
+  if (!parameter.Commit)
+  {
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope(name.c_str(), "parameter");
+  const double begin = Now();
+  parameter.Commit(parameter.Value);
+  Metrics& statistics = parameter.Statistics;
+  statistics.LastCommitDuration = Now() - begin;
+  statistics.TotalCommitDuration += statistics.LastCommitDuration;
+  ++statistics.Commits;
+}
+
+double vtkDearImGuiParameterCommitter::Update()
+{
+  const double now = Now();
+  double next = -1.;
+  // callbacks may not add or remove parameters
+  for (auto& entry : this->Parameters)
+  {
+    Parameter& parameter = entry.second;
+    if (parameter.Version == parameter.CommittedVersion)
+    {
+      continue;
+    }
+    if (parameter.Preview && parameter.PreviewedVersion != parameter.Version)
+    {
+      parameter.PreviewedVersion = parameter.Version;
+      parameter.Preview(parameter.Value);
+      ++parameter.Statistics.Previews;
+    }
+    bool due = false;
+    switch (parameter.Policy)
+    {
+      case Immediate:
+        due = true;
+        break;
+      case Debounce:
+      {
+        const double remaining = parameter.LastWriteTime + parameter.Delay - now;
+        due = remaining <= 0.;
+        if (!due)
+        {
+          next = next < 0. ? remaining : std::min(next, remaining);
+        }
+        break;
+      }
+      case TrailingEdge:
+        due = !parameter.Active;
+        break;
+    }
+    if (due)
+    {
+      this->CommitParameter(entry.first, parameter);
+    }
+  }
+  return next;
+}
+
+void vtkDearImGuiParameterCommitter::Flush()
+{
+  for (auto& entry : this->Parameters)
+  {
+    if (entry.second.Version != entry.second.CommittedVersion)
+    {
+      this->CommitParameter(entry.first, entry.second);
+    }
+  }
+}
+
+const vtkDearImGuiParameterCommitter::Metrics* vtkDearImGuiParameterCommitter::GetMetrics(
+  const char* name) const
+{
+  auto it = this->Parameters.find(name ? name : "");
+  return it != this->Parameters.end() ? &it->second.Statistics : nullptr;
+}
+
+void vtkDearImGuiParameterCommitter::ResetMetrics()
+{
+  for (auto& entry : this->Parameters)
+  {
+    entry.second.Statistics = Metrics();
+  }
+}
+
+void vtkDearImGuiParameterCommitter::DrawMetrics()
+{
+  if (this->Parameters.empty())
+  {
+    ImGui::TextDisabled("No parameters");
+    return;
+  }
+  if (ImGui::SmallButton("Reset"))
+  {
+    this->ResetMetrics();
+  }
+  if (!vtkDearImGuiTable::Begin("##parameters", 7))
+  {
+    return;
+  }
+  vtkDearImGuiTable::SetupColumn("Name", 1.f);
+  vtkDearImGuiTable::SetupColumn("Policy", 0.6f);
+  vtkDearImGuiTable::SetupColumn("Writes", 0.4f);
+  vtkDearImGuiTable::SetupColumn("Previews", 0.4f);
+  vtkDearImGuiTable::SetupColumn("Commits", 0.4f);
+  vtkDearImGuiTable::SetupColumn("Dropped", 0.4f);
+  vtkDearImGuiTable::SetupColumn("Commit ms", 0.5f);
+  vtkDearImGuiTable::HeadersRow();
+  for (const auto& entry : this->Parameters)
+  {
+    const Parameter& parameter = entry.second;
+    const Metrics& statistics = parameter.Statistics;
+    vtkDearImGuiTable::NextRow();
+    vtkDearImGuiTable::NextColumn();
+    ImGui::TextUnformatted(entry.first.c_str());
+    if (parameter.Version != parameter.CommittedVersion)
+    {
+      ImGui::SameLine();
+      ImGui::TextDisabled("(pending)");
+    }
+    vtkDearImGuiTable::NextColumn();
+    if (parameter.Policy == Debounce)
+    {
+      ImGui::Text("%s %.0f ms", PolicyNames[parameter.Policy], parameter.Delay * 1000.);
+    }
+    else
+    {
+      ImGui::TextUnformatted(PolicyNames[parameter.Policy]);
+    }
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%lu", statistics.Writes);
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%lu", statistics.Previews);
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%lu", statistics.Commits);
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%lu", statistics.Dropped);
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%.2f", statistics.LastCommitDuration * 1000.);
+    if (statistics.Commits > 0 && ImGui::IsItemHovered())
+    {
+      ImGui::SetTooltip("last %.2f ms, mean %.2f ms", statistics.LastCommitDuration * 1000.,
+        statistics.TotalCommitDuration * 1000. / statistics.Commits);
+    }
+  }
+  vtkDearImGuiTable::End();
+}
@@ -0,0 +1,332 @@
+#include <algorithm>
+
+#include <vtkDearImGuiPropertyEditor.h>
+
+#include <vtkConeSource.h>
+#include <vtkContourFilter.h>
+#include <vtkMapper.h>
+#include <vtkObjectFactory.h>
+#include <vtkProp.h>
+#include <vtkProperty.h>
+#include <vtkSphereSource.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiPropertyEditor);
+
+namespace
+{
+using Descriptor = vtkDearImGuiPropertyEditor::PropertyDescriptor;
+
+template <typename T>
+Descriptor Scalar(const char* name, int type, double low, double high, double (*get)(T*),
+  void (*set)(T*, double))
+{
+  Descriptor descriptor;
+  descriptor.Name = name;
+  descriptor.Type = type;
+  descriptor.Range[0] = low;
+  descriptor.Range[1] = high;
+  descriptor.Get = [get](vtkObject* object, double* value) {
+    value[0] = get(static_cast<T*>(object));
+  };
+  descriptor.Set = [set](vtkObject* object, const double* value) {
+    set(static_cast<T*>(object), value[0]);
+  };
+  return descriptor;
+}
+
+template <typename T>
+Descriptor Choice(const char* name, std::vector<std::string> names, double (*get)(T*),
+  void (*set)(T*, double))
+{
+  Descriptor descriptor = Scalar<T>(name, vtkDearImGuiPropertyEditor::Enumeration, 0.,
+    static_cast<double>(names.size()) - 1., get, set);
+  descriptor.EnumerationNames = std::move(names);
+  return descriptor;
+}
+
+template <typename T>
+Descriptor ColorOf(const char* name, void (*get)(T*, double*), void (*set)(T*, const double*))
+{
+  Descriptor descriptor;
+  descriptor.Name = name;
+  descriptor.Type = vtkDearImGuiPropertyEditor::Color;
+  descriptor.Range[1] = 1.;
+  descriptor.Get = [get](vtkObject* object, double* value) { get(static_cast<T*>(object), value); };
+  descriptor.Set = [set](vtkObject* object, const double* value) {
+    set(static_cast<T*>(object), value);
+  };
+  return descriptor;
+}
+
+int NumberOfValues(const Descriptor& descriptor)
+{
+  return descriptor.Type == vtkDearImGuiPropertyEditor::Color ? 3 : 1;
+}
+
+// Draw the widget for a descriptor on value. Returns true when edited.
+bool EditValue(const Descriptor& descriptor, double* value)
+{
+  const char* label = descriptor.Name.c_str();
+  const bool ranged = descriptor.Range[0] < descriptor.Range[1];
+  switch (descriptor.Type)
+  {
+    case vtkDearImGuiPropertyEditor::Boolean:
+    {
+      bool state = value[0] != 0.;
+      if (ImGui::Checkbox(label, &state))
+      {
+        value[0] = state ? 1. : 0.;
+        return true;
+      }
+      return false;
+    }
+    case vtkDearImGuiPropertyEditor::Integer:
+    {
+      int number = static_cast<int>(value[0]);
+      const bool changed = ranged ? ImGui::SliderInt(label, &number,
+                                      static_cast<int>(descriptor.Range[0]),
+                                      static_cast<int>(descriptor.Range[1]))
+                                  : ImGui::DragInt(label, &number);
+      value[0] = number;
+      return changed;
+    }
+    case vtkDearImGuiPropertyEditor::Double:
+    {
+      return ranged ? ImGui::SliderScalar(label, ImGuiDataType_Double, value,
+                        &descriptor.Range[0], &descriptor.Range[1])
+                    : ImGui::DragScalar(label, ImGuiDataType_Double, value, 0.01f);
+    }
+    case vtkDearImGuiPropertyEditor::Color:
+    {
+      float color[3] = { static_cast<float>(value[0]), static_cast<float>(value[1]),
+        static_cast<float>(value[2]) };
+      if (ImGui::ColorEdit3(label, color))
+      {
+        std::copy(color, color + 3, value);
+        return true;
+      }
+      return false;
+    }
+    case vtkDearImGuiPropertyEditor::Enumeration:
+    {
+      const auto& names = descriptor.EnumerationNames;
+      const int current = static_cast<int>(value[0]);
+      const bool valid = current >= 0 && current < static_cast<int>(names.size());
+      bool changed = false;
+      if (ImGui::BeginCombo(label, valid ? names[current].c_str() : "?"))
+      {
+        for (int i = 0; i < static_cast<int>(names.size()); ++i)
+        {
+          if (ImGui::Selectable(names[i].c_str(), i == current) && i != current)
+          {
+            value[0] = i;
+            changed = true;
+          }
+        }
+        ImGui::EndCombo();
+      }
+      return changed;
+    }
+    default:
+      return false;
+  }
+}
+}
+
+vtkDearImGuiPropertyEditor::vtkDearImGuiPropertyEditor()
+{
+  this->RegisterProperty("vtkProp",
+    Scalar<vtkProp>(
+      "Visibility", Boolean, 0., 1., [](vtkProp* p) -> double { return p->GetVisibility(); },
+      [](vtkProp* p, double v) { p->SetVisibility(v != 0.); }));
+  this->RegisterProperty("vtkProp",
+    Scalar<vtkProp>(
+      "Pickable", Boolean, 0., 1., [](vtkProp* p) -> double { return p->GetPickable(); },
+      [](vtkProp* p, double v) { p->SetPickable(v != 0.); }));
+
+  this->RegisterProperty("vtkProperty",
+    Choice<vtkProperty>(
+      "Representation", { "Points", "Wireframe", "Surface" },
+      [](vtkProperty* p) -> double { return p->GetRepresentation(); },
+      [](vtkProperty* p, double v) { p->SetRepresentation(static_cast<int>(v)); }));
+  this->RegisterProperty("vtkProperty",
+    Choice<vtkProperty>(
+      "Interpolation", { "Flat", "Gouraud", "Phong" },
+      [](vtkProperty* p) -> double { return p->GetInterpolation(); },
+      [](vtkProperty* p, double v) { p->SetInterpolation(static_cast<int>(v)); }));
+  this->RegisterProperty("vtkProperty",
+    ColorOf<vtkProperty>(
+      "Color", [](vtkProperty* p, double* c) { p->GetColor(c); },
+      [](vtkProperty* p, const double* c) { p->SetColor(c[0], c[1], c[2]); }));
+  this->RegisterProperty("vtkProperty",
+    Scalar<vtkProperty>(
+      "Opacity", Double, 0., 1., [](vtkProperty* p) { return p->GetOpacity(); },
+      [](vtkProperty* p, double v) { p->SetOpacity(v); }));
+  this->RegisterProperty("vtkProperty",
+    Scalar<vtkProperty>(
+      "Ambient", Double, 0., 1., [](vtkProperty* p) { return p->GetAmbient(); },
+      [](vtkProperty* p, double v) { p->SetAmbient(v); }));
+  this->RegisterProperty("vtkProperty",
+    Scalar<vtkProperty>(
+      "Diffuse", Double, 0., 1., [](vtkProperty* p) { return p->GetDiffuse(); },
+      [](vtkProperty* p, double v) { p->SetDiffuse(v); }));
+  this->RegisterProperty("vtkProperty",
+    Scalar<vtkProperty>(
+      "Specular", Double, 0., 1., [](vtkProperty* p) { return p->GetSpecular(); },
+      [](vtkProperty* p, double v) { p->SetSpecular(v); }));
+  this->RegisterProperty("vtkProperty",
+    Scalar<vtkProperty>(
+      "Specular Power", Double, 0., 128., [](vtkProperty* p) { return p->GetSpecularPower(); },
+      [](vtkProperty* p, double v) { p->SetSpecularPower(v); }));
+  this->RegisterProperty("vtkProperty",
+    Scalar<vtkProperty>(
+      "Edge Visibility", Boolean, 0., 1.,
+      [](vtkProperty* p) -> double { return p->GetEdgeVisibility(); },
+      [](vtkProperty* p, double v) { p->SetEdgeVisibility(v != 0.); }));
+  this->RegisterProperty("vtkProperty",
+    ColorOf<vtkProperty>(
+      "Edge Color", [](vtkProperty* p, double* c) { p->GetEdgeColor(c); },
+      [](vtkProperty* p, const double* c) { p->SetEdgeColor(c[0], c[1], c[2]); }));
+  this->RegisterProperty("vtkProperty",
+    Scalar<vtkProperty>(
+      "Line Width", Double, 1., 10., [](vtkProperty* p) -> double { return p->GetLineWidth(); },
+      [](vtkProperty* p, double v) { p->SetLineWidth(static_cast<float>(v)); }));
+  this->RegisterProperty("vtkProperty",
+    Scalar<vtkProperty>(
+      "Point Size", Double, 1., 20., [](vtkProperty* p) -> double { return p->GetPointSize(); },
+      [](vtkProperty* p, double v) { p->SetPointSize(static_cast<float>(v)); }));
+
+  this->RegisterProperty("vtkMapper",
+    Scalar<vtkMapper>(
+      "Scalar Visibility", Boolean, 0., 1.,
+      [](vtkMapper* m) -> double { return m->GetScalarVisibility(); },
+      [](vtkMapper* m, double v) { m->SetScalarVisibility(v != 0.); }));
+  this->RegisterProperty("vtkMapper",
+    Scalar<vtkMapper>(
+      "Interpolate Scalars Before Mapping", Boolean, 0., 1.,
+      [](vtkMapper* m) -> double { return m->GetInterpolateScalarsBeforeMapping(); },
+      [](vtkMapper* m, double v) { m->SetInterpolateScalarsBeforeMapping(v != 0.); }));
+
+  this->RegisterProperty("vtkSphereSource",
+    Scalar<vtkSphereSource>(
+      "Radius", Double, 0., 0., [](vtkSphereSource* s) { return s->GetRadius(); },
+      [](vtkSphereSource* s, double v) { s->SetRadius(v); }));
+  this->RegisterProperty("vtkSphereSource",
+    Scalar<vtkSphereSource>(
+      "Theta Resolution", Integer, 3., 256.,
+      [](vtkSphereSource* s) -> double { return s->GetThetaResolution(); },
+      [](vtkSphereSource* s, double v) { s->SetThetaResolution(static_cast<int>(v)); }));
+  this->RegisterProperty("vtkSphereSource",
+    Scalar<vtkSphereSource>(
+      "Phi Resolution", Integer, 3., 256.,
+      [](vtkSphereSource* s) -> double { return s->GetPhiResolution(); },
+      [](vtkSphereSource* s, double v) { s->SetPhiResolution(static_cast<int>(v)); }));
+
+  this->RegisterProperty("vtkConeSource",
+    Scalar<vtkConeSource>(
+      "Height", Double, 0., 0., [](vtkConeSource* s) { return s->GetHeight(); },
+      [](vtkConeSource* s, double v) { s->SetHeight(v); }));
+  this->RegisterProperty("vtkConeSource",
+    Scalar<vtkConeSource>(
+      "Radius", Double, 0., 0., [](vtkConeSource* s) { return s->GetRadius(); },
+      [](vtkConeSource* s, double v) { s->SetRadius(v); }));
+  this->RegisterProperty("vtkConeSource",
+    Scalar<vtkConeSource>(
+      "Resolution", Integer, 3., 256.,
+      [](vtkConeSource* s) -> double { return s->GetResolution(); },
+      [](vtkConeSource* s, double v) { s->SetResolution(static_cast<int>(v)); }));
+
+  this->RegisterProperty("vtkContourFilter",
+    Scalar<vtkContourFilter>(
+      "Value", Double, 0., 0., [](vtkContourFilter* f) { return f->GetValue(0); },
+      [](vtkContourFilter* f, double v) { f->SetValue(0, v); }));
+}
+
+vtkDearImGuiPropertyEditor::~vtkDearImGuiPropertyEditor() = default;
+
+void vtkDearImGuiPropertyEditor::RegisterProperty(
+  const char* className, const PropertyDescriptor& descriptor)
+{
+  auto entry = std::find_if(this->Registry.begin(), this->Registry.end(),
+    [className](const std::pair<std::string, std::vector<DescriptorPointer>>& item)
+    { return item.first == className; });
+  if (entry == this->Registry.end())
+  {
+    this->Registry.emplace_back(className, std::vector<DescriptorPointer>());
+    entry = this->Registry.end() - 1;
+  }
+  entry->second.push_back(std::make_shared<const PropertyDescriptor>(descriptor));
+}
+
+bool vtkDearImGuiPropertyEditor::Draw(vtkObject* object)
+{
+  if (!object)
+  {
+    return false;
+  }
+  bool staged = false;
+  ImGui::PushID(object);
+  for (const auto& entry : this->Registry)
+  {
+    if (!object->IsA(entry.first.c_str()))
+    {
+      continue;
+    }
+    for (const DescriptorPointer& descriptor : entry.second)
+    {
+      // show the staged value, the object still holds the old one
+      const auto key = std::make_pair(object, descriptor.get());
+      auto found = this->Staged.find(key);
+      double value[4] = { 0., 0., 0., 0. };
+      if (found != this->Staged.end())
+      {
+        std::copy(found->second.Value, found->second.Value + 4, value);
+      }
+      else
+      {
+        descriptor->Get(object, value);
+      }
+      if (EditValue(*descriptor, value))
+      {
+        StagedEdit& edit = this->Staged[key];
+        edit.Object = object;
+        edit.Descriptor = descriptor;
+        std::copy(value, value + 4, edit.Value);
+        staged = true;
+      }
+    }
+  }
+  ImGui::PopID();
+  return staged;
+}
+
+int vtkDearImGuiPropertyEditor::Commit()
+{
+  int applied = 0;
+  for (auto& entry : this->Staged)
+  {
+    StagedEdit& edit = entry.second;
+    vtkObject* object = edit.Object;
+    if (!object)
+    {
+      continue;
+    }
+    double current[4] = { 0., 0., 0., 0. };
+    edit.Descriptor->Get(object, current);
+    const int count = NumberOfValues(*edit.Descriptor);
+    if (!std::equal(current, current + count, edit.Value))
+    {
+      edit.Descriptor->Set(object, edit.Value);
+      ++applied;
+    }
+  }
+  this->Staged.clear();
+  return applied;
+}
+
+void vtkDearImGuiPropertyEditor::Discard()
+{
+  this->Staged.clear();
+}
@@ -0,0 +1,254 @@
+#include <cstring>
+
+#include <vtkDearImGuiRemoteClient.h>
+
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkObjectFactory.h>
+#include <vtkOpenGLFramebufferObject.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtk_glew.h>
+
+#if defined(GL_ES_VERSION_3_0) && !defined(IMGUI_IMPL_OPENGL_ES3)
+#define IMGUI_IMPL_OPENGL_ES3
+#endif
+
+#include "backends/imgui_impl_opengl3.h"
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiRemoteClient);
+
+vtkDearImGuiRemoteClient::vtkDearImGuiRemoteClient()
+{
+  ImGuiContext* current = ImGui::GetCurrentContext();
+  this->Context = ImGui::CreateContext();
+  ImGui::SetCurrentContext(current ? current : this->Context);
+  this->EventCallbackCommand->SetClientData(this);
+  this->EventCallbackCommand->SetCallback(&vtkDearImGuiRemoteClient::ForwardEvent);
+}
+
+vtkDearImGuiRemoteClient::~vtkDearImGuiRemoteClient()
+{
+  ImGuiContext* current = ImGui::GetCurrentContext();
+  ImGui::SetCurrentContext(this->Context);
+  for (ImDrawList* list : this->Lists)
+  {
+    delete list;
+  }
+  ImGui::DestroyContext(this->Context);
+  ImGui::SetCurrentContext(current != this->Context ? current : nullptr);
+}
+
+bool vtkDearImGuiRemoteClient::Connect(const char* address)
+{
+  this->HasFrame = false;
+  this->Previous.clear();
+  if (!address || !this->Server.Connect(address))
+  {
+    vtkErrorMacro(<< "Cannot connect to " << (address ? address : "(null)"));
+    return false;
+  }
+  return true;
+}
+
+void vtkDearImGuiRemoteClient::Attach(vtkRenderWindowInteractor* interactor)
+{
+  this->Interactor = interactor;
+  int numberOfEvents = 0;
+  const unsigned long* events = vtkDearImGuiRemoteProtocol::GetInputEvents(numberOfEvents);
+  for (int i = 0; i < numberOfEvents; ++i)
+  {
+    // ahead of the interactor style
+    interactor->AddObserver(events[i], this->EventCallbackCommand, 10.0);
+  }
+  interactor->AddObserver(vtkCommand::TimerEvent, this->EventCallbackCommand, 10.0);
+  interactor->AddObserver(vtkCommand::ExitEvent, this, &vtkDearImGuiRemoteClient::TearDown);
+  interactor->GetRenderWindow()->AddObserver(
+    vtkCommand::RenderEvent, this, &vtkDearImGuiRemoteClient::RenderOverlay);
+  interactor->CreateRepeatingTimer(5);
+}
+
+void vtkDearImGuiRemoteClient::ForwardEvent(
+  vtkObject* caller, unsigned long eid, void* clientData, void* callData)
+{
+  auto self = reinterpret_cast<vtkDearImGuiRemoteClient*>(clientData);
+  auto interactor = vtkRenderWindowInteractor::SafeDownCast(caller);
+  if (eid == vtkCommand::TimerEvent)
+  {
+    self->Poll();
+    return;
+  }
+  vtkDearImGuiRemoteProtocol::InputEvent event;
+  std::memset(&event, 0, sizeof(event));
+  event.EventId = static_cast<std::int32_t>(eid);
+  interactor->GetEventPosition(event.Position);
+  event.ControlKey = interactor->GetControlKey();
+  event.ShiftKey = interactor->GetShiftKey();
+  event.AltKey = interactor->GetAltKey();
+  event.KeyCode = static_cast<unsigned char>(interactor->GetKeyCode());
+  event.RepeatCount = interactor->GetRepeatCount();
+  if (const char* keySym = interactor->GetKeySym())
+  {
+    std::strncpy(event.KeySym, keySym, sizeof(event.KeySym) - 1);
+  }
+  self->Server.Queue(vtkDearImGuiRemoteProtocol::InputMessage, &event, sizeof(event));
+  self->Server.Flush();
+  self->EventCallbackCommand->SetAbortFlag(1);
+}
+
+void vtkDearImGuiRemoteClient::Poll()
+{
+  if (!this->Server.Receive())
+  {
+    if (this->Interactor)
+    {
+      vtkErrorMacro(<< "Disconnected from the server.");
+      this->Interactor->TerminateApp();
+      this->Interactor = nullptr;
+    }
+    return;
+  }
+  bool modified = false;
+  vtkDearImGuiRemoteProtocol::MessageHeader header;
+  while (this->Server.NextMessage(header, this->Payload))
+  {
+    this->ReceivedBytes += sizeof(header) + this->Payload.size();
+    switch (header.Type)
+    {
+      case vtkDearImGuiRemoteProtocol::HelloMessage:
+      {
+        vtkDearImGuiRemoteProtocol::Hello hello;
+        std::memset(&hello, 0, sizeof(hello));
+        if (this->Payload.size() == sizeof(hello))
+        {
+          std::memcpy(&hello, this->Payload.data(), sizeof(hello));
+        }
+        if (!vtkDearImGuiRemoteProtocol::IsCompatible(hello))
+        {
+          vtkErrorMacro(<< "The server uses a different protocol or ImGui configuration.");
+          this->Server.Close();
+          return;
+        }
+        this->Previous.clear();
+        this->HasFrame = false;
+        break;
+      }
+      case vtkDearImGuiRemoteProtocol::FontAtlasMessage:
+      {
+        if (this->Payload.size() < sizeof(this->FontSize))
+        {
+          break;
+        }
+        std::memcpy(this->FontSize, this->Payload.data(), sizeof(this->FontSize));
+        this->FontPixels.assign(
+          this->Payload.begin() + sizeof(this->FontSize), this->Payload.end());
+        const std::size_t expected =
+          static_cast<std::size_t>(this->FontSize[0]) * this->FontSize[1] * 4;
+        if (this->FontSize[0] <= 0 || this->FontSize[1] <= 0 ||
+          this->FontPixels.size() != expected)
+        {
+          this->FontSize[0] = this->FontSize[1] = 0;
+          break;
+        }
+        this->FontModified = true;
+        modified = true;
+        break;
+      }
+      case vtkDearImGuiRemoteProtocol::FrameMessage:
+      {
+        if (!vtkDearImGuiRemoteProtocol::DecodeDelta(
+              this->Previous, this->Payload.data(), this->Payload.size(), this->Current))
+        {
+          vtkErrorMacro(<< "Corrupt frame, disconnecting.");
+          this->Server.Close();
+          return;
+        }
+        this->Previous.swap(this->Current);
+        this->HasFrame = true;
+        modified = true;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  if (modified && this->Interactor)
+  {
+    this->Interactor->Render();
+  }
+}
+
+void vtkDearImGuiRemoteClient::RenderOverlay(vtkObject* caller, unsigned long, void*)
+{
+  auto renWin = vtkOpenGLRenderWindow::SafeDownCast(caller);
+  if (!renWin || !this->HasFrame)
+  {
+    return;
+  }
+  ImGuiContext* current = ImGui::GetCurrentContext();
+  ImGui::SetCurrentContext(this->Context);
+  if (!this->BackendReady)
+  {
+    this->BackendReady = ImGui_ImplOpenGL3_Init();
+  }
+  if (this->BackendReady)
+  {
+    ImGui_ImplOpenGL3_NewFrame(); // creates the device objects
+    if (this->FontModified && this->FontSize[0] > 0)
+    {
+      GLint lastTexture;
+      glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+      if (!this->FontTexture)
+      {
+        glGenTextures(1, &this->FontTexture);
+      }
+      glBindTexture(GL_TEXTURE_2D, this->FontTexture);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->FontSize[0], this->FontSize[1], 0, GL_RGBA,
+        GL_UNSIGNED_BYTE, this->FontPixels.data());
+      glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(lastTexture));
+      this->FontModified = false;
+    }
+    if (vtkDearImGuiRemoteProtocol::DeserializeDrawData(this->Previous,
+          (ImTextureID)(intptr_t)this->FontTexture, this->Lists, this->DrawData))
+    {
+      // follow the size of the server's window
+      const int width =
+        static_cast<int>(this->DrawData.DisplaySize.x * this->DrawData.FramebufferScale.x);
+      const int height =
+        static_cast<int>(this->DrawData.DisplaySize.y * this->DrawData.FramebufferScale.y);
+      const int* size = renWin->GetSize();
+      if (width > 0 && height > 0 && (size[0] != width || size[1] != height))
+      {
+        renWin->SetSize(width, height);
+      }
+      auto fbo = renWin->GetRenderFramebuffer();
+      fbo->Bind();
+      ImGui_ImplOpenGL3_RenderDrawData(&this->DrawData);
+      fbo->UnBind();
+    }
+  }
+  ImGui::SetCurrentContext(current);
+}
+
+void vtkDearImGuiRemoteClient::TearDown(vtkObject*, unsigned long, void*)
+{
+  ImGuiContext* current = ImGui::GetCurrentContext();
+  ImGui::SetCurrentContext(this->Context);
+  if (this->FontTexture)
+  {
+    glDeleteTextures(1, &this->FontTexture);
+    this->FontTexture = 0;
+  }
+  if (this->BackendReady)
+  {
+    ImGui_ImplOpenGL3_Shutdown();
+    this->BackendReady = false;
+  }
+  ImGui::SetCurrentContext(current);
+  this->Server.Close();
+}
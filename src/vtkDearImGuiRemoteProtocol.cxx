@@ -0,0 +1,903 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include <vtkDearImGuiRemoteProtocol.h>
+
+#include <vtkCommand.h>
+#include <vtkRenderWindowInteractor.h>
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+#define REMOTE_UI_NO_SOCKETS 1
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+const std::uint32_t Magic = 0x49474d49; // "IMGI"
+const std::uint32_t Version = 2;
+// Zero bytes that end a literal run, shorter runs are cheaper to copy.
+const std::size_t MinimumZeroRun = 8;
+// Larger messages close the connection, the font atlas is the largest legitimate one.
+const std::uint32_t MaximumMessageSize = 128u << 20;
+// Consumed input is dropped once this much piled up in front of a partial message.
+const std::size_t CompactThreshold = 64u << 10;
+// Bytes one Receive() reads at most, the rest waits for the next poll.
+const std::size_t MaximumReceive = 4u << 20;
+
+// Events a client forwards, the ones vtkDearImGuiInjector::DispatchEv handles.
+const unsigned long InputEvents[] = { vtkCommand::EnterEvent, vtkCommand::LeaveEvent,
+  vtkCommand::MouseMoveEvent, vtkCommand::LeftButtonPressEvent,
+  vtkCommand::LeftButtonReleaseEvent, vtkCommand::LeftButtonDoubleClickEvent,
+  vtkCommand::MiddleButtonPressEvent, vtkCommand::MiddleButtonReleaseEvent,
+  vtkCommand::MiddleButtonDoubleClickEvent, vtkCommand::RightButtonPressEvent,
+  vtkCommand::RightButtonReleaseEvent, vtkCommand::RightButtonDoubleClickEvent,
+  vtkCommand::MouseWheelForwardEvent, vtkCommand::MouseWheelBackwardEvent,
+  vtkCommand::MouseWheelLeftEvent, vtkCommand::MouseWheelRightEvent, vtkCommand::KeyPressEvent,
+  vtkCommand::KeyReleaseEvent, vtkCommand::CharEvent };
+
+struct FrameHeader
+{
+  float DisplayPos[2];
+  float DisplaySize[2];
+  float FramebufferScale[2];
+  std::int32_t NumberOfLists;
+};
+
+struct ListHeader
+{
+  std::uint32_t Owner; // hash of the window name, pairs lists across frames
+  std::int32_t NumberOfVertices;
+  std::int32_t NumberOfIndices;
+  std::int32_t NumberOfCommands;
+};
+
+struct CommandRecord
+{
+  float ClipRect[4];
+  std::uint32_t Texture;
+  std::uint32_t VtxOffset;
+  std::uint32_t IdxOffset;
+  std::uint32_t ElemCount;
+};
+
+void Append(std::vector<unsigned char>& out, const void* data, std::size_t size)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  out.insert(out.end(), bytes, bytes + size);
+}
+
+// Reads from a serialized frame, failing once the data runs out.
+struct Reader
+{
+  const std::vector<unsigned char>& Data;
+  std::size_t Offset;
+
+  bool Read(void* destination, std::size_t size)
+  {
+    if (size > this->Data.size() - this->Offset)
+    {
+      return false;
+    }
+    if (!size)
+    {
+      return true; // empty buffers may have no storage
+    }
+    std::memcpy(destination, this->Data.data() + this->Offset, size);
+    this->Offset += size;
+    return true;
+  }
+
+  bool Skip(std::size_t size)
+  {
+    if (size > this->Data.size() - this->Offset)
+    {
+      return false;
+    }
+    this->Offset += size;
+    return true;
+  }
+
+  std::size_t Remaining() const { return this->Data.size() - this->Offset; }
+};
+
+void AppendVarint(std::vector<unsigned char>& out, std::size_t value)
+{
+  while (value >= 0x80)
+  {
+    out.push_back(static_cast<unsigned char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<unsigned char>(value));
+}
+
+bool ReadVarint(
+  const unsigned char* data, std::size_t size, std::size_t& offset, std::size_t& value)
+{
+  value = 0;
+  for (int shift = 0; offset < size && shift < 64; shift += 7)
+  {
+    const unsigned char byte = data[offset++];
+    value |= static_cast<std::size_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::uint32_t OwnerKey(const ImDrawList* list, int index)
+{
+#if IMGUI_VERSION_NUM >= 17700
+  const char* owner = list->_OwnerName;
+  if (owner && owner[0])
+  {
+    // FNV-1a
+    std::uint32_t hash = 2166136261u;
+    for (; *owner; ++owner)
+    {
+      hash = (hash ^ static_cast<unsigned char>(*owner)) * 16777619u;
+    }
+    return hash;
+  }
+#else
+  (void)list;
+#endif
+  return static_cast<std::uint32_t>(index);
+}
+
+// Bytes of a serialized frame that are diffed against the same bytes of the previous frame.
+struct Section
+{
+  const unsigned char* Data = nullptr;
+  std::size_t Size = 0;
+};
+
+// A list split into its header and commands, its vertices and its indices, so that
+// geometry growing in one buffer does not shift the others.
+struct ListSections
+{
+  std::uint32_t Owner = 0;
+  Section Parts[3];
+};
+
+bool SplitFrame(
+  const std::vector<unsigned char>& frame, Section& header, std::vector<ListSections>& lists)
+{
+  lists.clear();
+  Reader reader{ frame, 0 };
+  FrameHeader frameHeader;
+  if (!reader.Read(&frameHeader, sizeof(frameHeader)) || frameHeader.NumberOfLists < 0 ||
+    static_cast<std::size_t>(frameHeader.NumberOfLists) > reader.Remaining() / sizeof(ListHeader))
+  {
+    return false;
+  }
+  header.Data = frame.data();
+  header.Size = sizeof(frameHeader);
+  lists.resize(frameHeader.NumberOfLists);
+  for (ListSections& list : lists)
+  {
+    const std::size_t begin = reader.Offset;
+    ListHeader listHeader;
+    if (!reader.Read(&listHeader, sizeof(listHeader)) || listHeader.NumberOfVertices < 0 ||
+      listHeader.NumberOfIndices < 0 || listHeader.NumberOfCommands < 0)
+    {
+      return false;
+    }
+    const std::size_t sizes[3] = { sizeof(ListHeader) +
+        static_cast<std::size_t>(listHeader.NumberOfCommands) * sizeof(CommandRecord),
+      static_cast<std::size_t>(listHeader.NumberOfVertices) * sizeof(ImDrawVert),
+      static_cast<std::size_t>(listHeader.NumberOfIndices) * sizeof(ImDrawIdx) };
+    if (!reader.Skip(sizes[0] - sizeof(ListHeader)) || !reader.Skip(sizes[1]) ||
+      !reader.Skip(sizes[2]))
+    {
+      return false;
+    }
+    list.Owner = listHeader.Owner;
+    std::size_t offset = begin;
+    for (int i = 0; i < 3; ++i)
+    {
+      list.Parts[i].Data = frame.data() + offset;
+      list.Parts[i].Size = sizes[i];
+      offset += sizes[i];
+    }
+  }
+  return reader.Offset == frame.size();
+}
+
+// XOR current against base (zero extended) and encode zero runs, appended to out.
+void EncodeSection(const Section& base, const Section& current, std::vector<unsigned char>& out)
+{
+  const std::size_t size = current.Size;
+  auto delta = [&](std::size_t i) -> unsigned char {
+    return current.Data[i] ^ (i < base.Size ? base.Data[i] : 0);
+  };
+  AppendVarint(out, size);
+  std::size_t i = 0;
+  while (i < size)
+  {
+    const std::size_t zerosBegin = i;
+    while (i < size && delta(i) == 0)
+    {
+      ++i;
+    }
+    // the literal ends at the next long enough run of unchanged bytes
+    std::size_t end = i;
+    std::size_t run = 0;
+    while (end < size)
+    {
+      if (delta(end) == 0)
+      {
+        if (++run == MinimumZeroRun)
+        {
+          end -= MinimumZeroRun - 1;
+          break;
+        }
+      }
+      else
+      {
+        run = 0;
+      }
+      ++end;
+    }
+    AppendVarint(out, i - zerosBegin);
+    AppendVarint(out, end - i);
+    for (; i < end; ++i)
+    {
+      out.push_back(delta(i));
+    }
+  }
+}
+
+// Inverse of EncodeSection, appended to current.
+bool DecodeSection(const Section& base, const unsigned char* data, std::size_t size,
+  std::size_t& offset, std::vector<unsigned char>& current)
+{
+  std::size_t total = 0;
+  if (!ReadVarint(data, size, offset, total) || total > MaximumMessageSize - current.size())
+  {
+    return false;
+  }
+  std::size_t i = 0;
+  auto baseAt = [&](std::size_t index) -> unsigned char {
+    return index < base.Size ? base.Data[index] : 0;
+  };
+  while (i < total)
+  {
+    std::size_t zeros = 0, literal = 0;
+    if (!ReadVarint(data, size, offset, zeros) || !ReadVarint(data, size, offset, literal) ||
+      zeros > total - i || literal > total - i - zeros || literal > size - offset ||
+      (zeros == 0 && literal == 0))
+    {
+      return false;
+    }
+    for (const std::size_t end = i + zeros; i < end; ++i)
+    {
+      current.push_back(baseAt(i));
+    }
+    for (const std::size_t end = i + literal; i < end; ++i)
+    {
+      current.push_back(baseAt(i) ^ data[offset++]);
+    }
+  }
+  return true;
+}
+
+#ifndef REMOTE_UI_NO_SOCKETS
+bool SetNonBlocking(int socket)
+{
+  const int flags = fcntl(socket, F_GETFL, 0);
+  return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+bool IsUnixAddress(const std::string& address, std::string& path)
+{
+  if (address.compare(0, 7, "unix://") == 0)
+  {
+    path = address.substr(7);
+    return true;
+  }
+  if (address.compare(0, 5, "unix:") == 0)
+  {
+    path = address.substr(5);
+    return true;
+  }
+  return false;
+}
+
+// host and port of "tcp://host:port" or "host:port"
+bool SplitHostPort(const std::string& address, std::string& host, std::string& port)
+{
+  std::string rest = address.compare(0, 6, "tcp://") == 0 ? address.substr(6) : address;
+  const std::size_t colon = rest.rfind(':');
+  if (colon == std::string::npos)
+  {
+    return false;
+  }
+  host = rest.substr(0, colon);
+  port = rest.substr(colon + 1);
+  if (host.size() > 1 && host.front() == '[' && host.back() == ']')
+  {
+    host = host.substr(1, host.size() - 2);
+  }
+  return true;
+}
+
+// A socket bound (listen) or connected (!listen) to address, -1 on failure.
+int OpenSocket(const std::string& address, bool listen)
+{
+  std::string path;
+  if (IsUnixAddress(address, path))
+  {
+    sockaddr_un name;
+    std::memset(&name, 0, sizeof(name));
+    if (path.empty() || path.size() >= sizeof(name.sun_path))
+    {
+      return -1;
+    }
+    name.sun_family = AF_UNIX;
+    std::memcpy(name.sun_path, path.c_str(), path.size());
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+      return -1;
+    }
+    if (listen)
+    {
+      unlink(path.c_str());
+    }
+    const sockaddr* target = reinterpret_cast<const sockaddr*>(&name);
+    if ((listen ? bind(fd, target, sizeof(name)) : connect(fd, target, sizeof(name))) != 0)
+    {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  std::string host, port;
+  if (!SplitHostPort(address, host, port))
+  {
+    return -1;
+  }
+  addrinfo hints;
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  // without a host, servers listen on loopback, "*" listens on all interfaces
+  const bool anyInterface = listen && host == "*";
+  if (host.empty())
+  {
+    host = "127.0.0.1";
+  }
+  hints.ai_flags = anyInterface ? AI_PASSIVE : 0;
+  addrinfo* results = nullptr;
+  if (getaddrinfo(anyInterface ? nullptr : host.c_str(), port.c_str(), &hints, &results) != 0)
+  {
+    return -1;
+  }
+  int fd = -1;
+  for (addrinfo* info = results; info && fd < 0; info = info->ai_next)
+  {
+    fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd < 0)
+    {
+      continue;
+    }
+    const int one = 1;
+    if (listen)
+    {
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    }
+    if ((listen ? bind(fd, info->ai_addr, info->ai_addrlen)
+                : connect(fd, info->ai_addr, info->ai_addrlen)) != 0)
+    {
+      close(fd);
+      fd = -1;
+      continue;
+    }
+    // frames are small and latency matters more than packet count
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  freeaddrinfo(results);
+  return fd;
+}
+#endif
+}
+
+vtkDearImGuiRemoteProtocol::Hello vtkDearImGuiRemoteProtocol::MakeHello()
+{
+  Hello hello;
+  hello.Magic = Magic;
+  hello.Version = Version;
+  hello.VertexSize = sizeof(ImDrawVert);
+  hello.IndexSize = sizeof(ImDrawIdx);
+  return hello;
+}
+
+bool vtkDearImGuiRemoteProtocol::IsCompatible(const Hello& hello)
+{
+  const Hello expected = MakeHello();
+  return std::memcmp(&hello, &expected, sizeof(Hello)) == 0;
+}
+
+bool vtkDearImGuiRemoteProtocol::IsInputEvent(unsigned long eventId)
+{
+  return std::find(std::begin(InputEvents), std::end(InputEvents), eventId) !=
+    std::end(InputEvents);
+}
+
+const unsigned long* vtkDearImGuiRemoteProtocol::GetInputEvents(int& count)
+{
+  count = static_cast<int>(sizeof(InputEvents) / sizeof(InputEvents[0]));
+  return InputEvents;
+}
+
+bool vtkDearImGuiRemoteProtocol::ReplayInputEvent(
+  const InputEvent& event, vtkRenderWindowInteractor* interactor)
+{
+  // peers only get to invoke the events a client forwards
+  if (event.EventId < 0 || !IsInputEvent(static_cast<unsigned long>(event.EventId)))
+  {
+    return false;
+  }
+  char keySym[sizeof(event.KeySym)];
+  std::memcpy(keySym, event.KeySym, sizeof(keySym));
+  keySym[sizeof(keySym) - 1] = '\0';
+  interactor->SetEventInformation(event.Position[0], event.Position[1], event.ControlKey,
+    event.ShiftKey, static_cast<char>(event.KeyCode), event.RepeatCount,
+    keySym[0] ? keySym : nullptr);
+  interactor->SetAltKey(event.AltKey);
+  interactor->InvokeEvent(static_cast<unsigned long>(event.EventId), nullptr);
+  return true;
+}
+
+void vtkDearImGuiRemoteProtocol::SerializeDrawData(
+  const ImDrawData* drawData, ImTextureID fontTexture, std::vector<unsigned char>& out)
+{
+  out.clear();
+  FrameHeader header;
+  header.DisplayPos[0] = drawData->DisplayPos.x;
+  header.DisplayPos[1] = drawData->DisplayPos.y;
+  header.DisplaySize[0] = drawData->DisplaySize.x;
+  header.DisplaySize[1] = drawData->DisplaySize.y;
+  header.FramebufferScale[0] = drawData->FramebufferScale.x;
+  header.FramebufferScale[1] = drawData->FramebufferScale.y;
+  header.NumberOfLists = drawData->CmdListsCount;
+  Append(out, &header, sizeof(header));
+
+  for (int n = 0; n < drawData->CmdListsCount; ++n)
+  {
+    const ImDrawList* list = drawData->CmdLists[n];
+    ListHeader listHeader;
+    listHeader.Owner = OwnerKey(list, n);
+    listHeader.NumberOfVertices = list->VtxBuffer.Size;
+    listHeader.NumberOfIndices = list->IdxBuffer.Size;
+    listHeader.NumberOfCommands = 0;
+    for (const ImDrawCmd& cmd : list->CmdBuffer)
+    {
+      listHeader.NumberOfCommands += cmd.UserCallback ? 0 : 1;
+    }
+    Append(out, &listHeader, sizeof(listHeader));
+    // commands first, they change less than geometry and keep their offsets
+    for (const ImDrawCmd& cmd : list->CmdBuffer)
+    {
+      if (cmd.UserCallback)
+      {
+        continue;
+      }
+      CommandRecord record;
+      record.ClipRect[0] = cmd.ClipRect.x;
+      record.ClipRect[1] = cmd.ClipRect.y;
+      record.ClipRect[2] = cmd.ClipRect.z;
+      record.ClipRect[3] = cmd.ClipRect.w;
+      record.Texture = cmd.TextureId == fontTexture ? FontTexture : NoTexture;
+      record.VtxOffset = cmd.VtxOffset;
+      record.IdxOffset = cmd.IdxOffset;
+      record.ElemCount = cmd.ElemCount;
+      Append(out, &record, sizeof(record));
+    }
+    Append(out, list->VtxBuffer.Data, list->VtxBuffer.size_in_bytes());
+    Append(out, list->IdxBuffer.Data, list->IdxBuffer.size_in_bytes());
+  }
+}
+
+bool vtkDearImGuiRemoteProtocol::DeserializeDrawData(const std::vector<unsigned char>& in,
+  ImTextureID fontTexture, std::vector<ImDrawList*>& lists, ImDrawData& drawData)
+{
+  Reader reader{ in, 0 };
+  FrameHeader header;
+  // every list takes at least its header, bound the allocation by the payload
+  if (!reader.Read(&header, sizeof(header)) || header.NumberOfLists < 0 ||
+    static_cast<std::size_t>(header.NumberOfLists) > reader.Remaining() / sizeof(ListHeader))
+  {
+    return false;
+  }
+  while (lists.size() < static_cast<std::size_t>(header.NumberOfLists))
+  {
+    lists.push_back(new ImDrawList(ImGui::GetDrawListSharedData()));
+  }
+
+  drawData.Clear();
+  drawData.DisplayPos = ImVec2(header.DisplayPos[0], header.DisplayPos[1]);
+  drawData.DisplaySize = ImVec2(header.DisplaySize[0], header.DisplaySize[1]);
+  drawData.FramebufferScale = ImVec2(header.FramebufferScale[0], header.FramebufferScale[1]);
+  for (int n = 0; n < header.NumberOfLists; ++n)
+  {
+    ListHeader listHeader;
+    if (!reader.Read(&listHeader, sizeof(listHeader)) || listHeader.NumberOfVertices < 0 ||
+      listHeader.NumberOfIndices < 0 || listHeader.NumberOfCommands < 0)
+    {
+      return false;
+    }
+    ImDrawList* list = lists[n];
+    list->CmdBuffer.resize(0);
+    for (int c = 0; c < listHeader.NumberOfCommands; ++c)
+    {
+      CommandRecord record;
+      if (!reader.Read(&record, sizeof(record)))
+      {
+        return false;
+      }
+      if (record.IdxOffset + static_cast<std::uint64_t>(record.ElemCount) >
+        static_cast<std::uint64_t>(listHeader.NumberOfIndices))
+      {
+        return false;
+      }
+      if (record.Texture != FontTexture)
+      {
+        continue;
+      }
+      ImDrawCmd cmd;
+      cmd.ClipRect =
+        ImVec4(record.ClipRect[0], record.ClipRect[1], record.ClipRect[2], record.ClipRect[3]);
+      cmd.TextureId = fontTexture;
+      cmd.VtxOffset = record.VtxOffset;
+      cmd.IdxOffset = record.IdxOffset;
+      cmd.ElemCount = record.ElemCount;
+      list->CmdBuffer.push_back(cmd);
+    }
+    list->VtxBuffer.resize(listHeader.NumberOfVertices);
+    list->IdxBuffer.resize(listHeader.NumberOfIndices);
+    if (!reader.Read(list->VtxBuffer.Data, list->VtxBuffer.size_in_bytes()) ||
+      !reader.Read(list->IdxBuffer.Data, list->IdxBuffer.size_in_bytes()))
+    {
+      return false;
+    }
+    // indices are replayed by the GPU, keep them inside the vertex buffer
+    for (const ImDrawCmd& cmd : list->CmdBuffer)
+    {
+      for (unsigned int i = 0; i < cmd.ElemCount; ++i)
+      {
+        if (cmd.VtxOffset + list->IdxBuffer[cmd.IdxOffset + i] >=
+          static_cast<unsigned int>(list->VtxBuffer.Size))
+        {
+          return false;
+        }
+      }
+    }
+    drawData.TotalVtxCount += list->VtxBuffer.Size;
+    drawData.TotalIdxCount += list->IdxBuffer.Size;
+#if IMGUI_VERSION_NUM >= 18980
+    drawData.CmdLists.push_back(list);
+#endif
+  }
+#if IMGUI_VERSION_NUM < 18980
+  drawData.CmdLists = lists.data();
+#endif
+  drawData.CmdListsCount = header.NumberOfLists;
+  drawData.Valid = true;
+  return reader.Offset == in.size();
+}
+
+bool vtkDearImGuiRemoteProtocol::EncodeDelta(const std::vector<unsigned char>& previous,
+  const std::vector<unsigned char>& current, std::vector<unsigned char>& out)
+{
+  Section header, previousHeader;
+  std::vector<ListSections> lists, previousLists;
+  if (!SplitFrame(current, header, lists))
+  {
+    return false;
+  }
+  if (!SplitFrame(previous, previousHeader, previousLists))
+  {
+    previousHeader = Section();
+    previousLists.clear();
+  }
+  AppendVarint(out, lists.size());
+  EncodeSection(previousHeader, header, out);
+  std::vector<bool> used(previousLists.size(), false);
+  for (std::size_t n = 0; n < lists.size(); ++n)
+  {
+    // the same window in the previous frame, lists reorder when windows are focused
+    std::size_t base = previousLists.size();
+    for (std::size_t p = 0; p < previousLists.size() && base == previousLists.size(); ++p)
+    {
+      if (!used[p] && previousLists[p].Owner == lists[n].Owner)
+      {
+        base = p;
+      }
+    }
+    if (base == previousLists.size() && n < previousLists.size() && !used[n])
+    {
+      base = n;
+    }
+    const bool hasBase = base < previousLists.size();
+    if (hasBase)
+    {
+      used[base] = true;
+    }
+    AppendVarint(out, hasBase ? base + 1 : 0);
+    for (int i = 0; i < 3; ++i)
+    {
+      EncodeSection(hasBase ? previousLists[base].Parts[i] : Section(), lists[n].Parts[i], out);
+    }
+  }
+  return true;
+}
+
+bool vtkDearImGuiRemoteProtocol::DecodeDelta(const std::vector<unsigned char>& previous,
+  const unsigned char* data, std::size_t size, std::vector<unsigned char>& current)
+{
+  Section previousHeader;
+  std::vector<ListSections> previousLists;
+  if (!SplitFrame(previous, previousHeader, previousLists))
+  {
+    previousHeader = Section();
+    previousLists.clear();
+  }
+  current.clear();
+  std::size_t offset = 0;
+  std::size_t count = 0;
+  // every list takes at least four bytes
+  if (!ReadVarint(data, size, offset, count) || count > size / 4 ||
+    !DecodeSection(previousHeader, data, size, offset, current))
+  {
+    return false;
+  }
+  for (std::size_t n = 0; n < count; ++n)
+  {
+    std::size_t base = 0;
+    if (!ReadVarint(data, size, offset, base) || base > previousLists.size())
+    {
+      return false;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      if (!DecodeSection(
+            base ? previousLists[base - 1].Parts[i] : Section(), data, size, offset, current))
+      {
+        return false;
+      }
+    }
+  }
+  return offset == size;
+}
+
+vtkDearImGuiRemoteProtocol::Connection::~Connection()
+{
+  this->Close();
+}
+
+bool vtkDearImGuiRemoteProtocol::Connection::Connect(const std::string& address)
+{
+  this->Close();
+#ifdef REMOTE_UI_NO_SOCKETS
+  (void)address;
+  return false;
+#else
+  const int fd = OpenSocket(address, false);
+  if (fd < 0)
+  {
+    return false;
+  }
+  this->Adopt(fd);
+  return true;
+#endif
+}
+
+void vtkDearImGuiRemoteProtocol::Connection::Adopt(int socket)
+{
+  this->Close();
+#ifndef REMOTE_UI_NO_SOCKETS
+  SetNonBlocking(socket);
+#ifdef SO_NOSIGPIPE
+  const int one = 1;
+  setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+#endif
+  this->Socket = socket;
+}
+
+void vtkDearImGuiRemoteProtocol::Connection::Close()
+{
+  if (this->Socket >= 0)
+  {
+    CloseSocket(this->Socket);
+    this->Socket = -1;
+  }
+  this->In.clear();
+  this->InOffset = 0;
+  this->Out.clear();
+  this->OutOffset = 0;
+}
+
+void vtkDearImGuiRemoteProtocol::Connection::Queue(
+  std::uint32_t type, const void* data, std::size_t size)
+{
+  if (!this->IsOpen())
+  {
+    return;
+  }
+  MessageHeader header;
+  header.Type = type;
+  header.Size = static_cast<std::uint32_t>(size);
+  Append(this->Out, &header, sizeof(header));
+  Append(this->Out, data, size);
+}
+
+bool vtkDearImGuiRemoteProtocol::Connection::Flush()
+{
+#ifdef REMOTE_UI_NO_SOCKETS
+  return false;
+#else
+  if (!this->IsOpen())
+  {
+    return false;
+  }
+#ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL;
+#else
+  const int flags = 0;
+#endif
+  while (this->OutOffset < this->Out.size())
+  {
+    const ssize_t sent = send(this->Socket, this->Out.data() + this->OutOffset,
+      this->Out.size() - this->OutOffset, flags);
+    if (sent < 0)
+    {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+      {
+        return true;
+      }
+      this->Close();
+      return false;
+    }
+    this->OutOffset += static_cast<std::size_t>(sent);
+  }
+  this->Out.clear();
+  this->OutOffset = 0;
+  return true;
+#endif
+}
+
+bool vtkDearImGuiRemoteProtocol::Connection::Receive()
+{
+#ifdef REMOTE_UI_NO_SOCKETS
+  return false;
+#else
+  if (!this->IsOpen())
+  {
+    return false;
+  }
+  unsigned char buffer[16384];
+  for (std::size_t total = 0; total < MaximumReceive;)
+  {
+    // a complete message is buffered, NextMessage() takes it or closes the connection
+    if (this->In.size() - this->InOffset > sizeof(MessageHeader) + MaximumMessageSize)
+    {
+      return true;
+    }
+    const ssize_t received = recv(this->Socket, buffer, sizeof(buffer), 0);
+    if (received > 0)
+    {
+      Append(this->In, buffer, static_cast<std::size_t>(received));
+      total += static_cast<std::size_t>(received);
+      continue;
+    }
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+    {
+      return true;
+    }
+    // closed by the peer or failed
+    this->Close();
+    return false;
+  }
+  return true;
+#endif
+}
+
+bool vtkDearImGuiRemoteProtocol::Connection::NextMessage(
+  MessageHeader& header, std::vector<unsigned char>& payload)
+{
+  const std::size_t available = this->In.size() - this->InOffset;
+  if (available < sizeof(MessageHeader))
+  {
+    return false;
+  }
+  std::memcpy(&header, this->In.data() + this->InOffset, sizeof(MessageHeader));
+  if (header.Size > MaximumMessageSize)
+  {
+    // a broken or hostile peer, do not buffer toward it
+    this->Close();
+    return false;
+  }
+  if (available - sizeof(MessageHeader) < header.Size)
+  {
+    return false;
+  }
+  const unsigned char* begin = this->In.data() + this->InOffset + sizeof(MessageHeader);
+  payload.assign(begin, begin + header.Size);
+  this->InOffset += sizeof(MessageHeader) + header.Size;
+  if (this->InOffset == this->In.size())
+  {
+    this->In.clear();
+    this->InOffset = 0;
+  }
+  else if (this->InOffset >= CompactThreshold)
+  {
+    this->In.erase(this->In.begin(), this->In.begin() + this->InOffset);
+    this->InOffset = 0;
+  }
+  return true;
+}
+
+int vtkDearImGuiRemoteProtocol::Listen(const std::string& address)
+{
+#ifdef REMOTE_UI_NO_SOCKETS
+  (void)address;
+  return -1;
+#else
+  const int fd = OpenSocket(address, true);
+  if (fd < 0)
+  {
+    return -1;
+  }
+  if (listen(fd, 1) != 0 || !SetNonBlocking(fd))
+  {
+    CloseSocket(fd, address);
+    return -1;
+  }
+  return fd;
+#endif
+}
+
+int vtkDearImGuiRemoteProtocol::Accept(int listener)
+{
+#ifdef REMOTE_UI_NO_SOCKETS
+  (void)listener;
+  return -1;
+#else
+  const int fd = accept(listener, nullptr, nullptr);
+  if (fd >= 0)
+  {
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // fails for unix sockets
+  }
+  return fd;
+#endif
+}
+
+void vtkDearImGuiRemoteProtocol::CloseSocket(int socket, const std::string& address)
+{
+#ifdef REMOTE_UI_NO_SOCKETS
+  (void)socket;
+  (void)address;
+#else
+  close(socket);
+  std::string path;
+  if (IsUnixAddress(address, path))
+  {
+    unlink(path.c_str());
+  }
+#endif
+}
@@ -0,0 +1,142 @@
+#include <cstring>
+
+#include <vtkDearImGuiRemoteServer.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkObjectFactory.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiRemoteServer);
+
+vtkDearImGuiRemoteServer::vtkDearImGuiRemoteServer() = default;
+
+vtkDearImGuiRemoteServer::~vtkDearImGuiRemoteServer()
+{
+  this->Close();
+}
+
+bool vtkDearImGuiRemoteServer::Listen(const char* address)
+{
+  this->Close();
+  this->Listener = vtkDearImGuiRemoteProtocol::Listen(address ? address : "");
+  if (this->Listener < 0)
+  {
+    vtkErrorMacro(<< "Cannot listen on " << (address ? address : "(null)"));
+    return false;
+  }
+  this->Address = address;
+  return true;
+}
+
+void vtkDearImGuiRemoteServer::Close()
+{
+  this->Client.Close();
+  if (this->Listener >= 0)
+  {
+    vtkDearImGuiRemoteProtocol::CloseSocket(this->Listener, this->Address);
+    this->Listener = -1;
+  }
+  this->Address.clear();
+}
+
+void vtkDearImGuiRemoteServer::Accept()
+{
+  const int socket = vtkDearImGuiRemoteProtocol::Accept(this->Listener);
+  if (socket < 0)
+  {
+    return;
+  }
+  if (this->Client.IsOpen())
+  {
+    // one client at a time, the newest wins
+    this->Client.Close();
+  }
+  this->Client.Adopt(socket);
+  const vtkDearImGuiRemoteProtocol::Hello hello = vtkDearImGuiRemoteProtocol::MakeHello();
+  this->Client.Queue(vtkDearImGuiRemoteProtocol::HelloMessage, &hello, sizeof(hello));
+  // the next frame is sent whole
+  this->Previous.clear();
+  this->FramePending = false;
+  this->FontAtlasSent = false;
+}
+
+bool vtkDearImGuiRemoteServer::Poll(vtkRenderWindowInteractor* interactor)
+{
+  if (this->Listener < 0)
+  {
+    return false;
+  }
+  this->Accept();
+  if (!this->Client.IsOpen())
+  {
+    return false;
+  }
+  this->SendPendingFrame();
+
+  bool replayed = false;
+  vtkDearImGuiRemoteProtocol::MessageHeader header;
+  this->Client.Receive();
+  while (this->Client.NextMessage(header, this->Payload))
+  {
+    if (header.Type != vtkDearImGuiRemoteProtocol::InputMessage ||
+      this->Payload.size() != sizeof(vtkDearImGuiRemoteProtocol::InputEvent))
+    {
+      continue;
+    }
+    vtkDearImGuiRemoteProtocol::InputEvent event;
+    std::memcpy(&event, this->Payload.data(), sizeof(event));
+    replayed |= vtkDearImGuiRemoteProtocol::ReplayInputEvent(event, interactor);
+  }
+  return replayed;
+}
+
+void vtkDearImGuiRemoteServer::SendDrawData(ImDrawData* drawData)
+{
+  if (!this->Client.IsOpen() || !drawData || !drawData->Valid)
+  {
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope("SendDrawData", "remote");
+  ImGuiIO& io = ImGui::GetIO();
+  if (!this->FontAtlasSent)
+  {
+    unsigned char* pixels = nullptr;
+    int size[2] = { 0, 0 };
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &size[0], &size[1]);
+    this->Payload.assign(reinterpret_cast<unsigned char*>(size),
+      reinterpret_cast<unsigned char*>(size) + sizeof(size));
+    this->Payload.insert(
+      this->Payload.end(), pixels, pixels + static_cast<std::size_t>(size[0]) * size[1] * 4);
+    this->Client.Queue(vtkDearImGuiRemoteProtocol::FontAtlasMessage, this->Payload);
+    this->FontAtlasSent = true;
+  }
+  vtkDearImGuiRemoteProtocol::SerializeDrawData(drawData, io.Fonts->TexID, this->Current);
+  this->FramePending = true;
+  this->SendPendingFrame();
+}
+
+void vtkDearImGuiRemoteServer::SendPendingFrame()
+{
+  // Frames are only queued on an empty socket buffer, a slow client skips frames
+  // instead of accumulating latency.
+  if (this->FramePending && this->Client.Flush() && this->Client.GetPendingBytes() == 0)
+  {
+    this->FramePending = false;
+    if (this->Current == this->Previous)
+    {
+      return;
+    }
+    this->Encoded.clear();
+    if (!vtkDearImGuiRemoteProtocol::EncodeDelta(this->Previous, this->Current, this->Encoded))
+    {
+      return;
+    }
+    this->Client.Queue(vtkDearImGuiRemoteProtocol::FrameMessage, this->Encoded);
+    this->LastFrameSize = static_cast<unsigned long>(this->Current.size());
+    this->LastEncodedFrameSize = static_cast<unsigned long>(this->Encoded.size());
+    this->SentBytes += this->Encoded.size();
+    this->Previous.swap(this->Current);
+  }
+  this->Client.Flush();
+}
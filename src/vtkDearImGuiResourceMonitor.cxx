@@ -0,0 +1,647 @@
+#include <algorithm>
+#include <cstdio>
+#include <unordered_set>
+
+#include <vtkDearImGuiResourceMonitor.h>
+#include <vtkDearImGuiTable.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkAbstractVolumeMapper.h>
+#include <vtkActor.h>
+#include <vtkActor2D.h>
+#include <vtkCellArray.h>
+#include <vtkCompositeDataIterator.h>
+#include <vtkCompositeDataSet.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkImageData.h>
+#include <vtkMapper.h>
+#include <vtkMapper2D.h>
+#include <vtkObjectFactory.h>
+#include <vtkOpenGLFramebufferObject.h>
+#include <vtkOpenGLRenderWindow.h>
+#include <vtkOpenGLTexture.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkProperty.h>
+#include <vtkPropCollection.h>
+#include <vtkRenderer.h>
+#include <vtkRendererCollection.h>
+#include <vtkSmartPointer.h>
+#include <vtkTextureObject.h>
+#include <vtkVersionMacros.h>
+#include <vtkVolume.h>
+#include <vtk_glew.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiResourceMonitor);
+
+namespace
+{
+const char* CategoryNames[] = { "Datasets", "Buffers", "Textures", "Framebuffers", "Programs",
+  "Overlay" };
+
+// program names are small and dense, stop probing after this many free ones
+const unsigned int ProgramProbeGap = 256;
+
+std::string Label(vtkObject* object, int number)
+{
+#if VTK_MAJOR_VERSION > 9 || (VTK_MAJOR_VERSION == 9 && VTK_MINOR_VERSION >= 2)
+  const std::string name = object->GetObjectName();
+  if (!name.empty())
+  {
+    return name;
+  }
+#endif
+  char label[96];
+  std::snprintf(label, sizeof(label), "%s %d", object->GetClassName(), number);
+  return label;
+}
+
+std::string FormatBytes(std::size_t bytes)
+{
+  const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+  double value = static_cast<double>(bytes);
+  int unit = 0;
+  while (value >= 1024. && unit < 4)
+  {
+    value /= 1024.;
+    ++unit;
+  }
+  char text[32];
+  std::snprintf(text, sizeof(text), unit ? "%.1f %s" : "%.0f %s", value, units[unit]);
+  return text;
+}
+
+vtkAlgorithm* PropMapper(vtkProp* prop)
+{
+  if (vtkActor* actor = vtkActor::SafeDownCast(prop))
+  {
+    return actor->GetMapper();
+  }
+  if (vtkVolume* volume = vtkVolume::SafeDownCast(prop))
+  {
+    return volume->GetMapper();
+  }
+  if (vtkActor2D* actor = vtkActor2D::SafeDownCast(prop))
+  {
+    return actor->GetMapper();
+  }
+  return nullptr;
+}
+
+vtkDataObject* MapperInput(vtkAlgorithm* mapper)
+{
+  if (!mapper || mapper->GetNumberOfInputPorts() < 1 ||
+    mapper->GetNumberOfInputConnections(0) < 1)
+  {
+    return nullptr;
+  }
+  return mapper->GetInputDataObject(0, 0);
+}
+
+// Changes with the prop, its properties and textures, its mapper and the input.
+vtkMTimeType PropTime(vtkProp* prop)
+{
+  vtkMTimeType time = prop->GetMTime();
+  if (vtkAlgorithm* mapper = PropMapper(prop))
+  {
+    time = std::max(time, mapper->GetMTime());
+    if (vtkDataObject* input = MapperInput(mapper))
+    {
+      time = std::max(time, input->GetMTime());
+    }
+  }
+  return time;
+}
+
+// Changes when renderers are added or removed, or props added to or removed from them.
+vtkMTimeType CollectionsTime(vtkRendererCollection* renderers)
+{
+  vtkMTimeType time = renderers->GetMTime();
+  vtkCollectionSimpleIterator rit;
+  renderers->InitTraversal(rit);
+  while (vtkRenderer* renderer = renderers->GetNextRenderer(rit))
+  {
+    time = std::max(time, renderer->GetViewProps()->GetMTime());
+  }
+  return time;
+}
+
+// Indices of the primitives vtkOpenGLPolyDataMapper draws for cells with
+// pointsPerPrimitive points, e.g. lines of 2 and triangles of 3.
+std::size_t IndexCount(vtkCellArray* cells, int pointsPerPrimitive)
+{
+  if (!cells)
+  {
+    return 0;
+  }
+  const vtkIdType numberOfCells = cells->GetNumberOfCells();
+#if VTK_MAJOR_VERSION >= 9
+  const vtkIdType numberOfIds = cells->GetNumberOfConnectivityIds();
+#else
+  const vtkIdType numberOfIds = cells->GetNumberOfConnectivityEntries() - numberOfCells;
+#endif
+  // a cell of n points makes n - (pointsPerPrimitive - 1) primitives
+  const vtkIdType primitives = numberOfIds - (pointsPerPrimitive - 1) * numberOfCells;
+  return primitives > 0 ? static_cast<std::size_t>(primitives) * pointsPerPrimitive : 0;
+}
+
+std::size_t PolyDataBuffers(vtkPolyData* polyData, vtkMapper* mapper)
+{
+  const std::size_t points = static_cast<std::size_t>(polyData->GetNumberOfPoints());
+  // positions and normals are uploaded as floats
+  std::size_t bytes = points * 3 * sizeof(float);
+  vtkPointData* pointData = polyData->GetPointData();
+  if (pointData->GetNormals())
+  {
+    bytes += points * 3 * sizeof(float);
+  }
+  if (vtkDataArray* tcoords = pointData->GetTCoords())
+  {
+    bytes += points * tcoords->GetNumberOfComponents() * sizeof(float);
+  }
+  if (mapper && mapper->GetScalarVisibility())
+  {
+    bytes += points * 4; // mapped RGBA colors
+  }
+  const std::size_t indices = IndexCount(polyData->GetVerts(), 1) +
+    IndexCount(polyData->GetLines(), 2) + IndexCount(polyData->GetPolys(), 3) +
+    IndexCount(polyData->GetStrips(), 3);
+  return bytes + indices * sizeof(unsigned int);
+}
+
+std::size_t EstimateBuffers(vtkDataObject* input, vtkMapper* mapper)
+{
+  if (vtkPolyData* polyData = vtkPolyData::SafeDownCast(input))
+  {
+    return PolyDataBuffers(polyData, mapper);
+  }
+  if (vtkCompositeDataSet* composite = vtkCompositeDataSet::SafeDownCast(input))
+  {
+    std::size_t bytes = 0;
+    vtkSmartPointer<vtkCompositeDataIterator> it;
+    it.TakeReference(composite->NewIterator());
+    for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+      bytes += EstimateBuffers(it->GetCurrentDataObject(), mapper);
+    }
+    return bytes;
+  }
+  // other datasets are drawn through their surface, whose points are a bound
+  vtkDataSet* dataSet = vtkDataSet::SafeDownCast(input);
+  return dataSet ? static_cast<std::size_t>(dataSet->GetNumberOfPoints()) * 3 * sizeof(float)
+                 : 0;
+}
+
+std::size_t TextureBytes(vtkTexture* texture)
+{
+  vtkOpenGLTexture* openGLTexture = vtkOpenGLTexture::SafeDownCast(texture);
+  vtkTextureObject* object = openGLTexture ? openGLTexture->GetTextureObject() : nullptr;
+  if (!object || !object->GetHandle())
+  {
+    return 0;
+  }
+  std::size_t bytes = static_cast<std::size_t>(object->GetWidth()) * object->GetHeight() *
+    std::max(1u, object->GetDepth()) * object->GetComponents() *
+    vtkAbstractArray::GetDataTypeSize(object->GetVTKDataType()) * std::max(1, object->GetSamples());
+  if (object->GetTarget() == GL_TEXTURE_CUBE_MAP)
+  {
+    bytes *= 6;
+  }
+  if (object->GetGenerateMipmap())
+  {
+    bytes += bytes / 3;
+  }
+  return bytes;
+}
+
+// vtkOpenGLGPUVolumeRayCastMapper uploads the scalars as a 3D texture.
+std::size_t VolumeTextureBytes(vtkDataObject* input)
+{
+  vtkImageData* image = vtkImageData::SafeDownCast(input);
+  vtkDataArray* scalars = image ? image->GetPointData()->GetScalars() : nullptr;
+  if (!scalars)
+  {
+    return 0;
+  }
+  return static_cast<std::size_t>(scalars->GetNumberOfTuples()) *
+    scalars->GetNumberOfComponents() * scalars->GetDataTypeSize();
+}
+
+// Datasets and buffers of an input shared by several props count once.
+void Accumulate(std::size_t* bytes, const vtkDearImGuiResourceMonitor::PropUsage& usage,
+  std::unordered_set<const void*>& counted)
+{
+  const bool shared = usage.Data && !counted.insert(usage.Data).second;
+  for (int category = 0; category < vtkDearImGuiResourceMonitor::NumberOfCategories; ++category)
+  {
+    if (!shared ||
+      (category != vtkDearImGuiResourceMonitor::Datasets &&
+        category != vtkDearImGuiResourceMonitor::Buffers))
+    {
+      bytes[category] += usage.Bytes[category];
+    }
+  }
+}
+
+// Datasets, buffers, textures and total columns of a table row.
+void UsageColumns(const vtkDearImGuiResourceMonitor::Usage& usage)
+{
+  const int categories[] = { vtkDearImGuiResourceMonitor::Datasets,
+    vtkDearImGuiResourceMonitor::Buffers, vtkDearImGuiResourceMonitor::Textures };
+  for (int category : categories)
+  {
+    vtkDearImGuiTable::NextColumn();
+    ImGui::TextUnformatted(FormatBytes(usage.Bytes[category]).c_str());
+  }
+  vtkDearImGuiTable::NextColumn();
+  ImGui::TextUnformatted(FormatBytes(usage.GetTotal()).c_str());
+}
+}
+
+const char* vtkDearImGuiResourceMonitor::GetCategoryName(int category)
+{
+  return category >= 0 && category < NumberOfCategories ? CategoryNames[category] : "";
+}
+
+std::size_t vtkDearImGuiResourceMonitor::Usage::GetGraphicsBytes() const
+{
+  return this->Bytes[Buffers] + this->Bytes[Textures] + this->Bytes[Framebuffers] +
+    this->Bytes[Programs] + this->Bytes[Overlay];
+}
+
+vtkDearImGuiResourceMonitor::vtkDearImGuiResourceMonitor() = default;
+
+vtkDearImGuiResourceMonitor::~vtkDearImGuiResourceMonitor() = default;
+
+void vtkDearImGuiResourceMonitor::Refresh()
+{
+  this->RefreshRequested = true;
+}
+
+void vtkDearImGuiResourceMonitor::Update(vtkRenderWindow* renderWindow)
+{
+  if (!renderWindow)
+  {
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope("ResourceMonitor", "resources");
+  if (renderWindow != this->RenderWindow)
+  {
+    this->RenderWindow = renderWindow;
+    this->RefreshRequested = true;
+  }
+  const bool refresh = this->RefreshRequested;
+  this->RefreshRequested = false;
+
+  this->NumberOfMeasuredProps = 0;
+  const vtkMTimeType propsTime = CollectionsTime(renderWindow->GetRenderers());
+  const bool rebuild = refresh || propsTime != this->PropsTime;
+  if (rebuild)
+  {
+    this->PropsTime = propsTime;
+    this->Rebuild(renderWindow, refresh);
+  }
+  else
+  {
+    // the collections hold the props, a prop removed or freed would have rebuilt the list
+    for (PropUsage& usage : this->Props)
+    {
+      const vtkMTimeType time = PropTime(usage.Prop);
+      if (time != usage.Time)
+      {
+        usage.Time = time;
+        this->MeasureProp(usage);
+        ++this->NumberOfMeasuredProps;
+      }
+    }
+  }
+  bool modified = rebuild || this->NumberOfMeasuredProps > 0;
+  if (modified)
+  {
+    this->SumRenderers();
+  }
+
+  const int* size = renderWindow->GetSize();
+  if (modified || renderWindow->GetMTime() != this->WindowTime ||
+    size[0] != this->WindowSize[0] || size[1] != this->WindowSize[1])
+  {
+    this->WindowTime = renderWindow->GetMTime();
+    std::copy(size, size + 2, this->WindowSize);
+    this->MeasureWindow(renderWindow);
+    modified = true;
+  }
+  if (modified || this->OverlayModified)
+  {
+    this->OverlayModified = false;
+    this->Total();
+  }
+}
+
+void vtkDearImGuiResourceMonitor::Rebuild(vtkRenderWindow* renderWindow, bool refresh)
+{
+  std::vector<PropUsage> previous;
+  previous.swap(this->Props);
+  std::unordered_map<const vtkProp*, std::size_t> cache;
+  this->Renderers.clear();
+  vtkRendererCollection* renderers = renderWindow->GetRenderers();
+  vtkCollectionSimpleIterator rit;
+  renderers->InitTraversal(rit);
+  int rendererNumber = 0;
+  while (vtkRenderer* renderer = renderers->GetNextRenderer(rit))
+  {
+    RendererUsage rendererUsage;
+    rendererUsage.Renderer = renderer;
+    rendererUsage.Label = Label(renderer, rendererNumber++);
+    vtkPropCollection* props = renderer->GetViewProps();
+    vtkCollectionSimpleIterator pit;
+    props->InitTraversal(pit);
+    int propNumber = 0;
+    while (vtkProp* prop = props->GetNextProp(pit))
+    {
+      const vtkMTimeType time = PropTime(prop);
+      PropUsage usage;
+      auto it = this->Cache.find(prop);
+      // a prop freed and another allocated at its address has a null weak pointer
+      if (!refresh && it != this->Cache.end() && previous[it->second].Prop == prop &&
+        previous[it->second].Time == time)
+      {
+        usage = previous[it->second];
+      }
+      else
+      {
+        usage.Prop = prop;
+        usage.Time = time;
+        this->MeasureProp(usage);
+        ++this->NumberOfMeasuredProps;
+      }
+      usage.Label = Label(prop, propNumber++);
+      usage.Renderer = renderer;
+      usage.RendererLabel = rendererUsage.Label;
+      ++rendererUsage.NumberOfProps;
+      cache[prop] = this->Props.size();
+      this->Props.push_back(usage);
+    }
+    this->Renderers.push_back(rendererUsage);
+  }
+  this->Cache.swap(cache);
+}
+
+void vtkDearImGuiResourceMonitor::MeasureProp(PropUsage& usage)
+{
+  std::fill(usage.Bytes, usage.Bytes + NumberOfCategories, 0);
+  vtkProp* prop = usage.Prop;
+  vtkAlgorithm* mapper = PropMapper(prop);
+  vtkDataObject* input = MapperInput(mapper);
+  usage.Data = input;
+  if (input)
+  {
+    // GetActualMemorySize() is in KiB
+    usage.Bytes[Datasets] = static_cast<std::size_t>(input->GetActualMemorySize()) * 1024;
+  }
+  if (vtkActor* actor = vtkActor::SafeDownCast(prop))
+  {
+    usage.Bytes[Buffers] = EstimateBuffers(input, vtkMapper::SafeDownCast(mapper));
+    vtkTexture* texture = actor->GetTexture();
+    usage.Bytes[Textures] = TextureBytes(texture);
+#if VTK_MAJOR_VERSION >= 9
+    for (const auto& entry : actor->GetProperty()->GetAllTextures())
+    {
+      if (entry.second != texture)
+      {
+        usage.Bytes[Textures] += TextureBytes(entry.second);
+      }
+    }
+#endif
+  }
+  else if (vtkVolume::SafeDownCast(prop))
+  {
+    usage.Bytes[Textures] = VolumeTextureBytes(input);
+  }
+}
+
+void vtkDearImGuiResourceMonitor::MeasureWindow(vtkRenderWindow* renderWindow)
+{
+  std::fill(this->WindowBytes, this->WindowBytes + NumberOfCategories, 0);
+  this->NumberOfPrograms = 0;
+  vtkOpenGLRenderWindow* openGLWindow = vtkOpenGLRenderWindow::SafeDownCast(renderWindow);
+  if (!openGLWindow)
+  {
+    return;
+  }
+  int size[2];
+  if (vtkOpenGLFramebufferObject* framebuffer = openGLWindow->GetRenderFramebuffer())
+  {
+    // RGBA8 color and 32 bit depth of every sample
+    framebuffer->GetLastSize(size);
+    const int samples = std::max(1, openGLWindow->GetMultiSamples());
+    this->WindowBytes[Framebuffers] += static_cast<std::size_t>(size[0]) * size[1] * samples * 8;
+  }
+  if (vtkOpenGLFramebufferObject* framebuffer = openGLWindow->GetDisplayFramebuffer())
+  {
+    // front and back RGBA8 color
+    framebuffer->GetLastSize(size);
+    this->WindowBytes[Framebuffers] += static_cast<std::size_t>(size[0]) * size[1] * 8;
+  }
+
+  // The shader cache keeps its programs to itself, probe the names in use instead.
+  bool binaryLength = true;
+  glGetError(); // an earlier error would read as unsupported
+  for (GLuint name = 1, unused = 0; unused < ProgramProbeGap; ++name)
+  {
+    if (!glIsProgram(name))
+    {
+      ++unused;
+      continue;
+    }
+    unused = 0;
+    ++this->NumberOfPrograms;
+#ifdef GL_PROGRAM_BINARY_LENGTH
+    if (binaryLength)
+    {
+      GLint length = 0;
+      glGetProgramiv(name, GL_PROGRAM_BINARY_LENGTH, &length);
+      // not supported before OpenGL 4.1 and ES 3.0
+      binaryLength = glGetError() == GL_NO_ERROR;
+      this->WindowBytes[Programs] += binaryLength ? static_cast<std::size_t>(length) : 0;
+    }
+#endif
+  }
+  (void)binaryLength;
+}
+
+void vtkDearImGuiResourceMonitor::SetOverlayResource(const char* name, std::size_t bytes)
+{
+  if (!name)
+  {
+    return;
+  }
+  if (bytes)
+  {
+    std::size_t& entry = this->OverlayResources[name];
+    this->OverlayModified = this->OverlayModified || entry != bytes;
+    entry = bytes;
+  }
+  else
+  {
+    this->OverlayModified = this->OverlayResources.erase(name) > 0 || this->OverlayModified;
+  }
+}
+
+void vtkDearImGuiResourceMonitor::SumRenderers()
+{
+  auto usage = this->Props.cbegin();
+  for (RendererUsage& rendererUsage : this->Renderers)
+  {
+    std::fill(rendererUsage.Bytes, rendererUsage.Bytes + NumberOfCategories, 0);
+    std::unordered_set<const void*> counted;
+    for (int i = 0; i < rendererUsage.NumberOfProps; ++i, ++usage)
+    {
+      Accumulate(rendererUsage.Bytes, *usage, counted);
+    }
+  }
+}
+
+void vtkDearImGuiResourceMonitor::Total()
+{
+  std::copy(this->WindowBytes, this->WindowBytes + NumberOfCategories, this->Totals);
+  std::unordered_set<const void*> counted;
+  for (const PropUsage& usage : this->Props)
+  {
+    Accumulate(this->Totals, usage, counted);
+  }
+  for (const auto& entry : this->OverlayResources)
+  {
+    this->Totals[Overlay] += entry.second;
+  }
+}
+
+std::size_t vtkDearImGuiResourceMonitor::GetTotal(int category) const
+{
+  return category >= 0 && category < NumberOfCategories ? this->Totals[category] : 0;
+}
+
+std::size_t vtkDearImGuiResourceMonitor::GetGraphicsTotal() const
+{
+  std::size_t bytes = 0;
+  for (int category = Buffers; category < NumberOfCategories; ++category)
+  {
+    bytes += this->Totals[category];
+  }
+  return bytes;
+}
+
+std::vector<const vtkDearImGuiResourceMonitor::PropUsage*>
+vtkDearImGuiResourceMonitor::GetTopProps(int count) const
+{
+  std::vector<const PropUsage*> props;
+  props.reserve(this->Props.size());
+  for (const PropUsage& usage : this->Props)
+  {
+    props.push_back(&usage);
+  }
+  const std::size_t top = std::min(props.size(), static_cast<std::size_t>(std::max(0, count)));
+  std::partial_sort(props.begin(), props.begin() + top, props.end(),
+    [](const PropUsage* a, const PropUsage* b) { return a->GetTotal() > b->GetTotal(); });
+  props.resize(top);
+  return props;
+}
+
+void vtkDearImGuiResourceMonitor::Draw()
+{
+  if (!this->RenderWindow)
+  {
+    ImGui::TextDisabled("Nothing measured yet");
+    return;
+  }
+  if (ImGui::SmallButton("Refresh"))
+  {
+    this->Refresh();
+  }
+  ImGui::SameLine();
+  ImGui::TextDisabled("%d of %d props measured again", this->NumberOfMeasuredProps,
+    static_cast<int>(this->Props.size()));
+  ImGui::Text("CPU %s, GPU %s", FormatBytes(this->Totals[Datasets]).c_str(),
+    FormatBytes(this->GetGraphicsTotal()).c_str());
+
+  if (vtkDearImGuiTable::Begin("##totals", 2))
+  {
+    for (int category = 0; category < NumberOfCategories; ++category)
+    {
+      vtkDearImGuiTable::NextRow();
+      vtkDearImGuiTable::NextColumn();
+      ImGui::TextUnformatted(CategoryNames[category]);
+      if (category == Programs)
+      {
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%d)", this->NumberOfPrograms);
+      }
+      vtkDearImGuiTable::NextColumn();
+      ImGui::TextUnformatted(FormatBytes(this->Totals[category]).c_str());
+    }
+    vtkDearImGuiTable::End();
+  }
+
+  if (ImGui::CollapsingHeader("Renderers", ImGuiTreeNodeFlags_DefaultOpen) &&
+    vtkDearImGuiTable::Begin("##renderers", 6))
+  {
+    vtkDearImGuiTable::SetupColumn("Renderer", 1.f);
+    vtkDearImGuiTable::SetupColumn("Props", 0.4f);
+    vtkDearImGuiTable::SetupColumn("Datasets", 0.6f);
+    vtkDearImGuiTable::SetupColumn("Buffers", 0.6f);
+    vtkDearImGuiTable::SetupColumn("Textures", 0.6f);
+    vtkDearImGuiTable::SetupColumn("Total", 0.6f);
+    vtkDearImGuiTable::HeadersRow();
+    for (const RendererUsage& usage : this->Renderers)
+    {
+      vtkDearImGuiTable::NextRow();
+      vtkDearImGuiTable::NextColumn();
+      ImGui::TextUnformatted(usage.Label.c_str());
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%d", usage.NumberOfProps);
+      UsageColumns(usage);
+    }
+    vtkDearImGuiTable::End();
+  }
+
+  if (ImGui::CollapsingHeader("Top props", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    ImGui::SliderInt("Count", &this->NumberOfTopProps, 1, 100);
+    if (vtkDearImGuiTable::Begin("##props", 6))
+    {
+      vtkDearImGuiTable::SetupColumn("Prop", 1.f);
+      vtkDearImGuiTable::SetupColumn("Renderer", 0.8f);
+      vtkDearImGuiTable::SetupColumn("Datasets", 0.6f);
+      vtkDearImGuiTable::SetupColumn("Buffers", 0.6f);
+      vtkDearImGuiTable::SetupColumn("Textures", 0.6f);
+      vtkDearImGuiTable::SetupColumn("Total", 0.6f);
+      vtkDearImGuiTable::HeadersRow();
+      for (const PropUsage* usage : this->GetTopProps(this->NumberOfTopProps))
+      {
+        vtkDearImGuiTable::NextRow();
+        vtkDearImGuiTable::NextColumn();
+        ImGui::TextUnformatted(usage->Label.c_str());
+        vtkDearImGuiTable::NextColumn();
+        ImGui::TextUnformatted(usage->RendererLabel.c_str());
+        UsageColumns(*usage);
+      }
+      vtkDearImGuiTable::End();
+    }
+  }
+
+  if (ImGui::CollapsingHeader("Overlay") && vtkDearImGuiTable::Begin("##overlay", 2))
+  {
+    for (const auto& entry : this->OverlayResources)
+    {
+      vtkDearImGuiTable::NextRow();
+      vtkDearImGuiTable::NextColumn();
+      ImGui::TextUnformatted(entry.first.c_str());
+      vtkDearImGuiTable::NextColumn();
+      ImGui::TextUnformatted(FormatBytes(entry.second).c_str());
+    }
+    vtkDearImGuiTable::End();
+  }
+  ImGui::TextDisabled("Buffers and framebuffers are estimated from the data and window size.");
+}
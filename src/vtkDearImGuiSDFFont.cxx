@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include <vtkDearImGuiSDFFont.h>
+
+#include <vtkObjectFactory.h>
+#include <vtk_glew.h>
+
+#include "imgui.h"
+
+// A private copy, imgui_draw.cpp compiles its own static one.
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imstb_truetype.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiSDFFont);
+
+namespace
+{
+// Basic Latin and Latin-1 Supplement
+const unsigned int DefaultRanges[] = { 0x0020, 0x00FF, 0 };
+// the TTF itself only provides the space, every other glyph is a distance field
+const ImWchar SpaceRange[] = { 0x0020, 0x0020, 0 };
+
+#if defined(IMGUI_IMPL_OPENGL_ES3) || defined(GL_ES_VERSION_3_0)
+const char* ShaderVersion = "#version 300 es\nprecision mediump float;\n";
+#else
+const char* ShaderVersion = "#version 150\n";
+#endif
+
+// Same inputs as the backend's shader, the backend's vertex array stays bound.
+const char* VertexShader = "uniform mat4 ProjMtx;\n"
+                           "in vec2 Position;\n"
+                           "in vec2 UV;\n"
+                           "in vec4 Color;\n"
+                           "out vec2 Frag_UV;\n"
+                           "out vec4 Frag_Color;\n"
+                           "void main()\n"
+                           "{\n"
+                           "  Frag_UV = UV;\n"
+                           "  Frag_Color = Color;\n"
+                           "  gl_Position = ProjMtx * vec4(Position.xy, 0, 1);\n"
+                           "}\n";
+
+// The outline is at 0.5, fwidth keeps the edge about a pixel wide at any scale. The
+// opaque texels of the atlas, e.g. the white pixel, stay opaque.
+const char* FragmentShader =
+  "uniform sampler2D Texture;\n"
+  "in vec2 Frag_UV;\n"
+  "in vec4 Frag_Color;\n"
+  "out vec4 Out_Color;\n"
+  "void main()\n"
+  "{\n"
+  "  float distance = texture(Texture, Frag_UV.st).a;\n"
+  "  float width = max(0.7 * fwidth(distance), 1e-4);\n"
+  "  float alpha = smoothstep(0.5 - width, 0.5 + width, distance);\n"
+  "  Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * alpha);\n"
+  "}\n";
+
+GLuint CompileShader(GLenum type, const char* source, std::string& log)
+{
+  const GLuint shader = glCreateShader(type);
+  const GLchar* sources[] = { ShaderVersion, source };
+  glShaderSource(shader, 2, sources, nullptr);
+  glCompileShader(shader);
+  GLint status = 0;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (!status)
+  {
+    GLchar message[1024];
+    glGetShaderInfoLog(shader, sizeof(message), nullptr, message);
+    log = message;
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+}
+
+vtkDearImGuiSDFFont::vtkDearImGuiSDFFont()
+{
+  std::fill(this->Projection, this->Projection + 16, 0.f);
+}
+
+vtkDearImGuiSDFFont::~vtkDearImGuiSDFFont() = default;
+
+ImFont* vtkDearImGuiSDFFont::AddFontFromMemoryTTF(
+  ImFontAtlas* atlas, const void* data, int size, const unsigned int* ranges)
+{
+  stbtt_fontinfo info;
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  if (!atlas || !bytes || size <= 0 ||
+    !stbtt_InitFont(&info, bytes, stbtt_GetFontOffsetForIndex(bytes, 0)))
+  {
+    vtkErrorMacro(<< "Not a TrueType font");
+    return nullptr;
+  }
+  Font font;
+  font.Data.assign(bytes, bytes + size);
+  stbtt_InitFont(&info, font.Data.data(), stbtt_GetFontOffsetForIndex(font.Data.data(), 0));
+
+  ImFontConfig config;
+  config.FontDataOwnedByAtlas = false;
+  std::snprintf(config.Name, sizeof(config.Name), "SDF %d, %.0fpx",
+    static_cast<int>(this->Fonts.size()), this->BaseSize);
+  font.Handle = atlas->AddFontFromMemoryTTF(
+    font.Data.data(), size, this->BaseSize, &config, SpaceRange);
+
+  // glyph boxes relative to the line top, as ImGui places its own glyphs
+  const float scale = stbtt_ScaleForPixelHeight(&info, this->BaseSize);
+  int ascent, descent, lineGap;
+  stbtt_GetFontVMetrics(&info, &ascent, &descent, &lineGap);
+  const float top = std::floor(ascent * scale + (ascent > 0 ? 1.f : -1.f));
+  const unsigned char onEdge = 128;
+  const float distanceScale = static_cast<float>(onEdge) / this->Spread;
+  for (const unsigned int* range = ranges ? ranges : DefaultRanges; range[0] && range[1];
+       range += 2)
+  {
+    for (unsigned int codepoint = range[0]; codepoint <= range[1]; ++codepoint)
+    {
+      const int index = stbtt_FindGlyphIndex(&info, static_cast<int>(codepoint));
+      if (codepoint == 0x20 || codepoint > IM_UNICODE_CODEPOINT_MAX || !index)
+      {
+        continue; // missing glyphs fall back to ImGui's
+      }
+      int advance, bearing;
+      stbtt_GetGlyphHMetrics(&info, index, &advance, &bearing);
+      Glyph glyph;
+      int x = 0, y = 0;
+      unsigned char* distances = stbtt_GetGlyphSDF(&info, scale, index, this->Spread, onEdge,
+        distanceScale, &glyph.Width, &glyph.Height, &x, &y);
+      if (distances)
+      {
+        glyph.Distances.assign(distances, distances + glyph.Width * glyph.Height);
+        stbtt_FreeSDF(distances, nullptr);
+      }
+      else
+      {
+        // no outline, e.g. a non-breaking space
+        glyph.Width = glyph.Height = 1;
+        glyph.Distances.assign(1, 0);
+        x = y = 0;
+      }
+      glyph.Rect = atlas->AddCustomRectFontGlyph(font.Handle, static_cast<ImWchar>(codepoint),
+        glyph.Width, glyph.Height, advance * scale, ImVec2(x, top + y));
+      font.Glyphs.push_back(std::move(glyph));
+    }
+  }
+  font.Handle->Scale = this->Size / this->BaseSize;
+  ImFont* handle = font.Handle;
+  this->Fonts.push_back(std::move(font));
+  this->Modified();
+  return handle;
+}
+
+ImFont* vtkDearImGuiSDFFont::AddFontFromFileTTF(
+  ImFontAtlas* atlas, const char* fileName, const unsigned int* ranges)
+{
+  std::ifstream file(fileName ? fileName : "", std::ios::binary);
+  if (!file)
+  {
+    vtkErrorMacro(<< "Cannot open " << (fileName ? fileName : "(null)"));
+    return nullptr;
+  }
+  const std::vector<char> data(
+    (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return this->AddFontFromMemoryTTF(atlas, data.data(), static_cast<int>(data.size()), ranges);
+}
+
+bool vtkDearImGuiSDFFont::Build(ImFontAtlas* atlas)
+{
+  if (this->Fonts.empty())
+  {
+    return true;
+  }
+#if IMGUI_VERSION_NUM >= 17600
+  // baked lines are coverage, not distances
+  atlas->Flags |= ImFontAtlasFlags_NoBakedLines;
+#endif
+  atlas->ClearTexData();
+  if (!atlas->Build())
+  {
+    return false;
+  }
+  unsigned char* pixels = nullptr;
+  int width = 0, height = 0;
+  atlas->GetTexDataAsAlpha8(&pixels, &width, &height);
+  for (Font& font : this->Fonts)
+  {
+    for (const Glyph& glyph : font.Glyphs)
+    {
+      const ImFontAtlasCustomRect* rect = atlas->GetCustomRectByIndex(glyph.Rect);
+      for (int y = 0; y < glyph.Height; ++y)
+      {
+        std::memcpy(pixels + (rect->Y + y) * width + rect->X,
+          glyph.Distances.data() + y * glyph.Width, glyph.Width);
+      }
+    }
+    font.Handle->Scale = this->Size / this->BaseSize;
+  }
+  return true;
+}
+
+void vtkDearImGuiSDFFont::SetSize(float pixels)
+{
+  if (pixels <= 0.f || pixels == this->Size)
+  {
+    return;
+  }
+  this->Size = pixels;
+  for (Font& font : this->Fonts)
+  {
+    font.Handle->Scale = this->Size / this->BaseSize;
+  }
+  this->Modified();
+}
+
+void vtkDearImGuiSDFFont::Prepare(ImDrawData* drawData)
+{
+  if (this->Fonts.empty() || !drawData)
+  {
+    return;
+  }
+  // the backend's orthographic projection
+  const float left = drawData->DisplayPos.x;
+  const float right = left + drawData->DisplaySize.x;
+  const float top = drawData->DisplayPos.y;
+  const float bottom = top + drawData->DisplaySize.y;
+  const float projection[16] = { 2.f / (right - left), 0.f, 0.f, 0.f, 0.f,
+    2.f / (top - bottom), 0.f, 0.f, 0.f, 0.f, -1.f, 0.f, (right + left) / (left - right),
+    (top + bottom) / (bottom - top), 0.f, 1.f };
+  std::copy(projection, projection + 16, this->Projection);
+
+  const ImTextureID atlas = ImGui::GetIO().Fonts->TexID;
+  ImVector<ImDrawCmd> commands;
+  for (int n = 0; n < drawData->CmdListsCount; ++n)
+  {
+    ImDrawList* list = drawData->CmdLists[n];
+    commands.resize(0);
+    commands.reserve(list->CmdBuffer.Size + 2);
+    // program in use: 0 the backend's, 1 ours, -1 unknown after a user callback
+    int program = 0;
+    for (const ImDrawCmd& cmd : list->CmdBuffer)
+    {
+      if (cmd.UserCallback)
+      {
+        commands.push_back(cmd);
+        program = cmd.UserCallback == ImDrawCallback_ResetRenderState ? 0 : -1;
+        continue;
+      }
+      const int wanted = cmd.TextureId == atlas ? 1 : 0;
+      if (wanted != program)
+      {
+        ImDrawCmd change = cmd;
+        change.ElemCount = 0;
+        change.UserCallback = wanted ? &vtkDearImGuiSDFFont::UseProgram
+                                     : ImDrawCallback_ResetRenderState;
+        change.UserCallbackData = this;
+        commands.push_back(change);
+        program = wanted;
+      }
+      commands.push_back(cmd);
+    }
+    list->CmdBuffer.swap(commands);
+  }
+}
+
+void vtkDearImGuiSDFFont::UseProgram(const ImDrawList* list, const ImDrawCmd* cmd)
+{
+  auto self = static_cast<vtkDearImGuiSDFFont*>(cmd->UserCallbackData);
+  if (!self->Program && (self->ProgramFailed || !self->CreateProgram()))
+  {
+    return; // the backend's shader draws the field blurred
+  }
+  glUseProgram(self->Program);
+  glUniformMatrix4fv(self->ProjectionLocation, 1, GL_FALSE, self->Projection);
+  glUniform1i(self->TextureLocation, 0);
+}
+
+bool vtkDearImGuiSDFFont::CreateProgram()
+{
+  std::string log;
+  const GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, VertexShader, log);
+  const GLuint fragmentShader =
+    vertexShader ? CompileShader(GL_FRAGMENT_SHADER, FragmentShader, log) : 0;
+  if (!fragmentShader)
+  {
+    if (vertexShader)
+    {
+      glDeleteShader(vertexShader);
+    }
+    vtkErrorMacro(<< "Distance field shader: " << log);
+    this->ProgramFailed = true;
+    return false;
+  }
+  const GLuint program = glCreateProgram();
+  glAttachShader(program, vertexShader);
+  glAttachShader(program, fragmentShader);
+  // called while the backend's program is bound, match its attribute locations
+  GLint current = 0;
+  glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+  const char* attributes[] = { "Position", "UV", "Color" };
+  for (const char* attribute : attributes)
+  {
+    const GLint location = current ? glGetAttribLocation(current, attribute) : -1;
+    if (location >= 0)
+    {
+      glBindAttribLocation(program, location, attribute);
+    }
+  }
+  glLinkProgram(program);
+  glDetachShader(program, vertexShader);
+  glDetachShader(program, fragmentShader);
+  glDeleteShader(vertexShader);
+  glDeleteShader(fragmentShader);
+  GLint status = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if (!status)
+  {
+    GLchar message[1024];
+    glGetProgramInfoLog(program, sizeof(message), nullptr, message);
+    vtkErrorMacro(<< "Distance field program: " << message);
+    glDeleteProgram(program);
+    this->ProgramFailed = true;
+    return false;
+  }
+  this->Program = program;
+  this->ProjectionLocation = glGetUniformLocation(program, "ProjMtx");
+  this->TextureLocation = glGetUniformLocation(program, "Texture");
+  return true;
+}
+
+void vtkDearImGuiSDFFont::ReleaseGraphicsResources()
+{
+  if (this->Program)
+  {
+    glDeleteProgram(this->Program);
+    this->Program = 0;
+  }
+  this->ProgramFailed = false;
+}
@@ -0,0 +1,551 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <vtkDearImGuiSMPPanel.h>
+#include <vtkDearImGuiTable.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkElevationFilter.h>
+#include <vtkFlyingEdges3D.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPlaneCutter.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkRTAnalyticSource.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+#include <vtkVersionMacros.h>
+
+#include "imgui.h"
+
+// vtkSMPTools::SetBackend() came with VTK 9.1
+#if VTK_MAJOR_VERSION > 9 || (VTK_MAJOR_VERSION == 9 && VTK_MINOR_VERSION >= 1)
+#define SMP_PANEL_RUNTIME_BACKEND 1
+#include <vtkSMP.h>
+#endif
+
+// Without threads (WebAssembly built with USE_PTHREADS=0) configurations run in Step().
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define SMP_PANEL_NO_THREADS 1
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiSMPPanel);
+
+namespace
+{
+const char* FilterNames[] = { "Contour", "Cut", "Elevation", "Normals" };
+
+double Now()
+{
+  using namespace std::chrono;
+  return duration_cast<duration<double>>(steady_clock::now().time_since_epoch()).count();
+}
+
+int GetNumberOfCores()
+{
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+}
+
+struct vtkDearImGuiSMPPanel::vtkInternals
+{
+  // queued configurations, UI thread
+  std::vector<Configuration> Queue;
+  std::size_t Next = 0;
+  Configuration Saved;
+  bool Running = false;
+  bool Busy = false; // a worker started and was not collected yet
+  PostFunction Post;
+
+  // the configuration being timed, owned by the worker until Done
+  Timing Current;
+  int Repetitions = 1;
+  std::thread Worker;
+  std::atomic<int> Filter{ 0 }; // filters timed so far
+  std::atomic<bool> Done{ false };
+  std::atomic<bool> CancelRequested{ false };
+
+  // inputs, rebuilt when the resolution changes, worker only
+  vtkSmartPointer<vtkImageData> Image;
+  vtkSmartPointer<vtkPolyData> Surface;
+  int ImageResolution = 0;
+  double ContourValue = 0.;
+
+  void Prepare(int resolution);
+  double Time(int filter, int repetitions);
+  // Time Current on a worker.
+  void Start();
+  void RunConfiguration();
+  void Join();
+};
+
+void vtkDearImGuiSMPPanel::vtkInternals::Prepare(int resolution)
+{
+  if (this->Image && this->ImageResolution == resolution)
+  {
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope("PrepareSMPBenchmark", "smp");
+  const int half = resolution / 2;
+  vtkNew<vtkRTAnalyticSource> source;
+  source->SetWholeExtent(-half, resolution - half - 1, -half, resolution - half - 1, -half,
+    resolution - half - 1);
+  source->Update();
+  this->Image = source->GetOutput();
+  double range[2];
+  this->Image->GetPointData()->GetScalars()->GetRange(range);
+  this->ContourValue = 0.5 * (range[0] + range[1]);
+
+  vtkNew<vtkFlyingEdges3D> contour;
+  contour->SetInputData(this->Image);
+  contour->SetValue(0, this->ContourValue);
+  contour->ComputeNormalsOff();
+  contour->Update();
+  this->Surface = contour->GetOutput();
+  this->ImageResolution = resolution;
+}
+
+double vtkDearImGuiSMPPanel::vtkInternals::Time(int filter, int repetitions)
+{
+  vtkDearImGuiTracer::Scope scope(FilterNames[filter], "smp");
+  double best = -1.;
+  for (int i = 0; i < repetitions && !this->CancelRequested.load(); ++i)
+  {
+    // a new filter each time, nothing is cached from the previous run
+    vtkSmartPointer<vtkAlgorithm> algorithm;
+    if (filter == Contour)
+    {
+      auto contour = vtkSmartPointer<vtkFlyingEdges3D>::New();
+      contour->SetInputData(this->Image);
+      contour->SetValue(0, this->ContourValue);
+      algorithm = contour;
+    }
+    else if (filter == Cut)
+    {
+      vtkNew<vtkPlane> plane;
+      plane->SetOrigin(this->Image->GetCenter());
+      plane->SetNormal(1., 1., 1.);
+      auto cutter = vtkSmartPointer<vtkPlaneCutter>::New();
+      cutter->SetInputData(this->Image);
+      cutter->SetPlane(plane);
+      algorithm = cutter;
+    }
+    else if (filter == Elevation)
+    {
+      const double* bounds = this->Image->GetBounds();
+      auto elevation = vtkSmartPointer<vtkElevationFilter>::New();
+      elevation->SetInputData(this->Image);
+      elevation->SetLowPoint(bounds[0], bounds[2], bounds[4]);
+      elevation->SetHighPoint(bounds[1], bounds[3], bounds[5]);
+      algorithm = elevation;
+    }
+    else
+    {
+      auto normals = vtkSmartPointer<vtkPolyDataNormals>::New();
+      normals->SetInputData(this->Surface);
+      algorithm = normals;
+    }
+    const double begin = Now();
+    algorithm->Update();
+    const double seconds = Now() - begin;
+    best = best < 0. ? seconds : std::min(best, seconds);
+  }
+  return best;
+}
+
+void vtkDearImGuiSMPPanel::vtkInternals::Start()
+{
+  this->Filter.store(0);
+  this->Done.store(false);
+  this->Busy = true;
+#ifdef SMP_PANEL_NO_THREADS
+  this->RunConfiguration();
+#else
+  this->Worker = std::thread(
+    [this]()
+    {
+      vtkDearImGuiTracer::SetThreadName("vtkDearImGuiSMPPanel");
+      this->RunConfiguration();
+    });
+#endif
+}
+
+void vtkDearImGuiSMPPanel::vtkInternals::RunConfiguration()
+{
+  this->Prepare(this->Current.Resolution);
+  for (int filter = 0; filter < NumberOfFilters && !this->CancelRequested.load(); ++filter)
+  {
+    const double seconds = this->Time(filter, this->Repetitions);
+    this->Current.Seconds[filter] = seconds;
+    this->Current.Total += seconds;
+    this->Filter.store(filter + 1);
+    if (this->Post)
+    {
+      // an empty command wakes the event loop to redraw the progress
+      this->Post([]() {});
+    }
+  }
+  this->Done.store(true);
+  // Step() only collects the timings once the loop wakes up, wait for room in the queue
+  while (this->Post && !this->Post([]() {}) && !this->CancelRequested.load())
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void vtkDearImGuiSMPPanel::vtkInternals::Join()
+{
+  if (this->Worker.joinable())
+  {
+    this->Worker.join();
+  }
+  this->Busy = false;
+}
+
+vtkDearImGuiSMPPanel::vtkDearImGuiSMPPanel()
+  : Internals(new vtkInternals())
+{
+}
+
+vtkDearImGuiSMPPanel::~vtkDearImGuiSMPPanel()
+{
+  this->Internals->CancelRequested.store(true);
+  this->Internals->Join();
+}
+
+void vtkDearImGuiSMPPanel::SetPostFunction(PostFunction post)
+{
+  this->Internals->Post = std::move(post);
+}
+
+const char* vtkDearImGuiSMPPanel::GetFilterName(int filter)
+{
+  return filter >= 0 && filter < NumberOfFilters ? FilterNames[filter] : "";
+}
+
+std::vector<std::string> vtkDearImGuiSMPPanel::GetAvailableBackends()
+{
+  std::vector<std::string> backends;
+#ifdef SMP_PANEL_RUNTIME_BACKEND
+#if VTK_SMP_ENABLE_SEQUENTIAL
+  backends.emplace_back("Sequential");
+#endif
+#if VTK_SMP_ENABLE_STDTHREAD
+  backends.emplace_back("STDThread");
+#endif
+#if VTK_SMP_ENABLE_TBB
+  backends.emplace_back("TBB");
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+  backends.emplace_back("OpenMP");
+#endif
+#endif
+  if (backends.empty())
+  {
+    // only the one VTK was built with
+    backends.push_back(GetBackend());
+  }
+  return backends;
+}
+
+std::string vtkDearImGuiSMPPanel::GetBackend()
+{
+#ifdef SMP_PANEL_RUNTIME_BACKEND
+  const char* backend = vtkSMPTools::GetBackend();
+  return backend ? backend : "";
+#else
+  return "Default";
+#endif
+}
+
+bool vtkDearImGuiSMPPanel::SetBackend(const char* name)
+{
+  if (!name || !name[0])
+  {
+    return false;
+  }
+  if (GetBackend() == name)
+  {
+    return true;
+  }
+#ifdef SMP_PANEL_RUNTIME_BACKEND
+  if (!vtkSMPTools::SetBackend(name))
+  {
+    vtkWarningMacro(<< "SMP backend " << name << " is not available");
+    return false;
+  }
+  // a new backend starts with its default number of threads
+  vtkSMPTools::Initialize(this->NumberOfThreads);
+  this->Modified();
+  return true;
+#else
+  vtkWarningMacro(<< "Changing the SMP backend needs VTK 9.1 or later");
+  return false;
+#endif
+}
+
+void vtkDearImGuiSMPPanel::SetNumberOfThreads(int numberOfThreads)
+{
+  numberOfThreads = std::max(0, numberOfThreads);
+  if (numberOfThreads == this->NumberOfThreads)
+  {
+    return;
+  }
+  this->NumberOfThreads = numberOfThreads;
+  vtkSMPTools::Initialize(numberOfThreads);
+  this->Modified();
+}
+
+int vtkDearImGuiSMPPanel::GetEstimatedNumberOfThreads()
+{
+  return vtkSMPTools::GetEstimatedNumberOfThreads();
+}
+
+void vtkDearImGuiSMPPanel::Apply(const Configuration& configuration)
+{
+  if (!configuration.Backend.empty())
+  {
+    this->SetBackend(configuration.Backend.c_str());
+  }
+  this->SetNumberOfThreads(configuration.NumberOfThreads);
+}
+
+bool vtkDearImGuiSMPPanel::Run(const std::vector<Configuration>& configurations)
+{
+  vtkInternals& internals = *this->Internals;
+  if (internals.Running || configurations.empty())
+  {
+    return false;
+  }
+  internals.Queue = configurations;
+  internals.Next = 0;
+  internals.CancelRequested.store(false);
+  internals.Saved.Backend = GetBackend();
+  internals.Saved.NumberOfThreads = this->NumberOfThreads;
+  internals.Running = true;
+  return true;
+}
+
+bool vtkDearImGuiSMPPanel::RunSweep()
+{
+  const int cores = GetNumberOfCores();
+  std::vector<int> counts;
+  for (int threads = 1; threads < cores; threads *= 2)
+  {
+    counts.push_back(threads);
+  }
+  counts.push_back(cores);
+  std::vector<Configuration> configurations;
+  for (const std::string& backend : GetAvailableBackends())
+  {
+    for (int threads : counts)
+    {
+      Configuration configuration;
+      configuration.Backend = backend;
+      configuration.NumberOfThreads = threads;
+      configurations.push_back(configuration);
+      if (backend == "Sequential")
+      {
+        break;
+      }
+    }
+  }
+  return this->Run(configurations);
+}
+
+void vtkDearImGuiSMPPanel::Cancel()
+{
+  vtkInternals& internals = *this->Internals;
+  if (!internals.Running)
+  {
+    return;
+  }
+  if (internals.Busy)
+  {
+    // the configuration is restored once the worker stopped, see Step()
+    internals.CancelRequested.store(true);
+    return;
+  }
+  this->Finish();
+}
+
+void vtkDearImGuiSMPPanel::Finish()
+{
+  vtkInternals& internals = *this->Internals;
+  internals.Running = false;
+  internals.Queue.clear();
+  this->Apply(internals.Saved);
+}
+
+bool vtkDearImGuiSMPPanel::IsRunning() const
+{
+  return this->Internals->Running;
+}
+
+double vtkDearImGuiSMPPanel::GetProgress() const
+{
+  const vtkInternals& internals = *this->Internals;
+  if (!internals.Running)
+  {
+    return 1.;
+  }
+  const double done =
+    static_cast<double>(internals.Next * NumberOfFilters + internals.Filter.load());
+  return done / static_cast<double>(internals.Queue.size() * NumberOfFilters);
+}
+
+bool vtkDearImGuiSMPPanel::Step()
+{
+  vtkInternals& internals = *this->Internals;
+  if (!internals.Running)
+  {
+    return false;
+  }
+  if (internals.Busy)
+  {
+    if (!internals.Done.load())
+    {
+      // without a post function nothing wakes the loop when the worker is done
+      return !internals.Post;
+    }
+    internals.Join();
+    if (internals.CancelRequested.load())
+    {
+      this->Finish();
+      return true;
+    }
+    this->Timings.push_back(internals.Current);
+    if (++internals.Next == internals.Queue.size())
+    {
+      this->Finish();
+      return true;
+    }
+  }
+  // no benchmark runs while the backend changes
+  this->Apply(internals.Queue[internals.Next]);
+  internals.Current = Timing();
+  internals.Current.Setup.Backend = GetBackend();
+  internals.Current.Setup.NumberOfThreads = GetEstimatedNumberOfThreads();
+  internals.Current.Resolution = this->Resolution;
+  internals.Repetitions = this->Repetitions;
+  internals.Start();
+  return true;
+}
+
+void vtkDearImGuiSMPPanel::Draw()
+{
+  vtkInternals& internals = *this->Internals;
+  const std::vector<std::string> backends = GetAvailableBackends();
+  const std::string current = GetBackend();
+  ImGui::Text("%s, %d threads", current.c_str(), GetEstimatedNumberOfThreads());
+
+  if (internals.Running)
+  {
+    // the configuration belongs to the benchmark until it ends
+    ImGui::ProgressBar(static_cast<float>(this->GetProgress()), ImVec2(-80.f, 0.f));
+    ImGui::SameLine();
+    if (ImGui::Button("Cancel"))
+    {
+      this->Cancel();
+    }
+  }
+  else
+  {
+    if (ImGui::BeginCombo("Backend", current.c_str()))
+    {
+      for (const std::string& backend : backends)
+      {
+        if (ImGui::Selectable(backend.c_str(), backend == current) && backend != current)
+        {
+          this->SetBackend(backend.c_str());
+        }
+      }
+      ImGui::EndCombo();
+    }
+    int threads = this->NumberOfThreads;
+    if (ImGui::SliderInt(
+          "Threads", &threads, 0, GetNumberOfCores(), threads == 0 ? "all cores" : "%d"))
+    {
+      this->SetNumberOfThreads(threads);
+    }
+    int resolution = this->Resolution;
+    if (ImGui::SliderInt("Resolution", &resolution, 16, 512, "%d^3 points"))
+    {
+      this->SetResolution(resolution);
+    }
+    int repetitions = this->Repetitions;
+    if (ImGui::SliderInt("Repetitions", &repetitions, 1, 10, "best of %d"))
+    {
+      this->SetRepetitions(repetitions);
+    }
+    if (ImGui::Button("Run"))
+    {
+      Configuration configuration;
+      configuration.Backend = current;
+      configuration.NumberOfThreads = this->NumberOfThreads;
+      this->Run({ configuration });
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Sweep"))
+    {
+      this->RunSweep();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear"))
+    {
+      this->ClearTimings();
+    }
+  }
+
+  if (this->Timings.empty())
+  {
+    return;
+  }
+  const int flags = vtkDearImGuiTable::RowBackground | vtkDearImGuiTable::ScrollY;
+  if (!vtkDearImGuiTable::Begin("##timings", 4 + NumberOfFilters, flags))
+  {
+    return;
+  }
+  vtkDearImGuiTable::SetupColumn("Backend", 0.8f);
+  vtkDearImGuiTable::SetupColumn("Threads", 0.5f);
+  vtkDearImGuiTable::SetupColumn("Points", 0.5f);
+  for (const char* name : FilterNames)
+  {
+    vtkDearImGuiTable::SetupColumn(name, 0.6f);
+  }
+  vtkDearImGuiTable::SetupColumn("Total ms", 0.6f);
+  vtkDearImGuiTable::HeadersRow();
+  auto fastest = std::min_element(this->Timings.begin(), this->Timings.end(),
+    [](const Timing& a, const Timing& b) { return a.Total < b.Total; });
+  for (const Timing& timing : this->Timings)
+  {
+    vtkDearImGuiTable::NextRow();
+    vtkDearImGuiTable::NextColumn();
+    ImGui::TextUnformatted(timing.Setup.Backend.c_str());
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%d", timing.Setup.NumberOfThreads);
+    vtkDearImGuiTable::NextColumn();
+    ImGui::Text("%d^3", timing.Resolution);
+    for (double seconds : timing.Seconds)
+    {
+      vtkDearImGuiTable::NextColumn();
+      ImGui::Text("%.1f", seconds * 1000.);
+    }
+    vtkDearImGuiTable::NextColumn();
+    if (&timing == &*fastest)
+    {
+      ImGui::TextColored(ImVec4(0.3f, 0.9f, 0.3f, 1.f), "%.1f", timing.Total * 1000.);
+    }
+    else
+    {
+      ImGui::Text("%.1f", timing.Total * 1000.);
+    }
+  }
+  vtkDearImGuiTable::End();
+}
@@ -0,0 +1,355 @@
+#include <chrono>
+#include <cstring>
+
+#include <vtkDearImGuiSharedMemoryPublisher.h>
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkObjectFactory.h>
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+#define SHARED_MEMORY_UNSUPPORTED 1
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiSharedMemoryPublisher);
+
+namespace
+{
+using InputEvent = vtkDearImGuiRemoteProtocol::InputEvent;
+using Layout = vtkDearImGuiSharedMemoryPublisher::Layout;
+using RingHeader = vtkDearImGuiSharedMemoryPublisher::RingHeader;
+using SlotHeader = vtkDearImGuiSharedMemoryPublisher::SlotHeader;
+
+const std::uint32_t InputCapacity = 256;
+
+std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+{
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+InputEvent* InputQueue(RingHeader* header)
+{
+  return reinterpret_cast<InputEvent*>(
+    reinterpret_cast<unsigned char*>(header) + AlignUp(sizeof(RingHeader), 64));
+}
+
+SlotHeader* Slot(RingHeader* header, const Layout& layout, std::uint64_t sequence)
+{
+  return reinterpret_cast<SlotHeader*>(reinterpret_cast<unsigned char*>(header) +
+    layout.SlotsOffset + (sequence % layout.NumberOfSlots) * layout.SlotSize);
+}
+
+Layout GetLayout(const RingHeader& header)
+{
+  Layout layout;
+  layout.NumberOfSlots = header.NumberOfSlots;
+  layout.InputCapacity = header.InputCapacity;
+  layout.SlotSize = header.SlotSize;
+  layout.SlotsOffset = header.SlotsOffset;
+  return layout;
+}
+
+// Whether the slots and the input queue of a segment someone else wrote fit in size
+// bytes, without overflowing.
+bool IsValidLayout(const Layout& layout, std::uint64_t size)
+{
+  const std::uint64_t inputEnd = AlignUp(sizeof(RingHeader), 64) +
+    static_cast<std::uint64_t>(layout.InputCapacity) * sizeof(InputEvent);
+  return layout.NumberOfSlots > 0 && layout.InputCapacity > 0 &&
+    layout.SlotSize >= vtkDearImGuiSharedMemoryPublisher::PixelOffset &&
+    layout.SlotSize % 8 == 0 && layout.SlotsOffset % 8 == 0 && inputEnd <= layout.SlotsOffset &&
+    layout.SlotsOffset <= size &&
+    layout.SlotSize <= (size - layout.SlotsOffset) / layout.NumberOfSlots;
+}
+
+#ifndef SHARED_MEMORY_UNSUPPORTED
+void* Map(int fd, std::size_t size)
+{
+  void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  return address == MAP_FAILED ? nullptr : address;
+}
+#endif
+}
+
+vtkDearImGuiSharedMemoryPublisher::vtkDearImGuiSharedMemoryPublisher() = default;
+
+vtkDearImGuiSharedMemoryPublisher::~vtkDearImGuiSharedMemoryPublisher()
+{
+  this->Close();
+}
+
+bool vtkDearImGuiSharedMemoryPublisher::Open(
+  const char* name, int maximumWidth, int maximumHeight, int numberOfSlots)
+{
+  this->Close();
+#ifdef SHARED_MEMORY_UNSUPPORTED
+  (void)maximumWidth;
+  (void)maximumHeight;
+  (void)numberOfSlots;
+  vtkErrorMacro(<< "Shared memory publishing needs POSIX shared memory.");
+  return false;
+#else
+  if (!name || maximumWidth <= 0 || maximumHeight <= 0 || numberOfSlots < 2)
+  {
+    vtkErrorMacro(<< "Invalid shared memory ring parameters.");
+    return false;
+  }
+  const std::uint64_t slotsOffset =
+    AlignUp(AlignUp(sizeof(RingHeader), 64) + InputCapacity * sizeof(InputEvent), 4096);
+  const std::uint64_t slotSize = AlignUp(
+    PixelOffset + static_cast<std::uint64_t>(maximumWidth) * maximumHeight * 4, 4096);
+  const std::uint64_t size = slotsOffset + slotSize * numberOfSlots;
+
+  const int fd = shm_open(name, O_CREAT | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    vtkErrorMacro(<< "Cannot create shared memory " << name);
+    return false;
+  }
+  void* address = nullptr;
+  if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+  {
+    address = Map(fd, static_cast<std::size_t>(size));
+  }
+  close(fd);
+  if (!address)
+  {
+    vtkErrorMacro(<< "Cannot map " << size << " bytes of shared memory " << name);
+    shm_unlink(name);
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  RingHeader* header = static_cast<RingHeader*>(address);
+  std::memset(address, 0, static_cast<std::size_t>(slotsOffset));
+  this->Addressing.NumberOfSlots = static_cast<std::uint32_t>(numberOfSlots);
+  this->Addressing.InputCapacity = InputCapacity;
+  this->Addressing.SlotSize = slotSize;
+  this->Addressing.SlotsOffset = slotsOffset;
+  this->MaximumSize[0] = static_cast<std::uint32_t>(maximumWidth);
+  this->MaximumSize[1] = static_cast<std::uint32_t>(maximumHeight);
+  header->Version = Version;
+  header->NumberOfSlots = this->Addressing.NumberOfSlots;
+  header->InputCapacity = this->Addressing.InputCapacity;
+  header->MaximumSize[0] = this->MaximumSize[0];
+  header->MaximumSize[1] = this->MaximumSize[1];
+  header->SlotSize = slotSize;
+  header->SlotsOffset = slotsOffset;
+  for (int i = 0; i < numberOfSlots; ++i)
+  {
+    Slot(header, this->Addressing, i)->Sequence.store(0);
+  }
+  // readers check the magic last
+  std::atomic_thread_fence(std::memory_order_release);
+  header->Magic = Magic;
+  this->Header = header;
+  this->Size = static_cast<std::size_t>(size);
+  this->Name = name;
+  this->InputRead = 0;
+  this->Sequence = 0;
+  return true;
+#endif
+}
+
+void vtkDearImGuiSharedMemoryPublisher::Close()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  if (!this->Header)
+  {
+    return;
+  }
+#ifndef SHARED_MEMORY_UNSUPPORTED
+  munmap(this->Header, this->Size);
+  // mapped readers keep the segment until they unmap it
+  shm_unlink(this->Name.c_str());
+#endif
+  this->Header = nullptr;
+  this->Size = 0;
+  this->Name.clear();
+}
+
+void vtkDearImGuiSharedMemoryPublisher::Publish(
+  const unsigned char* rgba, int width, int height)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  RingHeader* header = this->Header;
+  if (!header)
+  {
+    return;
+  }
+  if (width <= 0 || height <= 0 || static_cast<std::uint32_t>(width) > this->MaximumSize[0] ||
+    static_cast<std::uint32_t>(height) > this->MaximumSize[1])
+  {
+    ++this->DroppedFrames;
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope("PublishFrame", "capture");
+  const std::uint64_t sequence = ++this->Sequence;
+  SlotHeader* slot = Slot(header, this->Addressing, sequence);
+  // seqlock: readers that saw the old sequence notice the change afterwards
+  slot->Sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(reinterpret_cast<unsigned char*>(slot) + PixelOffset, rgba,
+    static_cast<std::size_t>(width) * height * 4);
+  slot->Width = static_cast<std::uint32_t>(width);
+  slot->Height = static_cast<std::uint32_t>(height);
+  slot->Time = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch())
+                                            .count());
+  slot->Sequence.store(sequence, std::memory_order_release);
+  header->Published.store(sequence, std::memory_order_release);
+  ++this->PublishedFrames;
+}
+
+bool vtkDearImGuiSharedMemoryPublisher::PollInput(vtkRenderWindowInteractor* interactor)
+{
+  RingHeader* header = this->Header;
+  if (!header)
+  {
+    return false;
+  }
+  // InputRead is ours, the copy in the header only tells the reader what was consumed
+  const std::uint32_t write = header->InputWrite.load(std::memory_order_acquire);
+  std::uint32_t read = this->InputRead;
+  if (read == write)
+  {
+    return false;
+  }
+  if (write - read > this->Addressing.InputCapacity)
+  {
+    // a reader moved InputWrite past the queue, what it holds is garbage
+    this->InputRead = write;
+    header->InputRead.store(write, std::memory_order_release);
+    return false;
+  }
+  InputEvent* queue = InputQueue(header);
+  for (; read != write; ++read)
+  {
+    InputEvent event = queue[read % this->Addressing.InputCapacity];
+    // the slot may be reused once InputRead moves past it
+    this->InputRead = read + 1;
+    header->InputRead.store(read + 1, std::memory_order_release);
+    vtkDearImGuiRemoteProtocol::ReplayInputEvent(event, interactor);
+  }
+  return true;
+}
+
+vtkDearImGuiSharedMemoryPublisher::Reader::~Reader()
+{
+  this->Close();
+}
+
+bool vtkDearImGuiSharedMemoryPublisher::Reader::Open(const char* name)
+{
+  this->Close();
+#ifdef SHARED_MEMORY_UNSUPPORTED
+  (void)name;
+  return false;
+#else
+  const int fd = name ? shm_open(name, O_RDWR, 0) : -1;
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat info;
+  void* address = nullptr;
+  if (fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(RingHeader))
+  {
+    address = Map(fd, static_cast<std::size_t>(info.st_size));
+  }
+  close(fd);
+  if (!address)
+  {
+    return false;
+  }
+  RingHeader* header = static_cast<RingHeader*>(address);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const Layout layout = GetLayout(*header);
+  if (header->Magic != Magic || header->Version != Version ||
+    !IsValidLayout(layout, static_cast<std::uint64_t>(info.st_size)))
+  {
+    munmap(address, static_cast<std::size_t>(info.st_size));
+    return false;
+  }
+  this->Header = header;
+  this->Addressing = layout;
+  this->Size = static_cast<std::size_t>(info.st_size);
+  return true;
+#endif
+}
+
+void vtkDearImGuiSharedMemoryPublisher::Reader::Close()
+{
+#ifndef SHARED_MEMORY_UNSUPPORTED
+  if (this->Header)
+  {
+    munmap(this->Header, this->Size);
+  }
+#endif
+  this->Header = nullptr;
+  this->Size = 0;
+}
+
+bool vtkDearImGuiSharedMemoryPublisher::Reader::Acquire(Frame& frame)
+{
+  if (!this->Header)
+  {
+    return false;
+  }
+  const std::uint64_t sequence = this->Header->Published.load(std::memory_order_acquire);
+  if (sequence == 0 || sequence <= frame.Sequence)
+  {
+    return false;
+  }
+  SlotHeader* slot = Slot(this->Header, this->Addressing, sequence);
+  if (slot->Sequence.load(std::memory_order_acquire) != sequence)
+  {
+    // already being overwritten
+    return false;
+  }
+  // the pixels must stay inside the slot
+  if (static_cast<std::uint64_t>(slot->Width) * slot->Height * 4 >
+    this->Addressing.SlotSize - PixelOffset)
+  {
+    return false;
+  }
+  frame.Pixels = reinterpret_cast<const unsigned char*>(slot) + PixelOffset;
+  frame.Width = static_cast<int>(slot->Width);
+  frame.Height = static_cast<int>(slot->Height);
+  frame.Time = slot->Time;
+  frame.Sequence = sequence;
+  return this->IsValid(frame);
+}
+
+bool vtkDearImGuiSharedMemoryPublisher::Reader::IsValid(const Frame& frame) const
+{
+  if (!this->Header || frame.Sequence == 0)
+  {
+    return false;
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const SlotHeader* slot = Slot(this->Header, this->Addressing, frame.Sequence);
+  return slot->Sequence.load(std::memory_order_relaxed) == frame.Sequence;
+}
+
+bool vtkDearImGuiSharedMemoryPublisher::Reader::PostInput(
+  const vtkDearImGuiRemoteProtocol::InputEvent& event)
+{
+  if (!this->Header)
+  {
+    return false;
+  }
+  const std::uint32_t write = this->Header->InputWrite.load(std::memory_order_relaxed);
+  const std::uint32_t read = this->Header->InputRead.load(std::memory_order_acquire);
+  if (write - read >= this->Addressing.InputCapacity)
+  {
+    return false;
+  }
+  InputQueue(this->Header)[write % this->Addressing.InputCapacity] = event;
+  this->Header->InputWrite.store(write + 1, std::memory_order_release);
+  return true;
+}
@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include <vtkDearImGuiStreamingPlot.h>
+
+#include <vtkObjectFactory.h>
+
+#include "imgui.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define STREAMING_PLOT_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define STREAMING_PLOT_NEON 1
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define STREAMING_PLOT_WASM_SIMD 1
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiStreamingPlot);
+
+namespace
+{
+const ImU32 Palette[] = { IM_COL32(31, 119, 180, 255), IM_COL32(255, 127, 14, 255),
+  IM_COL32(44, 160, 44, 255), IM_COL32(214, 39, 40, 255), IM_COL32(148, 103, 189, 255),
+  IM_COL32(140, 86, 75, 255), IM_COL32(227, 119, 194, 255), IM_COL32(23, 190, 207, 255) };
+
+// 4-wide float helpers for the min/max kernel.
+#if defined(STREAMING_PLOT_SSE)
+using Float4 = __m128;
+inline Float4 Load4(const float* p) { return _mm_loadu_ps(p); }
+inline Float4 Min4(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 Max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline void Store4(float* p, Float4 a) { _mm_storeu_ps(p, a); }
+#elif defined(STREAMING_PLOT_NEON)
+using Float4 = float32x4_t;
+inline Float4 Load4(const float* p) { return vld1q_f32(p); }
+inline Float4 Min4(Float4 a, Float4 b) { return vminq_f32(a, b); }
+inline Float4 Max4(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline void Store4(float* p, Float4 a) { vst1q_f32(p, a); }
+#elif defined(STREAMING_PLOT_WASM_SIMD)
+using Float4 = v128_t;
+inline Float4 Load4(const float* p) { return wasm_v128_load(p); }
+inline Float4 Min4(Float4 a, Float4 b) { return wasm_f32x4_pmin(a, b); }
+inline Float4 Max4(Float4 a, Float4 b) { return wasm_f32x4_pmax(a, b); }
+inline void Store4(float* p, Float4 a) { wasm_v128_store(p, a); }
+#endif
+
+// min and max of v[begin, end), end > begin.
+inline void MinMaxOfRange(const float* v, vtkIdType begin, vtkIdType end, float& lo, float& hi)
+{
+  vtkIdType i = begin;
+  lo = v[i];
+  hi = v[i];
+#if defined(STREAMING_PLOT_SSE) || defined(STREAMING_PLOT_NEON) || defined(STREAMING_PLOT_WASM_SIMD)
+  if (end - i >= 8)
+  {
+    Float4 vlo = Load4(v + i);
+    Float4 vhi = vlo;
+    for (i += 4; i + 4 <= end; i += 4)
+    {
+      const Float4 x = Load4(v + i);
+      vlo = Min4(vlo, x);
+      vhi = Max4(vhi, x);
+    }
+    float l[4], h[4];
+    Store4(l, vlo);
+    Store4(h, vhi);
+    lo = std::min(std::min(l[0], l[1]), std::min(l[2], l[3]));
+    hi = std::max(std::max(h[0], h[1]), std::max(h[2], h[3]));
+  }
+#endif
+  for (; i < end; ++i)
+  {
+    lo = std::min(lo, v[i]);
+    hi = std::max(hi, v[i]);
+  }
+}
+}
+
+vtkDearImGuiStreamingPlot::vtkDearImGuiStreamingPlot() = default;
+
+vtkDearImGuiStreamingPlot::~vtkDearImGuiStreamingPlot() = default;
+
+int vtkDearImGuiStreamingPlot::AddChannel(const char* name, vtkIdType capacity, unsigned int color)
+{
+  vtkIdType size = 2;
+  while (size < capacity)
+  {
+    size <<= 1;
+  }
+  std::unique_ptr<Channel> channel(new Channel());
+  channel->Name = name ? name : "";
+  channel->Color = color
+    ? color
+    : Palette[this->Channels.size() % (sizeof(Palette) / sizeof(Palette[0]))];
+  channel->Data.reset(new float[size]);
+  channel->Mask = size - 1;
+  this->Channels.push_back(std::move(channel));
+  this->ColumnsA.resize(this->Channels.size());
+  this->ColumnsB.resize(this->Channels.size());
+  this->Counts.resize(this->Channels.size());
+  return static_cast<int>(this->Channels.size()) - 1;
+}
+
+vtkIdType vtkDearImGuiStreamingPlot::GetNumberOfSamples(int channel) const
+{
+  if (channel < 0 || channel >= this->GetNumberOfChannels())
+  {
+    return 0;
+  }
+  return this->Channels[channel]->Head.load(std::memory_order_acquire);
+}
+
+void vtkDearImGuiStreamingPlot::Append(int channel, float value)
+{
+  this->Append(channel, &value, 1);
+}
+
+void vtkDearImGuiStreamingPlot::Append(int channel, const float* values, vtkIdType count)
+{
+  if (channel < 0 || channel >= this->GetNumberOfChannels())
+  {
+    return;
+  }
+  Channel& ch = *this->Channels[channel];
+  const vtkIdType capacity = ch.Mask + 1;
+  // the final head is published once, after the data is in place
+  const vtkIdType head = ch.Head.load(std::memory_order_relaxed) + count;
+  if (count > capacity)
+  {
+    // only the tail survives anyway.
+    values += count - capacity;
+    count = capacity;
+  }
+  // announce the samples about to be overwritten before touching them, see Snapshot()
+  ch.Writing.store(head, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  const vtkIdType start = (head - count) & ch.Mask;
+  const vtkIdType first = std::min(count, capacity - start);
+  std::memcpy(ch.Data.get() + start, values, first * sizeof(float));
+  std::memcpy(ch.Data.get(), values + first, (count - first) * sizeof(float));
+  ch.Head.store(head, std::memory_order_release);
+}
+
+vtkIdType vtkDearImGuiStreamingPlot::Snapshot(const Channel& channel, vtkIdType count)
+{
+  const vtkIdType capacity = channel.Mask + 1;
+  const vtkIdType head = channel.Head.load(std::memory_order_acquire);
+  const vtkIdType n = std::min(std::min(head, capacity), count);
+  this->Scratch.resize(static_cast<std::size_t>(n));
+  const vtkIdType begin = head - n;
+  const vtkIdType start = begin & channel.Mask;
+  const vtkIdType first = std::min(n, capacity - start);
+  std::memcpy(this->Scratch.data(), channel.Data.get() + start, first * sizeof(float));
+  std::memcpy(this->Scratch.data() + first, channel.Data.get(), (n - first) * sizeof(float));
+
+  // Seqlock read: samples the producer started to overwrite, finished or not, are the
+  // oldest part of the snapshot. Drop them.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const vtkIdType writing = channel.Writing.load(std::memory_order_relaxed);
+  const vtkIdType clobbered = std::min(n, std::max<vtkIdType>(0, writing - capacity - begin));
+  if (clobbered > 0)
+  {
+    this->Scratch.erase(this->Scratch.begin(), this->Scratch.begin() + clobbered);
+  }
+  return n - clobbered;
+}
+
+void vtkDearImGuiStreamingPlot::DecimateMinMax(
+  const float* values, vtkIdType n, int columns, float* outMin, float* outMax)
+{
+  if (n <= 0 || columns <= 0)
+  {
+    return;
+  }
+  for (int c = 0; c < columns; ++c)
+  {
+    const vtkIdType begin = (n * c) / columns;
+    const vtkIdType end = std::max(begin + 1, (n * (c + 1)) / columns);
+    MinMaxOfRange(values, begin, std::min(end, n), outMin[c], outMax[c]);
+  }
+}
+
+vtkIdType vtkDearImGuiStreamingPlot::DecimateLTTB(
+  const float* values, vtkIdType n, vtkIdType threshold, float* outX, float* outY)
+{
+  if (threshold >= n || threshold < 3)
+  {
+    // never more than threshold points, the caller sizes the output with it
+    const vtkIdType count =
+      threshold >= n ? n : std::max<vtkIdType>(0, std::min<vtkIdType>(threshold, 2));
+    for (vtkIdType i = 0; i < count; ++i)
+    {
+      const vtkIdType j = (count == n) ? i : i * (n - 1);
+      outX[i] = static_cast<float>(j);
+      outY[i] = values[j];
+    }
+    return count;
+  }
+
+  // first and last points are kept, the others are split into threshold - 2 buckets.
+  const double every = static_cast<double>(n - 2) / (threshold - 2);
+  vtkIdType a = 0;
+  vtkIdType out = 0;
+  outX[out] = 0.f;
+  outY[out++] = values[0];
+  for (vtkIdType i = 0; i < threshold - 2; ++i)
+  {
+    // average of the next bucket is the third triangle vertex.
+    vtkIdType avgBegin = static_cast<vtkIdType>((i + 1) * every) + 1;
+    vtkIdType avgEnd = std::min(static_cast<vtkIdType>((i + 2) * every) + 1, n);
+    avgBegin = std::min(avgBegin, n - 1);
+    avgEnd = std::max(avgEnd, avgBegin + 1);
+    double avgX = 0, avgY = 0;
+    for (vtkIdType j = avgBegin; j < avgEnd; ++j)
+    {
+      avgX += j;
+      avgY += values[j];
+    }
+    avgX /= (avgEnd - avgBegin);
+    avgY /= (avgEnd - avgBegin);
+
+    // pick the point of this bucket forming the largest triangle with a and the average.
+    const vtkIdType begin = static_cast<vtkIdType>(i * every) + 1;
+    const vtkIdType end = static_cast<vtkIdType>((i + 1) * every) + 1;
+    const double ax = static_cast<double>(a);
+    const double ay = values[a];
+    double maxArea = -1;
+    vtkIdType next = begin;
+    for (vtkIdType j = begin; j < end; ++j)
+    {
+      const double area = std::abs((ax - avgX) * (values[j] - ay) - (ax - j) * (avgY - ay));
+      if (area > maxArea)
+      {
+        maxArea = area;
+        next = j;
+      }
+    }
+    outX[out] = static_cast<float>(next);
+    outY[out++] = values[next];
+    a = next;
+  }
+  outX[out] = static_cast<float>(n - 1);
+  outY[out++] = values[n - 1];
+  return out;
+}
+
+void vtkDearImGuiStreamingPlot::Draw(const char* label, float width, float height)
+{
+  const ImGuiStyle& style = ImGui::GetStyle();
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  if (width <= 0.f)
+  {
+    width = ImGui::GetContentRegionAvail().x;
+  }
+  const ImVec2 size(std::max(width, 16.f), std::max(height, 16.f));
+  ImGui::InvisibleButton(label, size);
+  if (!ImGui::IsItemVisible())
+  {
+    return; // scrolled out, skip the decimation.
+  }
+  const bool hovered = ImGui::IsItemHovered();
+  const ImVec2 corner(origin.x + size.x, origin.y + size.y);
+  ImDrawList* drawList = ImGui::GetWindowDrawList();
+  drawList->AddRectFilled(
+    origin, corner, ImGui::GetColorU32(ImGuiCol_FrameBg), style.FrameRounding);
+
+  // Decimate every channel, the visible window is anchored at the newest sample.
+  const int columns = std::max(1, static_cast<int>(size.x));
+  vtkIdType span = this->VisibleSamples;
+  float lo = std::numeric_limits<float>::max();
+  float hi = -std::numeric_limits<float>::max();
+  for (std::size_t i = 0; i < this->Channels.size(); ++i)
+  {
+    const Channel& channel = *this->Channels[i];
+    const vtkIdType n = this->Snapshot(
+      channel, this->VisibleSamples > 0 ? this->VisibleSamples : channel.Mask + 1);
+    this->Counts[i] = n;
+    span = std::max(span, n);
+    std::vector<float>& a = this->ColumnsA[i];
+    std::vector<float>& b = this->ColumnsB[i];
+    if (n == 0)
+    {
+      a.clear();
+      b.clear();
+      continue;
+    }
+    const int used = static_cast<int>(std::min<vtkIdType>(n, columns));
+    a.resize(used);
+    b.resize(used);
+    if (this->DecimationMode == MinMax)
+    {
+      vtkDearImGuiStreamingPlot::DecimateMinMax(this->Scratch.data(), n, used, a.data(), b.data());
+      for (int c = 0; c < used; ++c)
+      {
+        // a holds the min, b the max of column c.
+        lo = std::min(lo, a[c]);
+        hi = std::max(hi, b[c]);
+      }
+    }
+    else
+    {
+      const vtkIdType count =
+        vtkDearImGuiStreamingPlot::DecimateLTTB(this->Scratch.data(), n, used, a.data(), b.data());
+      a.resize(count);
+      b.resize(count);
+      for (vtkIdType c = 0; c < count; ++c)
+      {
+        lo = std::min(lo, b[c]);
+        hi = std::max(hi, b[c]);
+      }
+    }
+  }
+  if (this->YRange[0] < this->YRange[1])
+  {
+    lo = this->YRange[0];
+    hi = this->YRange[1];
+  }
+  if (!(lo < hi))
+  {
+    lo -= 0.5f;
+    hi += 0.5f;
+  }
+
+  // One polyline per channel. Min/max columns zig-zag between their extremes so that a
+  // single stroke shows the envelope.
+  const float pad = style.FramePadding.y;
+  const float yScale = (size.y - 2.f * pad) / (hi - lo);
+  auto toY = [&](float v)
+  { return corner.y - pad - (std::min(std::max(v, lo), hi) - lo) * yScale; };
+  std::vector<ImVec2> points;
+  drawList->PushClipRect(origin, corner, true);
+  for (std::size_t i = 0; i < this->Channels.size(); ++i)
+  {
+    const vtkIdType n = this->Counts[i];
+    const std::vector<float>& a = this->ColumnsA[i];
+    const std::vector<float>& b = this->ColumnsB[i];
+    if (n == 0 || a.empty())
+    {
+      continue;
+    }
+    // samples [0, n) are drawn over the right n / span of the width.
+    const float x0 = origin.x + size.x * static_cast<float>(span - n) / span;
+    const float w = size.x * static_cast<float>(n) / span;
+    points.clear();
+    if (this->DecimationMode == MinMax)
+    {
+      const int used = static_cast<int>(a.size());
+      points.reserve(2 * used);
+      for (int c = 0; c < used; ++c)
+      {
+        const float x = x0 + w * (c + 0.5f) / used;
+        const bool up = (c & 1) == 0;
+        points.push_back(ImVec2(x, toY(up ? a[c] : b[c])));
+        points.push_back(ImVec2(x, toY(up ? b[c] : a[c])));
+      }
+    }
+    else
+    {
+      points.reserve(a.size());
+      const float scale = n > 1 ? w / (n - 1) : 0.f;
+      for (std::size_t c = 0; c < a.size(); ++c)
+      {
+        points.push_back(ImVec2(x0 + a[c] * scale, toY(b[c])));
+      }
+    }
+#if IMGUI_VERSION_NUM >= 18200
+    drawList->AddPolyline(points.data(), static_cast<int>(points.size()), this->Channels[i]->Color,
+      ImDrawFlags_None, 1.f);
+#else
+    drawList->AddPolyline(
+      points.data(), static_cast<int>(points.size()), this->Channels[i]->Color, false, 1.f);
+#endif
+  }
+  drawList->PopClipRect();
+
+  // legend and scale
+  char text[64];
+  ImVec2 cursor(origin.x + style.FramePadding.x, origin.y + style.FramePadding.y);
+  drawList->AddText(cursor, ImGui::GetColorU32(ImGuiCol_Text), label, std::strstr(label, "##"));
+  for (const auto& channel : this->Channels)
+  {
+    cursor.y += ImGui::GetTextLineHeight();
+    drawList->AddText(cursor, channel->Color, channel->Name.c_str());
+  }
+  std::snprintf(text, sizeof(text), "%g", hi);
+  drawList->AddText(ImVec2(corner.x - ImGui::CalcTextSize(text).x - style.FramePadding.x, origin.y),
+    ImGui::GetColorU32(ImGuiCol_TextDisabled), text);
+  std::snprintf(text, sizeof(text), "%g", lo);
+  drawList->AddText(ImVec2(corner.x - ImGui::CalcTextSize(text).x - style.FramePadding.x,
+                      corner.y - ImGui::GetTextLineHeight()),
+    ImGui::GetColorU32(ImGuiCol_TextDisabled), text);
+
+  if (hovered)
+  {
+    ImGui::BeginTooltip();
+    for (std::size_t i = 0; i < this->Channels.size(); ++i)
+    {
+      const Channel& channel = *this->Channels[i];
+      ImGui::TextColored(ImGui::ColorConvertU32ToFloat4(channel.Color), "%s: %lld samples",
+        channel.Name.c_str(), static_cast<long long>(channel.Head.load()));
+    }
+    ImGui::EndTooltip();
+  }
+}
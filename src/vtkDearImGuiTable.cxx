@@ -0,0 +1,180 @@
+#include <string>
+#include <vector>
+
+#include <vtkDearImGuiTable.h>
+
+#include "imgui.h"
+
+#if IMGUI_VERSION_NUM < 18000
+namespace
+{
+// The table being drawn with legacy columns, which start with the first row.
+struct LegacyTable
+{
+  std::string Id;
+  int Columns = 1;
+  int Flags = 0;
+  std::vector<std::string> Labels;
+  std::vector<float> Weights;
+  bool Started = false;
+  int Column = -1; // -1 before the first cell of a row
+};
+LegacyTable Current;
+
+void Start()
+{
+  if (Current.Started)
+  {
+    return;
+  }
+  Current.Started = true;
+  Current.Column = -1;
+  ImGui::Columns(Current.Columns, Current.Id.c_str(), true);
+  // initial widths from the weights, the user resizes the columns afterwards
+  ImGuiStorage* storage = ImGui::GetStateStorage();
+  const ImGuiID initialized = ImGui::GetID((Current.Id + "##widths").c_str());
+  if (storage->GetBool(initialized))
+  {
+    return;
+  }
+  storage->SetBool(initialized, true);
+  float total = 0.f;
+  for (int i = 0; i < Current.Columns; ++i)
+  {
+    total += i < static_cast<int>(Current.Weights.size()) ? Current.Weights[i] : 1.f;
+  }
+  const float width = ImGui::GetWindowContentRegionWidth();
+  for (int i = 0; i + 1 < Current.Columns && total > 0.f; ++i)
+  {
+    const float weight = i < static_cast<int>(Current.Weights.size()) ? Current.Weights[i] : 1.f;
+    ImGui::SetColumnWidth(i, width * weight / total);
+  }
+}
+}
+#endif
+
+bool vtkDearImGuiTable::Begin(const char* id, int columns, int flags)
+{
+#if IMGUI_VERSION_NUM >= 18000
+  ImGuiTableFlags tableFlags = ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchProp;
+  tableFlags |= (flags & RowBackground) ? ImGuiTableFlags_RowBg : 0;
+  tableFlags |= (flags & ScrollY) ? ImGuiTableFlags_ScrollY : 0;
+  if (!ImGui::BeginTable(id, columns, tableFlags))
+  {
+    return false;
+  }
+  if (flags & ScrollY)
+  {
+    ImGui::TableSetupScrollFreeze(0, 1);
+  }
+  return true;
+#else
+  Current = LegacyTable();
+  Current.Id = id;
+  Current.Columns = columns > 0 ? columns : 1;
+  Current.Flags = flags;
+  if (flags & ScrollY)
+  {
+    // fills the available height, End() closes it whether it is visible or not
+    ImGui::BeginChild(id, ImVec2(0.f, 0.f));
+  }
+  return true;
+#endif
+}
+
+void vtkDearImGuiTable::SetupColumn(const char* label, float weight)
+{
+#if IMGUI_VERSION_NUM >= 18000
+  ImGui::TableSetupColumn(label, 0, weight);
+#else
+  Current.Labels.push_back(label ? label : "");
+  Current.Weights.push_back(weight);
+#endif
+}
+
+void vtkDearImGuiTable::HeadersRow()
+{
+#if IMGUI_VERSION_NUM >= 18000
+  ImGui::TableHeadersRow();
+#else
+  Start();
+  for (int i = 0; i < Current.Columns; ++i)
+  {
+    if (i < static_cast<int>(Current.Labels.size()))
+    {
+      ImGui::TextUnformatted(Current.Labels[i].c_str());
+    }
+    ImGui::NextColumn();
+  }
+  ImGui::Separator();
+  Current.Column = -1;
+#endif
+}
+
+void vtkDearImGuiTable::NextRow()
+{
+#if IMGUI_VERSION_NUM >= 18000
+  ImGui::TableNextRow();
+#else
+  Start();
+  if (Current.Column >= 0)
+  {
+    // skip the cells left in the row
+    for (; Current.Column < Current.Columns; ++Current.Column)
+    {
+      ImGui::NextColumn();
+    }
+  }
+  Current.Column = -1;
+#endif
+}
+
+void vtkDearImGuiTable::NextColumn()
+{
+#if IMGUI_VERSION_NUM >= 18000
+  ImGui::TableNextColumn();
+#else
+  Start();
+  if (Current.Column >= 0)
+  {
+    ImGui::NextColumn();
+  }
+  ++Current.Column;
+#endif
+}
+
+void vtkDearImGuiTable::SetRowColor(unsigned int color)
+{
+#if IMGUI_VERSION_NUM >= 18000
+  ImGui::TableSetBgColor(ImGuiTableBgTarget_RowBg1, color);
+#else
+  // under the cells, across all columns
+  Start();
+  ImDrawList* drawList = ImGui::GetWindowDrawList();
+  const ImVec2 windowMin = ImGui::GetWindowPos();
+  const ImVec2 windowMax(
+    windowMin.x + ImGui::GetWindowWidth(), windowMin.y + ImGui::GetWindowHeight());
+  const ImVec2 rowMin(windowMin.x, ImGui::GetCursorScreenPos().y);
+  const ImVec2 rowMax(windowMax.x, rowMin.y + ImGui::GetTextLineHeightWithSpacing());
+  drawList->PushClipRect(windowMin, windowMax, false);
+  drawList->AddRectFilled(rowMin, rowMax, color);
+  drawList->PopClipRect();
+#endif
+}
+
+void vtkDearImGuiTable::End()
+{
+#if IMGUI_VERSION_NUM >= 18000
+  ImGui::EndTable();
+#else
+  if (Current.Started)
+  {
+    ImGui::Columns(1);
+  }
+  if (Current.Flags & ScrollY)
+  {
+    ImGui::EndChild();
+  }
+  Current = LegacyTable();
+#endif
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include <vtkDearImGuiTextIndex.h>
+
+void vtkDearImGuiTextIndex::Clear()
+{
+  this->Texts.clear();
+  this->Masks.clear();
+  this->Postings.clear();
+}
+
+std::string vtkDearImGuiTextIndex::ToLower(const char* text)
+{
+  std::string lower(text ? text : "");
+  for (char& c : lower)
+  {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return lower;
+}
+
+std::uint64_t vtkDearImGuiTextIndex::CharacterMask(const std::string& text)
+{
+  std::uint64_t mask = 0;
+  for (char c : text)
+  {
+    const unsigned char u = static_cast<unsigned char>(c);
+    // letters and digits get a bit each, everything else shares the remaining bits
+    const int bit = u >= 'a' && u <= 'z' ? u - 'a' : u >= '0' && u <= '9' ? 26 + u - '0'
+                                                                             : 36 + u % 28;
+    mask |= std::uint64_t(1) << bit;
+  }
+  return mask;
+}
+
+int vtkDearImGuiTextIndex::Add(const std::string& text)
+{
+  const int id = static_cast<int>(this->Texts.size());
+  this->Texts.push_back(ToLower(text.c_str()));
+  const std::string& lower = this->Texts.back();
+  this->Masks.push_back(CharacterMask(lower));
+  for (std::size_t i = 0; i + 3 <= lower.size(); ++i)
+  {
+    std::vector<int>& ids = this->Postings[Trigram(&lower[i])];
+    // ids only grow, a repeated trigram ends up next to itself
+    if (ids.empty() || ids.back() != id)
+    {
+      ids.push_back(id);
+    }
+  }
+  return id;
+}
+
+void vtkDearImGuiTextIndex::Find(const char* query, std::vector<int>& ids) const
+{
+  ids.clear();
+  const std::string lower = ToLower(query);
+  if (lower.size() < 3)
+  {
+    // too short for trigrams
+    for (int id = 0; id < static_cast<int>(this->Texts.size()); ++id)
+    {
+      if (this->Texts[id].find(lower) != std::string::npos)
+      {
+        ids.push_back(id);
+      }
+    }
+    return;
+  }
+  const std::vector<int>* rarest = nullptr;
+  for (std::size_t i = 0; i + 3 <= lower.size(); ++i)
+  {
+    auto it = this->Postings.find(Trigram(&lower[i]));
+    if (it == this->Postings.end())
+    {
+      return;
+    }
+    if (!rarest || it->second.size() < rarest->size())
+    {
+      rarest = &it->second;
+    }
+  }
+  for (int id : *rarest)
+  {
+    if (this->Texts[id].find(lower) != std::string::npos)
+    {
+      ids.push_back(id);
+    }
+  }
+}
+
+void vtkDearImGuiTextIndex::Refine(
+  const char* query, const std::vector<int>& candidates, std::vector<int>& ids) const
+{
+  const std::string lower = ToLower(query);
+  std::vector<int> matches;
+  matches.reserve(candidates.size());
+  for (int id : candidates)
+  {
+    if (this->Texts[id].find(lower) != std::string::npos)
+    {
+      matches.push_back(id);
+    }
+  }
+  // candidates and ids may be the same vector
+  ids.swap(matches);
+}
+
+void vtkDearImGuiTextIndex::FindSubsequence(const char* query, std::vector<int>& ids) const
+{
+  ids.clear();
+  const std::string lower = ToLower(query);
+  const std::uint64_t mask = CharacterMask(lower);
+  for (int id = 0; id < static_cast<int>(this->Texts.size()); ++id)
+  {
+    if ((this->Masks[id] & mask) != mask)
+    {
+      continue;
+    }
+    const std::string& text = this->Texts[id];
+    std::size_t position = 0;
+    for (char c : lower)
+    {
+      position = text.find(c, position);
+      if (position == std::string::npos)
+      {
+        break;
+      }
+      ++position;
+    }
+    if (position != std::string::npos)
+    {
+      ids.push_back(id);
+    }
+  }
+}
+
+int vtkDearImGuiTextIndex::Score(const std::string& text, const std::string& query)
+{
+  const int n = static_cast<int>(text.size());
+  if (query.empty())
+  {
+    return 0;
+  }
+  // best[i]: best score with the current query character at text[i], -1 if impossible
+  std::vector<int> previous(n, -1);
+  std::vector<int> best(n, -1);
+  for (std::size_t j = 0; j < query.size(); ++j)
+  {
+    int bestBefore = j == 0 ? 0 : -1; // best of previous[0, i - 1)
+    for (int i = 0; i < n; ++i)
+    {
+      best[i] = -1;
+      if (text[i] == query[j])
+      {
+        const bool wordStart = i == 0 || std::strchr(" /_-.>", text[i - 1]) != nullptr;
+        int base = bestBefore;
+        if (j > 0 && i > 0 && previous[i - 1] >= 0)
+        {
+          // runs of consecutive characters
+          base = std::max(base, previous[i - 1] + 5);
+        }
+        if (base >= 0)
+        {
+          best[i] = base + 1 + (wordStart ? 8 : 0);
+        }
+      }
+      if (j > 0 && i > 0)
+      {
+        bestBefore = std::max(bestBefore, previous[i - 1]);
+      }
+    }
+    previous.swap(best);
+  }
+  const int score = n > 0 ? *std::max_element(previous.begin(), previous.end()) : -1;
+  if (score < 0)
+  {
+    return -1;
+  }
+  // shorter texts first among equal matches
+  return score * 256 - std::min(n, 255);
+}
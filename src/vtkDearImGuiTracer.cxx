@@ -0,0 +1,270 @@
+#include <chrono>
+#include <cstring>
+
+#include <vtkDearImGuiTracer.h>
+
+#include <vtkObjectFactory.h>
+
+// Without threads (WebAssembly built with USE_PTHREADS=0) events are written from Poll().
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define TRACER_NO_THREADS 1
+#endif
+
+vtkStandardNewMacro(vtkDearImGuiTracer);
+
+std::atomic<vtkDearImGuiTracer*> vtkDearImGuiTracer::ActiveTracer{ nullptr };
+std::atomic<unsigned int> vtkDearImGuiTracer::Generation{ 0 };
+std::atomic<int> vtkDearImGuiTracer::Producers{ 0 };
+
+// A span, or a thread name when Category is null.
+struct vtkDearImGuiTracer::Event
+{
+  char Name[56];
+  const char* Category;
+  double Begin;
+  double End;
+};
+
+// Single-producer (the owning thread), single-consumer (the flusher) ring of events.
+struct vtkDearImGuiTracer::ThreadBuffer
+{
+  static const std::size_t Capacity = 1 << 14;
+  std::unique_ptr<Event[]> Events{ new Event[Capacity] };
+  std::atomic<std::size_t> Head{ 0 };
+  std::atomic<std::size_t> Tail{ 0 };
+  unsigned int Generation = 0;
+  int ThreadId = 0;
+};
+
+namespace
+{
+// Buffers outlive the tracer through these references, so a thread that is about to
+// record while the trace stops never writes into freed memory.
+thread_local std::shared_ptr<vtkDearImGuiTracer::ThreadBuffer> LocalBuffer;
+thread_local std::string LocalThreadName;
+
+bool Push(vtkDearImGuiTracer::ThreadBuffer* buffer, const char* name, const char* category,
+  double begin, double end)
+{
+  const std::size_t head = buffer->Head.load(std::memory_order_relaxed);
+  if (head - buffer->Tail.load(std::memory_order_acquire) >= buffer->Capacity)
+  {
+    return false;
+  }
+  vtkDearImGuiTracer::Event& event = buffer->Events[head & (buffer->Capacity - 1)];
+  std::strncpy(event.Name, name ? name : "", sizeof(event.Name) - 1);
+  event.Name[sizeof(event.Name) - 1] = '\0';
+  event.Category = category;
+  event.Begin = begin;
+  event.End = end;
+  buffer->Head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+// JSON string escaping for names.
+void WriteEscaped(std::FILE* file, const char* text)
+{
+  for (; *text; ++text)
+  {
+    const unsigned char c = static_cast<unsigned char>(*text);
+    if (c == '"' || c == '\\')
+    {
+      std::fputc('\\', file);
+      std::fputc(c, file);
+    }
+    else if (c < 0x20)
+    {
+      std::fprintf(file, "\\u%04x", c);
+    }
+    else
+    {
+      std::fputc(c, file);
+    }
+  }
+}
+}
+
+// The active tracer, kept alive by Stop() until the guard is destroyed. Counting before
+// loading the pointer, both sequentially consistent, means Stop() either sees the count
+// or the producer sees no tracer.
+struct vtkDearImGuiTracer::ProducerGuard
+{
+  vtkDearImGuiTracer* Tracer;
+  ProducerGuard()
+  {
+    Producers.fetch_add(1);
+    this->Tracer = ActiveTracer.load();
+  }
+  ~ProducerGuard() { Producers.fetch_sub(1); }
+  ProducerGuard(const ProducerGuard&) = delete;
+  void operator=(const ProducerGuard&) = delete;
+};
+
+vtkDearImGuiTracer::vtkDearImGuiTracer() = default;
+
+vtkDearImGuiTracer::~vtkDearImGuiTracer()
+{
+  this->Stop();
+}
+
+double vtkDearImGuiTracer::Now()
+{
+  using namespace std::chrono;
+  static const steady_clock::time_point epoch = steady_clock::now();
+  return duration_cast<duration<double, std::micro>>(steady_clock::now() - epoch).count();
+}
+
+bool vtkDearImGuiTracer::Start(const char* fileName)
+{
+  this->Stop();
+  this->File = fileName ? std::fopen(fileName, "w") : nullptr;
+  if (!this->File)
+  {
+    vtkErrorMacro(<< "Cannot open trace file " << (fileName ? fileName : "(null)"));
+    return false;
+  }
+  std::fputs("[\n", this->File);
+  this->DroppedEvents = 0;
+  this->TraceGeneration = ++Generation;
+  this->StopFlusher = false;
+#ifndef TRACER_NO_THREADS
+  this->Flusher = std::thread(&vtkDearImGuiTracer::FlushLoop, this);
+#endif
+  ActiveTracer.store(this, std::memory_order_release);
+  return true;
+}
+
+void vtkDearImGuiTracer::Stop()
+{
+  if (!this->File)
+  {
+    return;
+  }
+  vtkDearImGuiTracer* self = this;
+  ActiveTracer.compare_exchange_strong(self, nullptr);
+  // Producers that loaded this tracer before it was deactivated may still push, and a
+  // new thread may register its buffer. Both are short.
+  while (Producers.load() != 0)
+  {
+    std::this_thread::yield();
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->FlusherMutex);
+    this->StopFlusher = true;
+  }
+  this->FlusherCondition.notify_one();
+  if (this->Flusher.joinable())
+  {
+    this->Flusher.join();
+  }
+  this->Flush();
+  std::fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+             "\"args\":{\"name\":\"vtkDearImGuiInjector\"}}\n]\n",
+    this->File);
+  std::fclose(this->File);
+  this->File = nullptr;
+  std::lock_guard<std::mutex> lock(this->BuffersMutex);
+  this->Buffers.clear();
+}
+
+vtkDearImGuiTracer::ThreadBuffer* vtkDearImGuiTracer::GetThreadBuffer()
+{
+  if (!LocalBuffer || LocalBuffer->Generation != this->TraceGeneration)
+  {
+    LocalBuffer = std::make_shared<ThreadBuffer>();
+    LocalBuffer->Generation = this->TraceGeneration;
+    {
+      std::lock_guard<std::mutex> lock(this->BuffersMutex);
+      this->Buffers.push_back(LocalBuffer);
+      LocalBuffer->ThreadId = static_cast<int>(this->Buffers.size());
+    }
+    if (!LocalThreadName.empty())
+    {
+      Push(LocalBuffer.get(), LocalThreadName.c_str(), nullptr, 0., 0.);
+    }
+  }
+  return LocalBuffer.get();
+}
+
+void vtkDearImGuiTracer::AddSpan(const char* name, const char* category, double begin, double end)
+{
+  if (!GetActive())
+  {
+    return;
+  }
+  ProducerGuard guard;
+  vtkDearImGuiTracer* tracer = guard.Tracer;
+  if (tracer && !Push(tracer->GetThreadBuffer(), name, category, begin, end))
+  {
+    ++tracer->DroppedEvents;
+  }
+}
+
+void vtkDearImGuiTracer::SetThreadName(const char* name)
+{
+  LocalThreadName = name ? name : "";
+  ProducerGuard guard;
+  vtkDearImGuiTracer* tracer = guard.Tracer;
+  if (tracer && !Push(tracer->GetThreadBuffer(), name, nullptr, 0., 0.))
+  {
+    ++tracer->DroppedEvents;
+  }
+}
+
+void vtkDearImGuiTracer::Poll()
+{
+#ifdef TRACER_NO_THREADS
+  if (this->File)
+  {
+    this->Flush();
+  }
+#endif
+}
+
+void vtkDearImGuiTracer::FlushLoop()
+{
+  std::unique_lock<std::mutex> lock(this->FlusherMutex);
+  while (!this->StopFlusher)
+  {
+    this->FlusherCondition.wait_for(lock, std::chrono::milliseconds(100));
+    lock.unlock();
+    this->Flush();
+    lock.lock();
+  }
+}
+
+void vtkDearImGuiTracer::Flush()
+{
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(this->BuffersMutex);
+    buffers = this->Buffers;
+  }
+  for (const auto& buffer : buffers)
+  {
+    const std::size_t head = buffer->Head.load(std::memory_order_acquire);
+    std::size_t tail = buffer->Tail.load(std::memory_order_relaxed);
+    for (; tail != head; ++tail)
+    {
+      const Event& event = buffer->Events[tail & (buffer->Capacity - 1)];
+      if (event.Category)
+      {
+        std::fputs("{\"name\":\"", this->File);
+        WriteEscaped(this->File, event.Name);
+        std::fprintf(this->File, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,",
+          event.Category, event.Begin, event.End - event.Begin);
+        std::fprintf(this->File, "\"pid\":1,\"tid\":%d},\n", buffer->ThreadId);
+      }
+      else
+      {
+        std::fprintf(this->File,
+          "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"",
+          buffer->ThreadId);
+        WriteEscaped(this->File, event.Name);
+        std::fputs("\"}},\n", this->File);
+      }
+      buffer->Tail.store(tail + 1, std::memory_order_release);
+    }
+  }
+  std::fflush(this->File);
+}
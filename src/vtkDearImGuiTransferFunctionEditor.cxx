@@ -0,0 +1,686 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+#include <vtkDearImGuiTracer.h>
+#include <vtkDearImGuiTransferFunctionEditor.h>
+
+#include <vtkColorTransferFunction.h>
+#include <vtkDataArray.h>
+#include <vtkObjectFactory.h>
+#include <vtkPiecewiseFunction.h>
+#include <vtkSMPThreadLocal.h>
+#include <vtkSMPTools.h>
+#include <vtk_glew.h>
+
+#include "imgui.h"
+
+vtkStandardNewMacro(vtkDearImGuiTransferFunctionEditor);
+
+namespace
+{
+// Per-thread bins summed in Reduce().
+template <typename T>
+struct HistogramFunctor
+{
+  const T* Values;
+  int NumberOfComponents;
+  int Component;
+  double Minimum;
+  double Scale;
+  int NumberOfBins;
+  std::vector<vtkIdType>& Result;
+  vtkSMPThreadLocal<std::vector<vtkIdType>> Bins;
+
+  HistogramFunctor(const T* values, int numberOfComponents, int component, const double range[2],
+    int numberOfBins, std::vector<vtkIdType>& result)
+    : Values(values)
+    , NumberOfComponents(numberOfComponents)
+    , Component(component)
+    , Minimum(range[0])
+    , Scale(range[1] > range[0] ? numberOfBins / (range[1] - range[0]) : 0.)
+    , NumberOfBins(numberOfBins)
+    , Result(result)
+  {
+  }
+
+  void Initialize() { this->Bins.Local().assign(this->NumberOfBins, 0); }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<vtkIdType>& bins = this->Bins.Local();
+    const int last = this->NumberOfBins - 1;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const double value =
+        static_cast<double>(this->Values[i * this->NumberOfComponents + this->Component]);
+      if (std::isnan(value))
+      {
+        continue;
+      }
+      const int bin = static_cast<int>((value - this->Minimum) * this->Scale);
+      ++bins[std::min(std::max(bin, 0), last)];
+    }
+  }
+
+  void Reduce()
+  {
+    this->Result.assign(this->NumberOfBins, 0);
+    for (const std::vector<vtkIdType>& bins : this->Bins)
+    {
+      for (int i = 0; i < this->NumberOfBins; ++i)
+      {
+        this->Result[i] += bins[i];
+      }
+    }
+  }
+};
+
+template <typename T>
+void ComputeHistogram(const T* values, int numberOfComponents, int component, vtkIdType count,
+  const double range[2], int numberOfBins, std::vector<vtkIdType>& result)
+{
+  HistogramFunctor<T> functor(values, numberOfComponents, component, range, numberOfBins, result);
+  vtkSMPTools::For(0, count, functor);
+}
+
+unsigned char ToByte(double value)
+{
+  return static_cast<unsigned char>(std::min(std::max(value, 0.), 1.) * 255. + 0.5);
+}
+
+// The color strip shows the lookup texture opaque, whatever its opacity.
+void DisableBlending(const ImDrawList*, const ImDrawCmd*)
+{
+  glDisable(GL_BLEND);
+}
+}
+
+vtkDearImGuiTransferFunctionEditor::vtkDearImGuiTransferFunctionEditor() = default;
+
+vtkDearImGuiTransferFunctionEditor::~vtkDearImGuiTransferFunctionEditor() = default;
+
+void vtkDearImGuiTransferFunctionEditor::SetColorTransferFunction(
+  vtkColorTransferFunction* function)
+{
+  if (this->Color != function)
+  {
+    this->Color = function;
+    this->Nodes[ColorFunction].clear();
+    this->SynchronizedTime[ColorFunction] = 0;
+    this->EditedNode[ColorFunction] = this->ActiveNode[ColorFunction] = -1;
+    this->SelectedColorNode = -1;
+    this->Modified();
+  }
+}
+
+vtkColorTransferFunction* vtkDearImGuiTransferFunctionEditor::GetColorTransferFunction() const
+{
+  return this->Color;
+}
+
+void vtkDearImGuiTransferFunctionEditor::SetScalarOpacity(vtkPiecewiseFunction* function)
+{
+  if (this->Opacity != function)
+  {
+    this->Opacity = function;
+    this->Nodes[OpacityFunction].clear();
+    this->SynchronizedTime[OpacityFunction] = 0;
+    this->EditedNode[OpacityFunction] = this->ActiveNode[OpacityFunction] = -1;
+    this->Modified();
+  }
+}
+
+vtkPiecewiseFunction* vtkDearImGuiTransferFunctionEditor::GetScalarOpacity() const
+{
+  return this->Opacity;
+}
+
+void vtkDearImGuiTransferFunctionEditor::SetHistogramArray(vtkDataArray* array, int component)
+{
+  this->HistogramArray = array;
+  this->HistogramComponent = component;
+  this->HistogramTime = 0;
+  this->Modified();
+}
+
+void vtkDearImGuiTransferFunctionEditor::Synchronize()
+{
+  double range[2] = { 0., 0. };
+  vtkDataArray* array = this->HistogramArray;
+  if (array && array->GetNumberOfTuples() > 0 && this->HistogramComponent >= 0 &&
+    this->HistogramComponent < array->GetNumberOfComponents())
+  {
+    array->GetRange(range, this->HistogramComponent);
+  }
+  else
+  {
+    range[0] = std::numeric_limits<double>::max();
+    range[1] = std::numeric_limits<double>::lowest();
+    if (this->Opacity && this->Opacity->GetSize() > 0)
+    {
+      range[0] = std::min(range[0], this->Opacity->GetRange()[0]);
+      range[1] = std::max(range[1], this->Opacity->GetRange()[1]);
+    }
+    if (this->Color && this->Color->GetSize() > 0)
+    {
+      range[0] = std::min(range[0], this->Color->GetRange()[0]);
+      range[1] = std::max(range[1], this->Color->GetRange()[1]);
+    }
+  }
+  if (!(range[0] <= range[1]))
+  {
+    range[0] = 0.;
+    range[1] = 1.;
+  }
+  else if (range[0] == range[1])
+  {
+    range[1] = range[0] + 1.;
+  }
+  this->Range[0] = range[0];
+  this->Range[1] = range[1];
+
+  bool resample = this->Table.empty() || this->TableRange[0] != range[0] ||
+    this->TableRange[1] != range[1];
+  for (int f = 0; f < NumberOfFunctions; ++f)
+  {
+    vtkObject* function = f == OpacityFunction ? static_cast<vtkObject*>(this->Opacity)
+                                               : static_cast<vtkObject*>(this->Color);
+    if (!function)
+    {
+      resample |= this->SynchronizedTime[f] != 0;
+      this->SynchronizedTime[f] = 0;
+      continue;
+    }
+    if (function->GetMTime() == this->SynchronizedTime[f] || this->EditedNode[f] != -1)
+    {
+      continue;
+    }
+    const int size = f == OpacityFunction ? this->Opacity->GetSize() : this->Color->GetSize();
+    std::vector<Node>& nodes = this->Nodes[f];
+    nodes.resize(size);
+    for (int i = 0; i < size; ++i)
+    {
+      if (f == OpacityFunction)
+      {
+        this->Opacity->GetNodeValue(i, nodes[i].Value);
+      }
+      else
+      {
+        this->Color->GetNodeValue(i, nodes[i].Value);
+      }
+    }
+    if (this->ActiveNode[f] >= size)
+    {
+      this->ActiveNode[f] = -1;
+    }
+    this->SynchronizedTime[f] = function->GetMTime();
+    resample = true;
+  }
+  if (this->SelectedColorNode >= static_cast<int>(this->Nodes[ColorFunction].size()))
+  {
+    this->SelectedColorNode = -1;
+  }
+  if (resample)
+  {
+    this->TableRange[0] = range[0];
+    this->TableRange[1] = range[1];
+    this->UpdateTable(0, TableSize);
+  }
+}
+
+void vtkDearImGuiTransferFunctionEditor::UpdateHistogram()
+{
+  vtkDataArray* array = this->HistogramArray;
+  if (!array || this->HistogramComponent < 0 ||
+    this->HistogramComponent >= array->GetNumberOfComponents())
+  {
+    this->Histogram.clear();
+    return;
+  }
+  if (array->GetMTime() == this->HistogramTime && this->HistogramBins == this->NumberOfBins)
+  {
+    return;
+  }
+  vtkDearImGuiTracer::Scope scope("ComputeHistogram", "editor");
+  switch (array->GetDataType())
+  {
+    vtkTemplateMacro(ComputeHistogram(static_cast<const VTK_TT*>(array->GetVoidPointer(0)),
+      array->GetNumberOfComponents(), this->HistogramComponent, array->GetNumberOfTuples(),
+      this->Range, this->NumberOfBins, this->Histogram));
+    default:
+      this->Histogram.clear();
+      break;
+  }
+  this->HistogramTime = array->GetMTime();
+  this->HistogramBins = this->NumberOfBins;
+}
+
+int vtkDearImGuiTransferFunctionEditor::TableIndex(double x) const
+{
+  const double scale = (TableSize - 1) / (this->TableRange[1] - this->TableRange[0]);
+  const double index = std::floor((x - this->TableRange[0]) * scale);
+  return static_cast<int>(std::min(std::max(index, 0.), TableSize - 1.));
+}
+
+void vtkDearImGuiTransferFunctionEditor::UpdateTable(int begin, int end)
+{
+  this->Table.resize(4 * TableSize, 255);
+  begin = std::max(begin, 0);
+  end = std::min(end, static_cast<int>(TableSize));
+  const int count = end - begin;
+  if (count <= 0)
+  {
+    return;
+  }
+  const double step = (this->TableRange[1] - this->TableRange[0]) / (TableSize - 1);
+  const double first = this->TableRange[0] + begin * step;
+  const double last = this->TableRange[0] + (end - 1) * step;
+  std::vector<double> colors(3 * count, 1.);
+  std::vector<double> opacities(count, 1.);
+  if (this->Color && this->Color->GetSize() > 0)
+  {
+    this->Color->GetTable(first, last, count, colors.data());
+  }
+  if (this->Opacity && this->Opacity->GetSize() > 0)
+  {
+    this->Opacity->GetTable(first, last, count, opacities.data());
+  }
+  unsigned char* texel = &this->Table[4 * begin];
+  for (int i = 0; i < count; ++i, texel += 4)
+  {
+    texel[0] = ToByte(colors[3 * i]);
+    texel[1] = ToByte(colors[3 * i + 1]);
+    texel[2] = ToByte(colors[3 * i + 2]);
+    texel[3] = ToByte(opacities[i]);
+  }
+  if (this->DirtyBegin < this->DirtyEnd)
+  {
+    begin = std::min(begin, this->DirtyBegin);
+    end = std::max(end, this->DirtyEnd);
+  }
+  this->DirtyBegin = begin;
+  this->DirtyEnd = end;
+}
+
+void vtkDearImGuiTransferFunctionEditor::StageEdit(int function, int node)
+{
+  if (this->EditedNode[function] == -1)
+  {
+    this->EditedNode[function] = node;
+  }
+  else if (this->EditedNode[function] != node)
+  {
+    this->EditedNode[function] = -2;
+  }
+}
+
+bool vtkDearImGuiTransferFunctionEditor::EditNodes(int function, const float rect[4])
+{
+  std::vector<Node>& nodes = this->Nodes[function];
+  if (!(function == OpacityFunction ? static_cast<bool>(this->Opacity)
+                                    : static_cast<bool>(this->Color)))
+  {
+    return false;
+  }
+  const double* range = this->Range;
+  const float width = rect[2] - rect[0];
+  const float height = rect[3] - rect[1];
+  const bool opacity = function == OpacityFunction;
+  auto toScreen = [&](const Node& node)
+  {
+    const float x =
+      rect[0] + static_cast<float>((node.Value[0] - range[0]) / (range[1] - range[0])) * width;
+    const float y = opacity ? rect[3] - static_cast<float>(node.Value[1]) * height
+                            : rect[1] + 0.5f * height;
+    return ImVec2(x, y);
+  };
+  const ImVec2 mouse = ImGui::GetIO().MousePos;
+  const double mouseX = range[0] + (mouse.x - rect[0]) / width * (range[1] - range[0]);
+  const double mouseY = std::min(std::max((rect[3] - mouse.y) / height, 0.f), 1.f);
+
+  // the nearest node within a few pixels
+  int hovered = -1;
+  if (ImGui::IsItemHovered())
+  {
+    float nearest = 36.f;
+    for (int i = 0; i < static_cast<int>(nodes.size()); ++i)
+    {
+      const ImVec2 p = toScreen(nodes[i]);
+      const float dx = p.x - mouse.x;
+      const float dy = opacity ? p.y - mouse.y : 0.f;
+      if (dx * dx + dy * dy < nearest)
+      {
+        nearest = dx * dx + dy * dy;
+        hovered = i;
+      }
+    }
+  }
+
+  bool staged = false;
+  int& active = this->ActiveNode[function];
+  if (ImGui::IsItemClicked(ImGuiMouseButton_Left))
+  {
+    active = hovered;
+    if (!opacity && hovered >= 0)
+    {
+      this->SelectedColorNode = hovered;
+    }
+  }
+  if (!ImGui::IsItemActive())
+  {
+    active = -1;
+  }
+  if (active >= 0 && ImGui::IsMouseDragging(ImGuiMouseButton_Left, 0.f))
+  {
+    // nodes keep their order, an edit only changes the table between the neighbors
+    const double epsilon = (range[1] - range[0]) * 1e-4;
+    const double lower = active > 0 ? nodes[active - 1].Value[0] + epsilon : range[0];
+    const double upper =
+      active + 1 < static_cast<int>(nodes.size()) ? nodes[active + 1].Value[0] - epsilon : range[1];
+    Node& node = nodes[active];
+    node.Value[0] = std::min(std::max(mouseX, lower), upper);
+    if (opacity)
+    {
+      node.Value[1] = mouseY;
+    }
+    this->StageEdit(function, active);
+    staged = true;
+  }
+  else if (hovered < 0 && ImGui::IsItemHovered() &&
+    ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
+  {
+    Node node = { { mouseX, mouseY, 0.5, 0., 0.5, 0. } };
+    if (!opacity)
+    {
+      // keep the color the table has there
+      const unsigned char* texel = &this->Table[4 * this->TableIndex(mouseX)];
+      for (int c = 0; c < 3; ++c)
+      {
+        node.Value[1 + c] = texel[c] / 255.;
+      }
+      node.Value[4] = 0.5;
+    }
+    auto it = std::upper_bound(nodes.begin(), nodes.end(), node,
+      [](const Node& a, const Node& b) { return a.Value[0] < b.Value[0]; });
+    const int index = static_cast<int>(it - nodes.begin());
+    nodes.insert(it, node);
+    if (!opacity)
+    {
+      this->SelectedColorNode = index;
+    }
+    this->EditedNode[function] = -2;
+    staged = true;
+  }
+  else if (hovered >= 0 && nodes.size() > 1 && ImGui::IsMouseClicked(ImGuiMouseButton_Right))
+  {
+    nodes.erase(nodes.begin() + hovered);
+    if (!opacity)
+    {
+      this->SelectedColorNode = -1;
+    }
+    this->EditedNode[function] = -2;
+    staged = true;
+  }
+
+  ImDrawList* drawList = ImGui::GetWindowDrawList();
+  const ImU32 outline = ImGui::GetColorU32(ImGuiCol_Text);
+  const ImU32 highlight = ImGui::GetColorU32(ImGuiCol_PlotLinesHovered);
+  if (opacity && !nodes.empty())
+  {
+    // the function is constant beyond its end nodes
+    ImVec2 previous(rect[0], toScreen(nodes.front()).y);
+    for (const Node& node : nodes)
+    {
+      const ImVec2 p = toScreen(node);
+      drawList->AddLine(previous, p, ImGui::GetColorU32(ImGuiCol_PlotLines), 1.5f);
+      previous = p;
+    }
+    drawList->AddLine(
+      previous, ImVec2(rect[2], previous.y), ImGui::GetColorU32(ImGuiCol_PlotLines), 1.5f);
+  }
+  for (int i = 0; i < static_cast<int>(nodes.size()); ++i)
+  {
+    const ImVec2 p = toScreen(nodes[i]);
+    const bool hot = i == active || i == hovered || (!opacity && i == this->SelectedColorNode);
+    if (opacity)
+    {
+      drawList->AddCircleFilled(p, 4.f, hot ? highlight : outline);
+    }
+    else
+    {
+      const double* rgb = nodes[i].Value + 1;
+      drawList->AddCircleFilled(p, 5.f,
+        IM_COL32(ToByte(rgb[0]), ToByte(rgb[1]), ToByte(rgb[2]), 255));
+      drawList->AddCircle(p, 5.f, hot ? highlight : outline, 0, hot ? 2.f : 1.f);
+    }
+  }
+  if (hovered >= 0 && !ImGui::IsItemActive())
+  {
+    const Node& node = nodes[hovered];
+    if (opacity)
+    {
+      ImGui::SetTooltip("%g: %.3f", node.Value[0], node.Value[1]);
+    }
+    else
+    {
+      ImGui::SetTooltip("%g: %.3f, %.3f, %.3f", node.Value[0], node.Value[1], node.Value[2],
+        node.Value[3]);
+    }
+  }
+  return staged;
+}
+
+bool vtkDearImGuiTransferFunctionEditor::Draw(const char* label, float width, float height)
+{
+  this->Synchronize();
+  this->UpdateHistogram();
+
+  ImGui::PushID(label);
+  const ImGuiStyle& style = ImGui::GetStyle();
+  if (width <= 0.f)
+  {
+    width = ImGui::GetContentRegionAvail().x;
+  }
+  const ImVec2 size(std::max(width, 16.f), std::max(height, 16.f));
+  ImDrawList* drawList = ImGui::GetWindowDrawList();
+  bool staged = false;
+
+  // opacity curve over the histogram
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  const ImVec2 corner(origin.x + size.x, origin.y + size.y);
+  ImGui::InvisibleButton("##opacity", size);
+  drawList->AddRectFilled(
+    origin, corner, ImGui::GetColorU32(ImGuiCol_FrameBg), style.FrameRounding);
+  if (!this->Histogram.empty())
+  {
+    const vtkIdType peak = *std::max_element(this->Histogram.begin(), this->Histogram.end());
+    // log scale, a background peak would flatten everything else
+    const float scale = peak > 0 ? 1.f / std::log1p(static_cast<float>(peak)) : 0.f;
+    const float binWidth = size.x / static_cast<float>(this->Histogram.size());
+    const ImU32 color = ImGui::GetColorU32(ImGuiCol_PlotHistogram, 0.35f);
+    for (std::size_t i = 0; i < this->Histogram.size(); ++i)
+    {
+      if (this->Histogram[i] == 0)
+      {
+        continue;
+      }
+      const float h = std::log1p(static_cast<float>(this->Histogram[i])) * scale * size.y;
+      drawList->AddRectFilled(ImVec2(origin.x + i * binWidth, corner.y - h),
+        ImVec2(origin.x + (i + 1) * binWidth, corner.y), color);
+    }
+  }
+  const float opacityRect[4] = { origin.x, origin.y, corner.x, corner.y };
+  staged |= this->EditNodes(OpacityFunction, opacityRect);
+
+  // color strip, opaque
+  const ImVec2 stripOrigin = ImGui::GetCursorScreenPos();
+  const ImVec2 stripSize(size.x, ImGui::GetFrameHeight());
+  const ImVec2 stripCorner(stripOrigin.x + stripSize.x, stripOrigin.y + stripSize.y);
+  ImGui::InvisibleButton("##colors", stripSize);
+  if (this->Texture)
+  {
+    // texel centers at both ends, Upload() runs before the overlay is rendered
+    const float half = 0.5f / TableSize;
+    drawList->AddCallback(DisableBlending, nullptr);
+    drawList->AddImage((ImTextureID)(intptr_t)this->Texture, stripOrigin, stripCorner,
+      ImVec2(half, 0.f), ImVec2(1.f - half, 1.f));
+    drawList->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+  }
+  else
+  {
+    // no texture until the first Upload()
+    const float step = stripSize.x / (TableSize - 1);
+    for (int i = 0; i + 1 < TableSize; ++i)
+    {
+      const unsigned char* a = &this->Table[4 * i];
+      const unsigned char* b = a + 4;
+      const ImU32 left = IM_COL32(a[0], a[1], a[2], 255);
+      const ImU32 right = IM_COL32(b[0], b[1], b[2], 255);
+      drawList->AddRectFilledMultiColor(ImVec2(stripOrigin.x + i * step, stripOrigin.y),
+        ImVec2(stripOrigin.x + (i + 1) * step, stripCorner.y), left, right, right, left);
+    }
+  }
+  const float colorRect[4] = { stripOrigin.x, stripOrigin.y, stripCorner.x, stripCorner.y };
+  staged |= this->EditNodes(ColorFunction, colorRect);
+
+  if (this->SelectedColorNode >= 0)
+  {
+    Node& node = this->Nodes[ColorFunction][this->SelectedColorNode];
+    float rgb[3] = { static_cast<float>(node.Value[1]), static_cast<float>(node.Value[2]),
+      static_cast<float>(node.Value[3]) };
+    ImGui::SetNextItemWidth(size.x);
+    if (ImGui::ColorEdit3("##node", rgb))
+    {
+      for (int c = 0; c < 3; ++c)
+      {
+        node.Value[1 + c] = rgb[c];
+      }
+      this->StageEdit(ColorFunction, this->SelectedColorNode);
+      staged = true;
+    }
+  }
+  ImGui::TextDisabled("%g", this->Range[0]);
+  char text[32];
+  std::snprintf(text, sizeof(text), "%g", this->Range[1]);
+  ImGui::SameLine(std::max(0.f, size.x - ImGui::CalcTextSize(text).x));
+  ImGui::TextDisabled("%s", text);
+  ImGui::PopID();
+  return staged;
+}
+
+int vtkDearImGuiTransferFunctionEditor::Commit()
+{
+  int modified = 0;
+  for (int f = 0; f < NumberOfFunctions; ++f)
+  {
+    const int edited = this->EditedNode[f];
+    this->EditedNode[f] = -1;
+    const std::vector<Node>& nodes = this->Nodes[f];
+    const int size = static_cast<int>(nodes.size());
+    vtkObject* function = nullptr;
+    double first = this->TableRange[0];
+    double last = this->TableRange[1];
+    if (edited == -1 || (f == OpacityFunction ? !this->Opacity : !this->Color))
+    {
+      continue;
+    }
+    if (f == OpacityFunction)
+    {
+      function = this->Opacity;
+      if (edited >= 0 && this->Opacity->GetSize() == size)
+      {
+        this->Opacity->SetNodeValue(edited, const_cast<double*>(nodes[edited].Value));
+      }
+      else
+      {
+        this->Opacity->RemoveAllPoints();
+        for (const Node& node : nodes)
+        {
+          this->Opacity->AddPoint(node.Value[0], node.Value[1], node.Value[2], node.Value[3]);
+        }
+      }
+    }
+    else
+    {
+      function = this->Color;
+      if (edited >= 0 && this->Color->GetSize() == size)
+      {
+        this->Color->SetNodeValue(edited, const_cast<double*>(nodes[edited].Value));
+      }
+      else
+      {
+        this->Color->RemoveAllPoints();
+        for (const Node& node : nodes)
+        {
+          this->Color->AddRGBPoint(node.Value[0], node.Value[1], node.Value[2], node.Value[3],
+            node.Value[4], node.Value[5]);
+        }
+      }
+    }
+    if (edited >= 0 && edited < size)
+    {
+      // beyond its neighbors the table does not depend on the node
+      first = edited > 0 ? nodes[edited - 1].Value[0] : first;
+      last = edited + 1 < size ? nodes[edited + 1].Value[0] : last;
+    }
+    this->SynchronizedTime[f] = function->GetMTime();
+    this->UpdateTable(this->TableIndex(first), this->TableIndex(last) + 2);
+    ++modified;
+  }
+  // follow changes made outside the editor, also when it is not drawn
+  this->Synchronize();
+  return modified;
+}
+
+void vtkDearImGuiTransferFunctionEditor::Upload()
+{
+  if (this->DirtyBegin >= this->DirtyEnd || this->Table.empty())
+  {
+    return;
+  }
+  GLint lastTexture, lastUnpackBuffer, lastAlignment, lastRowLength;
+  glGetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+  glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &lastUnpackBuffer);
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &lastAlignment);
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &lastRowLength);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  if (!this->Texture)
+  {
+    glGenTextures(1, &this->Texture);
+    glBindTexture(GL_TEXTURE_2D, this->Texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, TableSize, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+      this->Table.data());
+  }
+  else
+  {
+    // only the texels an edit changed
+    glBindTexture(GL_TEXTURE_2D, this->Texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, this->DirtyBegin, 0, this->DirtyEnd - this->DirtyBegin, 1,
+      GL_RGBA, GL_UNSIGNED_BYTE, &this->Table[4 * this->DirtyBegin]);
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, static_cast<GLuint>(lastUnpackBuffer));
+  glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(lastTexture));
+  glPixelStorei(GL_UNPACK_ALIGNMENT, lastAlignment);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, lastRowLength);
+  this->DirtyBegin = this->DirtyEnd = 0;
+}
+
+void vtkDearImGuiTransferFunctionEditor::ReleaseGraphicsResources()
+{
+  if (this->Texture)
+  {
+    glDeleteTextures(1, &this->Texture);
+    this->Texture = 0;
+  }
+  // the whole table goes into the next texture
+  this->DirtyBegin = 0;
+  this->DirtyEnd = this->Table.empty() ? 0 : TableSize;
+}